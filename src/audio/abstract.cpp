@@ -17,6 +17,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <chrono>
 #include "taAudio.h"
 #include "../ta-log.h"
 
@@ -62,11 +63,70 @@ bool TAMidiIn::gather() {
   return false;
 }
 
-bool TAMidiOut::send(const TAMidiMessage& what) {
-  logE("virtual method TAMidiOut::send() called! this is a bug!");
+bool TAMidiOut::sendNow(const TAMidiMessage& what) {
+  logE("virtual method TAMidiOut::sendNow() called! this is a bug!");
   return false;
 }
 
+bool TAMidiOut::send(const TAMidiMessage& what) {
+  if (!isDeviceOpen()) return false;
+  unsigned int tail=queueTail.load(std::memory_order_relaxed);
+  if (tail-queueHead.load(std::memory_order_acquire)>=TA_MIDI_OUT_QUEUE_SIZE) return false;
+  queue[tail&(TA_MIDI_OUT_QUEUE_SIZE-1)]=what;
+  queueTail.store(tail+1,std::memory_order_release);
+  // no lock here. the thread never sleeps for long when idle, so a missed notify is harmless.
+  outCond.notify_one();
+  return true;
+}
+
+static void _taMidiOutThread(void* inst) {
+  ((TAMidiOut*)inst)->runThread();
+}
+
+void TAMidiOut::runThread() {
+  std::unique_lock<std::mutex> unique(outLock);
+  logD("starting MIDI out thread");
+  while (true) {
+    unsigned int head=queueHead.load(std::memory_order_relaxed);
+    if (head==queueTail.load(std::memory_order_acquire)) {
+      if (outQuit) break;
+      outCond.wait_for(unique,std::chrono::milliseconds(10));
+      continue;
+    }
+    TAMidiMessage& msg=queue[head&(TA_MIDI_OUT_QUEUE_SIZE-1)];
+    // wait until it's time. when quitting, send everything right away.
+    if (!outQuit && msg.time>0.0) {
+      double now=std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      double delay=msg.time-now;
+      if (delay>0.0) {
+        if (delay>0.1) delay=0.1;
+        outCond.wait_for(unique,std::chrono::duration<double>(delay));
+        continue;
+      }
+    }
+    sendNow(msg);
+    msg.sysExData.reset();
+    queueHead.store(head+1,std::memory_order_release);
+  }
+  logD("stopping MIDI out thread");
+}
+
+void TAMidiOut::startThread() {
+  if (outThread!=NULL) return;
+  queueHead=queueTail.load();
+  outQuit=false;
+  outThread=new std::thread(_taMidiOutThread,this);
+}
+
+void TAMidiOut::stopThread() {
+  if (outThread==NULL) return;
+  outQuit=true;
+  outCond.notify_one();
+  outThread->join();
+  delete outThread;
+  outThread=NULL;
+}
+
 bool TAMidiIn::isDeviceOpen() {
   return false;
 }
@@ -20,6 +20,7 @@
 #include "rtmidi.h"
 #include "../ta-log.h"
 #include "taAudio.h"
+#include <chrono>
 
 String sanitizePortName(const String& name) {
 #if defined(_WIN32)
@@ -46,6 +47,11 @@ String sanitizePortName(const String& name) {
 bool TAMidiInRtMidi::gather() {
   std::vector<unsigned char> msg;
   if (port==NULL) return false;
+  // RtMidi only tells us the time since the previous message.
+  // to place messages on the steady clock, we keep track of the smallest
+  // difference between the time of a message and the moment we got it.
+  double now=std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  size_t firstNew=queue.size();
   try {
     while (true) {
       TAMidiMessage m;
@@ -53,7 +59,8 @@ bool TAMidiInRtMidi::gather() {
       if (msg.empty()) break;
 
       // parse message
-      m.time=t;
+      portTime+=t;
+      m.time=portTime;
       m.type=msg[0];
       if (m.type!=TA_MIDI_SYSEX && msg.size()>1) {
         memcpy(m.data,msg.data()+1,MIN(msg.size()-1,7));
@@ -70,6 +77,15 @@ bool TAMidiInRtMidi::gather() {
     closeDevice();
     return false;
   }
+  if (queue.size()>firstNew) {
+    if (!portTimeKnown || now-portTime<portTimeOffset) {
+      portTimeOffset=now-portTime;
+      portTimeKnown=true;
+    }
+    for (size_t i=firstNew; i<queue.size(); i++) {
+      queue[i].time+=portTimeOffset;
+    }
+  }
   return true;
 }
 
@@ -113,6 +129,8 @@ bool TAMidiInRtMidi::openDevice(String name) {
       }
     }
     isOpen=portOpen;
+    portTime=0.0;
+    portTimeKnown=false;
     if (!portOpen) logW("could not find MIDI in device...");
     return portOpen;
   } catch (RtMidiError& e) {
@@ -158,7 +176,7 @@ bool TAMidiInRtMidi::quit() {
 
 // --- OUT ---
 
-bool TAMidiOutRtMidi::send(const TAMidiMessage& what) {
+bool TAMidiOutRtMidi::sendNow(const TAMidiMessage& what) {
   if (!isOpen) return false;
   if (!isWorking) return false;
   if (what.type<0x80) return false;
@@ -241,6 +259,7 @@ bool TAMidiOutRtMidi::openDevice(String name) {
     isOpen=portOpen;
     if (!portOpen) logW("could not find MIDI out device...");
     isWorking=true;
+    if (portOpen) startThread();
     return portOpen;
   } catch (RtMidiError& e) {
     logW("could not open MIDI out device! %s",e.what());
@@ -253,6 +272,7 @@ bool TAMidiOutRtMidi::openDevice(String name) {
 bool TAMidiOutRtMidi::closeDevice() {
   if (port==NULL) return false;
   if (!isOpen) return false;
+  stopThread();
   isWorking=false;
   try {
     port->closePort();
@@ -293,6 +313,7 @@ bool TAMidiOutRtMidi::init() {
 }
 
 bool TAMidiOutRtMidi::quit() {
+  stopThread();
   if (port!=NULL) {
     delete port;
     port=NULL;
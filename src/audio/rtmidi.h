@@ -23,6 +23,9 @@
 class TAMidiInRtMidi: public TAMidiIn {
   RtMidiIn* port;
   bool isOpen;
+  // RtMidi time (sum of deltas) and its offset to the steady clock
+  double portTime, portTimeOffset;
+  bool portTimeKnown;
   public:
     bool gather();
     bool isDeviceOpen();
@@ -33,14 +36,17 @@ class TAMidiInRtMidi: public TAMidiIn {
     bool init();
     TAMidiInRtMidi():
       port(NULL),
-      isOpen(false) {}
+      isOpen(false),
+      portTime(0.0),
+      portTimeOffset(0.0),
+      portTimeKnown(false) {}
 };
 
 class TAMidiOutRtMidi: public TAMidiOut {
   RtMidiOut* port;
   bool isOpen, isWorking;
   public:
-    bool send(const TAMidiMessage& what);
+    bool sendNow(const TAMidiMessage& what);
     bool isDeviceOpen();
     bool openDevice(String name);
     bool closeDevice();
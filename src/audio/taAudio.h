@@ -21,6 +21,9 @@
 #define _TAAUDIO_H
 #include "../ta-utils.h"
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
 #include "../fixedQueue.h"
 #include "../pch.h"
 
@@ -94,6 +97,9 @@ enum TAMidiMessageTypes {
 };
 
 struct TAMidiMessage {
+  // time in seconds (steady clock).
+  // input: time of arrival. 0 if unknown.
+  // output: time at which the message shall be sent. 0 means now.
   double time;
   unsigned char type;
   unsigned char data[7];
@@ -138,17 +144,40 @@ class TAMidiIn {
     virtual ~TAMidiIn();
 };
 
+// must be a power of 2
+#define TA_MIDI_OUT_QUEUE_SIZE 4096
+
 class TAMidiOut {
-  FixedQueue<TAMidiMessage,8192> queue;
+  // single-producer single-consumer ring between the engine and the output thread
+  TAMidiMessage queue[TA_MIDI_OUT_QUEUE_SIZE];
+  std::atomic<unsigned int> queueHead, queueTail;
+  std::thread* outThread;
+  std::mutex outLock;
+  std::condition_variable outCond;
+  std::atomic<bool> outQuit;
+  protected:
+    // the output thread must be running while the device is open.
+    // stopThread() sends whatever is left in the queue before returning.
+    void startThread();
+    void stopThread();
   public:
-    virtual bool send(const TAMidiMessage& what);
+    void runThread();
+    // queues a message for the output thread. does not block.
+    // this shall only be called from one thread at a time.
+    bool send(const TAMidiMessage& what);
+    // sends a message immediately. only called by the output thread.
+    virtual bool sendNow(const TAMidiMessage& what);
     virtual bool isDeviceOpen();
     virtual bool openDevice(String name);
     virtual bool closeDevice();
     virtual std::vector<String> listDevices();
     virtual bool init();
     virtual bool quit();
-    TAMidiOut() {
+    TAMidiOut():
+      queueHead(0),
+      queueTail(0),
+      outThread(NULL),
+      outQuit(false) {
     }
     virtual ~TAMidiOut();
 };
@@ -0,0 +1,235 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "batch.h"
+#include "../ta-log.h"
+#include "../fileutils.h"
+#include <chrono>
+#include <thread>
+
+static String jsonString(const String& s) {
+  String ret="\"";
+  for (char i: s) {
+    switch (i) {
+      case '"':
+        ret+="\\\"";
+        break;
+      case '\\':
+        ret+="\\\\";
+        break;
+      case '\n':
+        ret+="\\n";
+        break;
+      case '\r':
+        ret+="\\r";
+        break;
+      case '\t':
+        ret+="\\t";
+        break;
+      default:
+        if ((unsigned char)i<0x20) {
+          ret+=fmt::sprintf("\\u%.4x",(int)i);
+        } else {
+          ret+=i;
+        }
+        break;
+    }
+  }
+  ret+="\"";
+  return ret;
+}
+
+static void _runBatchWorker(FurnaceBatch* batch) {
+  batch->runWorker();
+}
+
+void FurnaceBatch::bindEngine(DivEngine* eng) {
+  e=eng;
+}
+
+bool FurnaceBatch::loadManifest(const char* path) {
+  FILE* f=ps_fopen(path,"rb");
+  if (f==NULL) {
+    logE("could not open manifest! (%s)",strerror(errno));
+    return false;
+  }
+
+  char line[4096];
+  while (fgets(line,4096,f)!=NULL) {
+    String l=line;
+    while (!l.empty() && (l.back()=='\n' || l.back()=='\r')) l.pop_back();
+    if (l.empty()) continue;
+    if (l[0]=='#') continue;
+
+    String input, output;
+    size_t tabPos=l.find('\t');
+    if (tabPos==String::npos) {
+      input=l;
+      size_t extPos=input.rfind('.');
+      size_t sepPos=input.find_last_of("/\\");
+      if (extPos!=String::npos && (sepPos==String::npos || extPos>sepPos)) {
+        output=input.substr(0,extPos)+".wav";
+      } else {
+        output=input+".wav";
+      }
+    } else {
+      input=l.substr(0,tabPos);
+      output=l.substr(tabPos+1);
+    }
+    jobs.push_back(FurnaceBatchJob(input,output));
+  }
+  fclose(f);
+
+  logI("%d files in manifest.",(int)jobs.size());
+  return true;
+}
+
+void FurnaceBatch::report(FurnaceBatchJob& job, bool success, const String& error, double renderTime, double duration) {
+  String result=fmt::sprintf("{\"input\":%s,\"output\":%s,\"success\":%s",jsonString(job.input),jsonString(job.output),success?"true":"false");
+  if (success) {
+    result+=fmt::sprintf(",\"renderTime\":%.6f,\"duration\":%.6f,\"realtime\":%.3f",renderTime,duration,(renderTime>0)?(duration/renderTime):0.0);
+  } else {
+    result+=fmt::sprintf(",\"error\":%s",jsonString(error));
+  }
+  result+="}\n";
+
+  reportLock.lock();
+  fputs(result.c_str(),stdout);
+  fflush(stdout);
+  reportLock.unlock();
+}
+
+bool FurnaceBatch::renderJob(DivEngine* worker, bool workerOK, FurnaceBatchJob& job, String& error) {
+  if (!workerOK) {
+    error="could not initialize engine";
+    return false;
+  }
+
+  FILE* f=ps_fopen(job.input.c_str(),"rb");
+  if (f==NULL) {
+    error=fmt::sprintf("could not open file (%s)",strerror(errno));
+    return false;
+  }
+  if (fseek(f,0,SEEK_END)<0) {
+    error=fmt::sprintf("could not get file size (%s)",strerror(errno));
+    fclose(f);
+    return false;
+  }
+  ssize_t len=ftell(f);
+  if (len<1 || fseek(f,0,SEEK_SET)<0) {
+    error="could not get file size";
+    fclose(f);
+    return false;
+  }
+  unsigned char* file=new unsigned char[len];
+  if (fread(file,1,(size_t)len,f)!=(size_t)len) {
+    error=fmt::sprintf("could not read file (%s)",strerror(errno));
+    fclose(f);
+    delete[] file;
+    return false;
+  }
+  fclose(f);
+
+  bool started=false;
+  initLock.lock();
+  // load() takes ownership of the buffer
+  if (!worker->load(file,(size_t)len,job.input.c_str())) {
+    error=fmt::sprintf("could not load song (%s)",worker->getLastError());
+  } else {
+    if (subSong!=-1) {
+      worker->changeSongP(subSong);
+    }
+    started=worker->saveAudio(job.output.c_str(),exportOptions);
+    if (!started) error="could not start export";
+  }
+  initLock.unlock();
+  if (!started) return false;
+
+  worker->waitAudioFile();
+  return true;
+}
+
+void FurnaceBatch::runWorker() {
+  DivEngine* worker=new DivEngine;
+  initLock.lock();
+  worker->preInitWorker(e);
+  bool workerOK=worker->init();
+  initLock.unlock();
+
+  while (true) {
+    size_t index=nextJob++;
+    if (index>=jobs.size()) break;
+
+    String error;
+    std::chrono::steady_clock::time_point startTime=std::chrono::steady_clock::now();
+    bool success=renderJob(worker,workerOK,jobs[index],error);
+    std::chrono::steady_clock::time_point endTime=std::chrono::steady_clock::now();
+    double renderTime=std::chrono::duration<double>(endTime-startTime).count();
+    double duration=0;
+
+    if (success) {
+      duration=(double)worker->getExportedFrames()/(double)exportOptions.sampleRate;
+    } else {
+      failed++;
+    }
+    report(jobs[index],success,error,renderTime,duration);
+  }
+
+  initLock.lock();
+  worker->quit(false);
+  initLock.unlock();
+  delete worker;
+}
+
+bool FurnaceBatch::run(int threads, DivAudioExportOptions options, int sub) {
+  exportOptions=options;
+  subSong=sub;
+  nextJob=0;
+  failed=0;
+
+  if (threads<1) threads=std::thread::hardware_concurrency();
+  if (threads<1) threads=1;
+  if (threads>(int)jobs.size()) threads=jobs.size();
+
+  logI("rendering %d files using %d threads...",(int)jobs.size(),threads);
+
+  std::thread** workers=new std::thread*[threads];
+  for (int i=0; i<threads; i++) {
+    workers[i]=new std::thread(_runBatchWorker,this);
+  }
+  for (int i=0; i<threads; i++) {
+    workers[i]->join();
+    delete workers[i];
+  }
+  delete[] workers;
+
+  if (failed>0) {
+    logE("%d of %d files failed.",(int)failed,(int)jobs.size());
+    return false;
+  }
+  logI("done!");
+  return true;
+}
+
+FurnaceBatch::FurnaceBatch():
+  e(NULL),
+  subSong(-1) {
+  nextJob=0;
+  failed=0;
+}
@@ -0,0 +1,64 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _FUR_BATCH_H
+#define _FUR_BATCH_H
+
+#include "../engine/engine.h"
+#include <atomic>
+#include <mutex>
+
+struct FurnaceBatchJob {
+  String input, output;
+  FurnaceBatchJob(const String& i, const String& o):
+    input(i),
+    output(o) {}
+};
+
+// renders a list of songs to audio files using a pool of engines.
+// one line of JSON is written to stdout for every file.
+class FurnaceBatch {
+  DivEngine* e;
+  std::vector<FurnaceBatchJob> jobs;
+  std::atomic<size_t> nextJob;
+  std::atomic<size_t> failed;
+  // engine setup (song loading, core init) is serialized
+  std::mutex initLock;
+  std::mutex reportLock;
+  DivAudioExportOptions exportOptions;
+  int subSong;
+
+  bool renderJob(DivEngine* worker, bool workerOK, FurnaceBatchJob& job, String& error);
+  void report(FurnaceBatchJob& job, bool success, const String& error, double renderTime, double duration);
+
+  public:
+    void bindEngine(DivEngine* eng);
+    // read a manifest.
+    // each line is an input file, optionally followed by a tab and the output file.
+    // if no output is given, it is the input with the extension replaced by .wav.
+    // empty lines and lines starting with # are ignored.
+    bool loadManifest(const char* path);
+    // render all songs. returns false if any of them failed.
+    // set threads to 0 for one per CPU core.
+    bool run(int threads, DivAudioExportOptions options, int sub);
+    void runWorker();
+    FurnaceBatch();
+};
+
+#endif
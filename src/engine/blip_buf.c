@@ -22,6 +22,25 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 	#include "blargg_test.h"
 #endif
 
+/* SIMD path for blip_add_samples(), selected at compile time.
+define BLIP_NO_SIMD to use the scalar path only. */
+#if defined(BLIP_NO_SIMD)
+	/* scalar */
+#elif defined(__AVX2__)
+	#include <immintrin.h>
+	#define BLIP_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define BLIP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define BLIP_NEON 1
+#endif
+
+#if defined(_MSC_VER) && (defined(BLIP_AVX2) || defined(BLIP_SSE2))
+	#include <intrin.h>
+#endif
+
 /* Equivalent to ULONG_MAX >= 0xFFFFFFFF00000000.
 Avoids constants that don't fit in 32 bits. */
 #if ULONG_MAX/0xFFFFFFFF > 0xFFFFFFFF
@@ -294,6 +313,45 @@ static short const bl_step [phase_count + 1] [half_width] =
 {    0,   43, -115,  350, -488, 1136, -914, 5861}
 };
 
+/* bl_step with every row reversed, so that the second half of the kernel can
+be loaded in order */
+static short const bl_step_rev [phase_count + 1] [half_width] =
+{
+{21022, 5861, -914, 1136, -488,  350, -115,   43},
+{21001, 5274, -799, 1076, -473,  348, -118,   44},
+{20936, 4706, -677, 1011, -454,  344, -121,   45},
+{20829, 4156, -549,  942, -431,  336, -122,   46},
+{20679, 3629, -418,  868, -404,  327, -123,   47},
+{20488, 3124, -285,  792, -375,  316, -122,   47},
+{20256, 2644, -151,  714, -344,  303, -120,   47},
+{19985, 2188,  -17,  634, -310,  289, -117,   46},
+{19675, 1758,  117,  553, -275,  273, -114,   46},
+{19327, 1356,  247,  471, -237,  255, -108,   44},
+{18944,  981,  373,  390, -199,  237, -103,   43},
+{18527,  633,  495,  310, -160,  218,  -98,   42},
+{18078,  314,  611,  231, -121,  198,  -91,   40},
+{17599,   22,  722,  153,  -81,  178,  -84,   38},
+{17092, -241,  824,   80,  -43,  157,  -76,   36},
+{16558, -476,  919,    8,   -3,  135,  -68,   34},
+{16001, -683, 1006,  -60,   34,  115,  -61,   32},
+{15422, -862, 1083, -123,   70,   94,  -52,   29},
+{14824,-1015, 1152, -184,  106,   73,  -44,   27},
+{14210,-1142, 1211, -239,  139,   53,  -36,   25},
+{13582,-1244, 1261, -290,  170,   34,  -27,   22},
+{12942,-1322, 1301, -335,  199,   16,  -20,   20},
+{12293,-1376, 1331, -375,  226,   -3,  -12,   18},
+{11638,-1408, 1351, -410,  250,  -19,   -4,   15},
+{10979,-1419, 1361, -439,  272,  -35,    3,   13},
+{10319,-1410, 1362, -464,  292,  -49,    9,   11},
+{ 9660,-1383, 1354, -483,  309,  -63,   16,    9},
+{ 9005,-1339, 1337, -496,  322,  -75,   22,    7},
+{ 8355,-1280, 1312, -504,  333,  -85,   26,    6},
+{ 7713,-1205, 1278, -507,  341,  -94,   31,    4},
+{ 7082,-1119, 1238, -506,  347, -102,   35,    3},
+{ 6464,-1021, 1190, -499,  350, -110,   40,    1},
+{ 5861, -914, 1136, -488,  350, -115,   43,    0}
+};
+
 /* Shifting by pre_shift allows calculation using unsigned int rather than
 possibly-wider fixed_t. On 32-bit platforms, this is likely more efficient.
 And by having pre_shift 32, a 32-bit platform can easily do the shift by
@@ -350,3 +408,230 @@ void blip_add_delta_fast( blip_t* m, unsigned time, int delta )
 	out [7] += delta * delta_unit - delta2;
 	out [8] += delta2;
 }
+
+/* vectorized version of blip_add_delta(). results are identical. */
+
+#if defined(BLIP_AVX2)
+/* 8 pairs of a [k], b [k] */
+static __m256i interleave( short const* a, short const* b )
+{
+	__m128i va = _mm_loadu_si128( (__m128i const*) a );
+	__m128i vb = _mm_loadu_si128( (__m128i const*) b );
+	return _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_unpacklo_epi16( va, vb ) ),
+			_mm_unpackhi_epi16( va, vb ), 1 );
+}
+#endif
+
+#if defined(BLIP_SSE2)
+/* SSE2 has no 32-bit multiply returning the low half */
+static __m128i mullo_epi32( __m128i a, __m128i b )
+{
+	__m128i even = _mm_mul_epu32( a, b );
+	__m128i odd  = _mm_mul_epu32( _mm_srli_si128( a, 4 ), _mm_srli_si128( b, 4 ) );
+	return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ),
+			_mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+}
+
+/* sign-extend 4 shorts to ints */
+#define WIDEN_LO( v ) _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 )
+#define WIDEN_HI( v ) _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 )
+
+static void add_kernel_half( buf_t* out, short const* a, short const* b, int delta, int delta2 )
+{
+	__m128i va = _mm_loadu_si128( (__m128i const*) a );
+	__m128i vb = _mm_loadu_si128( (__m128i const*) b );
+	__m128i o0 = _mm_loadu_si128( (__m128i const*) out );
+	__m128i o1 = _mm_loadu_si128( (__m128i const*) (out + 4) );
+	if ( (short) delta == delta && (short) delta2 == delta2 )
+	{
+		/* both deltas fit in 16 bits: a*delta + b*delta2 in one madd */
+		__m128i d = _mm_set1_epi32( (delta2 << 16) | (delta & 0xFFFF) );
+		o0 = _mm_add_epi32( o0, _mm_madd_epi16( _mm_unpacklo_epi16( va, vb ), d ) );
+		o1 = _mm_add_epi32( o1, _mm_madd_epi16( _mm_unpackhi_epi16( va, vb ), d ) );
+	}
+	else
+	{
+		__m128i d1 = _mm_set1_epi32( delta );
+		__m128i d2 = _mm_set1_epi32( delta2 );
+		o0 = _mm_add_epi32( o0, mullo_epi32( WIDEN_LO( va ), d1 ) );
+		o0 = _mm_add_epi32( o0, mullo_epi32( WIDEN_LO( vb ), d2 ) );
+		o1 = _mm_add_epi32( o1, mullo_epi32( WIDEN_HI( va ), d1 ) );
+		o1 = _mm_add_epi32( o1, mullo_epi32( WIDEN_HI( vb ), d2 ) );
+	}
+	_mm_storeu_si128( (__m128i*) out, o0 );
+	_mm_storeu_si128( (__m128i*) (out + 4), o1 );
+}
+#endif
+
+static void add_delta_vec( blip_t* m, unsigned time, int delta )
+{
+	unsigned fixed = (unsigned) ((time * m->factor + m->offset) >> pre_shift);
+	buf_t* out = SAMPLES( m ) + m->avail + (fixed >> frac_bits);
+	
+	int const phase_shift = frac_bits - phase_bits;
+	int phase = fixed >> phase_shift & (phase_count - 1);
+	
+	/* first half: bl_step [phase] and the row after it.
+	second half: the same rows as blip_add_delta(), reversed */
+	short const* a_lo = bl_step [phase];
+	short const* b_lo = bl_step [phase + 1];
+	short const* a_hi = bl_step_rev [phase_count - phase];
+	short const* b_hi = bl_step_rev [phase_count - phase - 1];
+	
+	int interp = fixed >> (phase_shift - delta_bits) & (delta_unit - 1);
+	int delta2 = (delta * interp) >> delta_bits;
+	delta -= delta2;
+	
+	/* Fails if buffer size was exceeded */
+	assert( out <= &SAMPLES( m ) [m->size + end_frame_extra] );
+	
+#if defined(BLIP_AVX2)
+	{
+		__m256i lo = _mm256_loadu_si256( (__m256i const*) out );
+		__m256i hi = _mm256_loadu_si256( (__m256i const*) (out + half_width) );
+		if ( (short) delta == delta && (short) delta2 == delta2 )
+		{
+			/* both deltas fit in 16 bits: a*delta + b*delta2 in one madd */
+			__m256i d = _mm256_set1_epi32( (delta2 << 16) | (delta & 0xFFFF) );
+			lo = _mm256_add_epi32( lo, _mm256_madd_epi16( interleave( a_lo, b_lo ), d ) );
+			hi = _mm256_add_epi32( hi, _mm256_madd_epi16( interleave( a_hi, b_hi ), d ) );
+		}
+		else
+		{
+			__m256i d1 = _mm256_set1_epi32( delta );
+			__m256i d2 = _mm256_set1_epi32( delta2 );
+			lo = _mm256_add_epi32( lo, _mm256_mullo_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (__m128i const*) a_lo ) ), d1 ) );
+			lo = _mm256_add_epi32( lo, _mm256_mullo_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (__m128i const*) b_lo ) ), d2 ) );
+			hi = _mm256_add_epi32( hi, _mm256_mullo_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (__m128i const*) a_hi ) ), d1 ) );
+			hi = _mm256_add_epi32( hi, _mm256_mullo_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (__m128i const*) b_hi ) ), d2 ) );
+		}
+		_mm256_storeu_si256( (__m256i*) out, lo );
+		_mm256_storeu_si256( (__m256i*) (out + half_width), hi );
+	}
+#elif defined(BLIP_SSE2)
+	{
+		add_kernel_half( out, a_lo, b_lo, delta, delta2 );
+		add_kernel_half( out + half_width, a_hi, b_hi, delta, delta2 );
+	}
+#elif defined(BLIP_NEON)
+	{
+		int k;
+		for ( k = 0; k < half_width; k += 4 )
+		{
+			int32x4_t lo = vld1q_s32( out + k );
+			int32x4_t hi = vld1q_s32( out + half_width + k );
+			lo = vmlaq_n_s32( lo, vmovl_s16( vld1_s16( a_lo + k ) ), delta );
+			lo = vmlaq_n_s32( lo, vmovl_s16( vld1_s16( b_lo + k ) ), delta2 );
+			hi = vmlaq_n_s32( hi, vmovl_s16( vld1_s16( a_hi + k ) ), delta );
+			hi = vmlaq_n_s32( hi, vmovl_s16( vld1_s16( b_hi + k ) ), delta2 );
+			vst1q_s32( out + k, lo );
+			vst1q_s32( out + half_width + k, hi );
+		}
+	}
+#else
+	{
+		int k;
+		for ( k = 0; k < half_width; k++ )
+		{
+			out [k]              += a_lo [k]*delta + b_lo [k]*delta2;
+			out [half_width + k] += a_hi [k]*delta + b_hi [k]*delta2;
+		}
+	}
+#endif
+}
+
+#if defined(BLIP_AVX2) || defined(BLIP_SSE2)
+/* index of lowest set bit */
+static int lowest_bit( unsigned n )
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward( &index, n );
+	return (int) index;
+#else
+	return __builtin_ctz( n );
+#endif
+}
+#endif
+
+void blip_add_samples( blip_t* m, short const in [], int count, int* last, int* prev )
+{
+	int i = 0;
+	
+	/* the first change is detected against *last, but its delta is relative
+	to *prev (these differ after DC offset compensation) */
+	while ( i < count && in [i] == *last )
+		i++;
+	if ( i >= count )
+		return;
+	add_delta_vec( m, i, in [i] - *prev );
+	i++;
+	
+	/* from here on, every change is relative to the previous input sample.
+	find change points in bulk */
+#if defined(BLIP_AVX2)
+	for ( ; i + 16 <= count; i += 16 )
+	{
+		__m256i cur = _mm256_loadu_si256( (__m256i const*) (in + i) );
+		__m256i before = _mm256_loadu_si256( (__m256i const*) (in + i - 1) );
+		unsigned changed = ~(unsigned) _mm256_movemask_epi8( _mm256_cmpeq_epi16( cur, before ) );
+		while ( changed )
+		{
+			int bit = lowest_bit( changed );
+			int n = i + (bit >> 1);
+			add_delta_vec( m, n, in [n] - in [n - 1] );
+			changed &= ~(3u << bit);
+		}
+	}
+#elif defined(BLIP_SSE2)
+	for ( ; i + 8 <= count; i += 8 )
+	{
+		__m128i cur = _mm_loadu_si128( (__m128i const*) (in + i) );
+		__m128i before = _mm_loadu_si128( (__m128i const*) (in + i - 1) );
+		unsigned changed = (unsigned) _mm_movemask_epi8( _mm_cmpeq_epi16( cur, before ) ) ^ 0xFFFF;
+		while ( changed )
+		{
+			int bit = lowest_bit( changed );
+			int n = i + (bit >> 1);
+			add_delta_vec( m, n, in [n] - in [n - 1] );
+			changed &= ~(3u << bit);
+		}
+	}
+#elif defined(BLIP_NEON)
+	for ( ; i + 8 <= count; i += 8 )
+	{
+		int16x8_t cur = vld1q_s16( in + i );
+		int16x8_t before = vld1q_s16( in + i - 1 );
+		uint64x2_t same = vreinterpretq_u64_u16( vceqq_s16( cur, before ) );
+		int n;
+		if ( (vgetq_lane_u64( same, 0 ) & vgetq_lane_u64( same, 1 )) == ~(uint64_t) 0 )
+			continue;
+		for ( n = i; n < i + 8; n++ )
+		{
+			if ( in [n] != in [n - 1] )
+				add_delta_vec( m, n, in [n] - in [n - 1] );
+		}
+	}
+#endif
+	for ( ; i < count; i++ )
+	{
+		if ( in [i] != in [i - 1] )
+			add_delta_vec( m, i, in [i] - in [i - 1] );
+	}
+	
+	*last = in [count - 1];
+	*prev = in [count - 1];
+}
+
+char const* blip_simd_name( void )
+{
+#if defined(BLIP_AVX2)
+	return "AVX2";
+#elif defined(BLIP_SSE2)
+	return "SSE2";
+#elif defined(BLIP_NEON)
+	return "NEON";
+#else
+	return "none";
+#endif
+}
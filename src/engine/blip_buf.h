@@ -7,6 +7,7 @@ Sample buffer that resamples from input clock rate to output sample rate */
 
 // MODIFIED by tildearrow:
 // - add option to disable high-pass filter
+// - add vectorized blip_add_samples()
 
 #ifdef __cplusplus
 	extern "C" {
@@ -41,6 +42,17 @@ void blip_add_delta( blip_t*, unsigned int clock_time, int delta );
 /** Same as blip_add_delta(), but uses faster, lower-quality synthesis. */
 void blip_add_delta_fast( blip_t*, unsigned int clock_time, int delta );
 
+/** Adds a delta for every sample of 'in' that differs from the
+previous one, at clock time equal to its index. The first sample is compared
+against '*last', and its delta is relative to '*prev'. Both are set to the last
+sample afterwards. Produces the same result as calling blip_add_delta() for
+every change, but uses SIMD instructions where available. */
+void blip_add_samples( blip_t*, short const in [], int count, int* last, int* prev );
+
+/** Returns the name of the instruction set used by
+blip_add_samples(), or "none". */
+char const* blip_simd_name( void );
+
 /** Length of time frame, in clocks, needed to make sample_count additional
 samples available. */
 int blip_clocks_needed( const blip_t*, int sample_count );
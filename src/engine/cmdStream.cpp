@@ -24,7 +24,7 @@
 #include "../ta-log.h"
 
 bool DivCSChannelState::doCall(unsigned int addr) {
-  if (callStackPos>=8) {
+  if (callStackPos>=DIV_MAX_CSSTACK) {
     readPos=0;
     return false;
   }
@@ -120,23 +120,32 @@ bool DivCSPlayer::tick() {
           break;
         case 0xf8: {
           unsigned int callAddr=chan[i].readPos+2+stream.readS();
+          // return to the next command
+          chan[i].readPos=stream.tell();
           if (!chan[i].doCall(callAddr)) {
             logE("%d: (callb16) stack error!",i);
           }
+          mustTell=false;
           break;
         }
         case 0xf6: {
           unsigned int callAddr=chan[i].readPos+4+stream.readI();
+          // return to the next command
+          chan[i].readPos=stream.tell();
           if (!chan[i].doCall(callAddr)) {
             logE("%d: (callb32) stack error!",i);
           }
+          mustTell=false;
           break;
         }
         case 0xf5: {
           unsigned int callAddr=stream.readI();
+          // return to the next command
+          chan[i].readPos=stream.tell();
           if (!chan[i].doCall(callAddr)) {
             logE("%d: (call) stack error!",i);
           }
+          mustTell=false;
           break;
         }
         case 0xf4: {
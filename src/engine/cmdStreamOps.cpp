@@ -19,6 +19,8 @@
 
 #include "engine.h"
 #include "../ta-log.h"
+#include <algorithm>
+#include <unordered_map>
 
 #define WRITE_TICK(x) \
   if (!wroteTick[x]) { \
@@ -198,6 +200,193 @@ void writePackedCommandValues(SafeWriter* w, const DivCommand& c) {
   }
 }
 
+// length of a call (0xf5 and 32-bit address)
+#define CS_CALL_LEN 5
+
+struct CSToken {
+  // command bytes, or empty if this is a call
+  String data;
+  // subroutine called by this token, or -1
+  int sub;
+  int len;
+  CSToken(const String& d):
+    data(d),
+    sub(-1),
+    len(d.size()) {}
+  CSToken(int s):
+    sub(s),
+    len(CS_CALL_LEN) {}
+};
+
+struct CSSubroutine {
+  std::vector<int> body;
+  // number of call stack entries needed to run it
+  int depth;
+  unsigned int addr;
+};
+
+static void buildSuffixArray(const std::vector<int>& seq, std::vector<int>& sa, std::vector<int>& lcp) {
+  int n=seq.size();
+  std::vector<int> rank(n), tmp(n);
+  sa.resize(n);
+  lcp.assign(n,0);
+  for (int i=0; i<n; i++) sa[i]=i;
+  std::sort(sa.begin(),sa.end(),[&seq](int a, int b) {
+    return seq[a]<seq[b];
+  });
+  for (int i=0; i<n; i++) {
+    rank[sa[i]]=(i>0 && seq[sa[i]]==seq[sa[i-1]])?rank[sa[i-1]]:i;
+  }
+  for (int k=1; k<n; k<<=1) {
+    auto cmp=[&rank,n,k](int a, int b) {
+      if (rank[a]!=rank[b]) return rank[a]<rank[b];
+      int ra=(a+k<n)?rank[a+k]:-1;
+      int rb=(b+k<n)?rank[b+k]:-1;
+      return ra<rb;
+    };
+    std::sort(sa.begin(),sa.end(),cmp);
+    tmp[sa[0]]=0;
+    for (int i=1; i<n; i++) {
+      tmp[sa[i]]=tmp[sa[i-1]]+(cmp(sa[i-1],sa[i])?1:0);
+    }
+    rank.swap(tmp);
+    if (rank[sa[n-1]]==n-1) break;
+  }
+  // Kasai
+  for (int i=0; i<n; i++) tmp[sa[i]]=i;
+  int h=0;
+  for (int i=0; i<n; i++) {
+    if (tmp[i]>0) {
+      int j=sa[tmp[i]-1];
+      while (i+h<n && j+h<n && seq[i+h]==seq[j+h]) h++;
+      lcp[tmp[i]]=h;
+      if (h>0) h--;
+    } else {
+      h=0;
+    }
+  }
+}
+
+// factor repeated command sequences into subroutines.
+// seq holds the channel streams (token indices) separated by unique negative values.
+// each round picks the repeat which saves the most bytes and replaces its occurrences
+// with a call, until no repeat is worth it.
+static void extractSubroutines(std::vector<int>& seq, std::vector<CSToken>& tokens, std::vector<CSSubroutine>& subs) {
+  struct Candidate {
+    int saved, len, lb, rb;
+  };
+  std::vector<int> sa, lcp, prefix;
+  std::vector<int> occur;
+  std::vector<std::pair<int,int>> stack;
+
+  while (seq.size()>1) {
+    int n=seq.size();
+    buildSuffixArray(seq,sa,lcp);
+    prefix.resize(n+1);
+    prefix[0]=0;
+    for (int i=0; i<n; i++) {
+      prefix[i+1]=prefix[i]+((seq[i]<0)?0:tokens[seq[i]].len);
+    }
+
+    // walk the LCP intervals and keep the most promising ones.
+    // overlapping occurrences are counted here, so the estimate may be too high.
+    std::vector<Candidate> cands;
+    auto consider=[&](int len, int lb, int rb) {
+      int count=rb-lb+1;
+      int bytes=prefix[sa[lb]+len]-prefix[sa[lb]];
+      int saved=count*bytes-count*CS_CALL_LEN-bytes-1;
+      if (saved<=0) return;
+      if (cands.size()>=8 && cands.back().saved>=saved) return;
+      Candidate c={saved,len,lb,rb};
+      cands.insert(std::upper_bound(cands.begin(),cands.end(),c,[](const Candidate& a, const Candidate& b) {
+        return a.saved>b.saved;
+      }),c);
+      if (cands.size()>8) cands.pop_back();
+    };
+    stack.clear();
+    stack.push_back(std::pair<int,int>(0,0));
+    for (int i=1; i<=n; i++) {
+      int cur=(i<n)?lcp[i]:0;
+      int lb=i-1;
+      while (cur<stack.back().first) {
+        lb=stack.back().second;
+        consider(stack.back().first,lb,i-1);
+        stack.pop_back();
+      }
+      if (cur>stack.back().first) stack.push_back(std::pair<int,int>(cur,lb));
+    }
+
+    // now count the occurrences which don't overlap
+    int bestSaved=0;
+    int bestLen=0;
+    int bestDepth=0;
+    std::vector<int> bestOccur;
+    for (Candidate& c: cands) {
+      if (c.saved<=bestSaved) break;
+      occur.clear();
+      for (int i=c.lb; i<=c.rb; i++) {
+        occur.push_back(sa[i]);
+      }
+      std::sort(occur.begin(),occur.end());
+      int lastEnd=0;
+      size_t count=0;
+      for (int i: occur) {
+        if (i<lastEnd) continue;
+        occur[count++]=i;
+        lastEnd=i+c.len;
+      }
+      occur.resize(count);
+      int bytes=prefix[occur[0]+c.len]-prefix[occur[0]];
+      int saved=count*bytes-count*CS_CALL_LEN-bytes-1;
+      if (saved<=bestSaved) continue;
+      int depth=1;
+      for (int i=occur[0]; i<occur[0]+c.len; i++) {
+        if (tokens[seq[i]].sub>=0) depth=MAX(depth,subs[tokens[seq[i]].sub].depth+1);
+      }
+      if (depth>DIV_MAX_CSSTACK) continue;
+      bestSaved=saved;
+      bestLen=c.len;
+      bestDepth=depth;
+      bestOccur=occur;
+    }
+    if (bestSaved<=0) break;
+
+    CSSubroutine sub;
+    sub.body=std::vector<int>(seq.begin()+bestOccur[0],seq.begin()+bestOccur[0]+bestLen);
+    sub.depth=bestDepth;
+    sub.addr=0;
+    tokens.push_back(CSToken((int)subs.size()));
+    subs.push_back(sub);
+
+    int call=tokens.size()-1;
+    std::vector<int> newSeq;
+    newSeq.reserve(n);
+    size_t nextOccur=0;
+    for (int i=0; i<n; i++) {
+      if (nextOccur<bestOccur.size() && bestOccur[nextOccur]==i) {
+        newSeq.push_back(call);
+        i+=bestLen-1;
+        nextOccur++;
+        continue;
+      }
+      newSeq.push_back(seq[i]);
+    }
+    seq.swap(newSeq);
+  }
+}
+
+static void writeTokens(SafeWriter* w, const std::vector<int>& seq, size_t start, size_t end, const std::vector<CSToken>& tokens, const std::vector<CSSubroutine>& subs) {
+  for (size_t i=start; i<end; i++) {
+    const CSToken& t=tokens[seq[i]];
+    if (t.sub>=0) {
+      w->writeC(0xf5);
+      w->writeI(subs[t.sub].addr);
+    } else {
+      w->write(t.data.data(),t.data.size());
+    }
+  }
+}
+
 SafeWriter* DivEngine::saveCommand() {
   stop();
   repeatPattern=false;
@@ -346,6 +535,9 @@ SafeWriter* DivEngine::saveCommand() {
     sortPos++;
   }
 
+  // command boundaries in the optimized streams
+  std::vector<unsigned int> cmdPos[DIV_MAX_CHANS];
+
   for (int i=0; i<chans; i++) {
     chanStream[i]->writeC(0xff);
     // optimize stream
@@ -357,6 +549,7 @@ SafeWriter* DivEngine::saveCommand() {
     while (1) {
       try {
         unsigned char next=reader->readC();
+        cmdPos[i].push_back(chanStream[i]->tell());
         switch (next) {
           case 0xb8: // instrument
           case 0xc0: // pre porta
@@ -459,14 +652,64 @@ SafeWriter* DivEngine::saveCommand() {
     delete oldStream;
   }
 
+  // split the streams into commands (the final stop is left out)
+  std::vector<CSToken> tokens;
+  std::vector<CSSubroutine> subs;
+  std::unordered_map<String,int> tokenMap;
+  std::vector<int> seq;
+  size_t chanSeqEnd[DIV_MAX_CHANS];
+  size_t oldSize=0;
   for (int i=0; i<chans; i++) {
-    chanStreamOff[i]=w->tell();
-    logI("- %d: off %x size %ld",i,chanStreamOff[i],chanStream[i]->size());
-    w->write(chanStream[i]->getFinalBuf(),chanStream[i]->size());
+    unsigned char* buf=chanStream[i]->getFinalBuf();
+    for (size_t j=0; j+1<cmdPos[i].size(); j++) {
+      String data((const char*)&buf[cmdPos[i][j]],cmdPos[i][j+1]-cmdPos[i][j]);
+      auto t=tokenMap.find(data);
+      if (t==tokenMap.end()) {
+        t=tokenMap.emplace(data,(int)tokens.size()).first;
+        tokens.push_back(CSToken(data));
+      }
+      seq.push_back(t->second);
+    }
+    seq.push_back(-1-i);
+    oldSize+=chanStream[i]->size();
     chanStream[i]->finish();
     delete chanStream[i];
   }
 
+  extractSubroutines(seq,tokens,subs);
+
+  // lay out the channels followed by the subroutines
+  size_t chanSeqStart=0;
+  unsigned int addr=w->tell();
+  for (int i=0; i<chans; i++) {
+    chanStreamOff[i]=addr;
+    while (seq[chanSeqStart]!=-1-i) {
+      addr+=tokens[seq[chanSeqStart++]].len;
+    }
+    chanSeqEnd[i]=chanSeqStart++;
+    addr++;
+  }
+  for (CSSubroutine& i: subs) {
+    i.addr=addr;
+    for (int j: i.body) {
+      addr+=tokens[j].len;
+    }
+    addr++;
+  }
+
+  chanSeqStart=0;
+  for (int i=0; i<chans; i++) {
+    writeTokens(w,seq,chanSeqStart,chanSeqEnd[i],tokens,subs);
+    w->writeC(0xff);
+    logI("- %d: off %x size %ld",i,chanStreamOff[i],w->tell()-chanStreamOff[i]);
+    chanSeqStart=chanSeqEnd[i]+1;
+  }
+  for (CSSubroutine& i: subs) {
+    writeTokens(w,i.body,0,i.body.size(),tokens,subs);
+    w->writeC(0xf9);
+  }
+  logI("%d subroutines: %ld -> %ld bytes",(int)subs.size(),oldSize,w->tell()-chanStreamOff[0]);
+
   w->seek(8,SEEK_SET);
   for (int i=0; i<chans; i++) {
     w->writeI(chanStreamOff[i]);
@@ -22,6 +22,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
 #include "../pch.h"
 #include "config.h"
 #include "chipUtils.h"
@@ -290,27 +291,62 @@ struct DivCommand {
     value2(0) {}
 };
 
+// notes covered by a DivPitchTable, starting at DIV_PITCH_TABLE_FIRST.
+// anything outside of this range is calculated on the spot.
+#define DIV_PITCH_TABLE_FIRST -128
+#define DIV_PITCH_TABLE_NOTES 512
+// how many DivPitchTables the engine may keep at once
+#define DIV_MAX_PITCH_TABLES 64
+
+// frequency lookup table for one chip clock/divider/pitch mode combination.
+// see DivEngine::getPitchTable().
+// entries are identical to what the calc*() functions below return.
 struct DivPitchTable {
-  int pitch[(12*128)+1];
+  double tuning, clock, divider;
   unsigned char linearity, blockBits;
   bool period;
 
-  // get pitch
-  int get(int base, int pitch, int pitch2);
+  // non-linear: base frequency/period and f-num/block of each note
+  double base[DIV_PITCH_TABLE_NOTES];
+  int baseFNumBlock[DIV_PITCH_TABLE_NOTES];
+  // full linear: frequency for each note and 1/128th of a semitone.
+  // allocated on first use.
+  std::atomic<int*> pitch[DIV_PITCH_TABLE_NOTES];
+
+  // check whether this table is for these parameters
+  bool matches(double tuning, double clock, double divider, unsigned char linear, bool isPeriod, unsigned char block);
+
+  // full linear: get frequency of a (note<<7)+pitch value
+  int get(int nbase);
 
-  // linear: note
-  // non-linear: get(note,0,0)
-  int getBase(int note);
+  // non-linear: get base frequency/period of a note
+  double getBase(int note);
+
+  // non-linear: get base frequency of a note in f-num/block format
+  int getBaseFNumBlock(int note);
 
   // calculate pitch table
-  void init(float tuning, double clock, double divider, int octave, unsigned char linear, bool isPeriod, unsigned char block=0);
+  void init(double tuning, double clock, double divider, unsigned char linear, bool isPeriod, unsigned char block=0);
+
+  // the actual calculations
+  static double calcBase(double tuning, double clock, double divider, int note, bool isPeriod);
+  static int calcFNumBlock(int bf, double tuning, double clock, double divider, int note, int bits);
+  static int calcLinear(double tuning, double clock, double divider, int nbase, bool isPeriod, int block);
 
   DivPitchTable():
+    tuning(440.0),
+    clock(1.0),
+    divider(1.0),
     linearity(2),
     blockBits(0),
     period(false) {
-    memset(pitch,0,sizeof(pitch));
+    memset(base,0,sizeof(base));
+    memset(baseFNumBlock,0,sizeof(baseFNumBlock));
+    for (int i=0; i<DIV_PITCH_TABLE_NOTES; i++) {
+      pitch[i]=NULL;
+    }
   }
+  ~DivPitchTable();
 };
 
 struct DivDelayedCommand {
@@ -510,6 +546,18 @@ class DivDispatch {
      * please honor these variables if needed.
      */
     bool skipRegisterWrites, dumpWrites;
+    /**
+     * set when nobody reads the oscilloscope buffers (e.g. while rendering to a file).
+     * acquire() should skip writing to them, along with any work done only for them.
+     */
+    bool skipOscWrites;
+    /**
+     * when rendering a whole buffer at once (see getRenderPerBuffer()), the position in
+     * the buffer (at this dispatch's rate) which queued writes belong to.
+     * acquire() shall apply a write once it reaches that position.
+     * -1 means writes are applied as soon as possible, including those already queued.
+     */
+    int renderPos;
   public:
     /**
      * the rate the samples are provided.
@@ -628,18 +676,27 @@ class DivDispatch {
     virtual int getRegisterPoolDepth();
 
     /**
-     * get this dispatch's state. DO NOT IMPLEMENT YET.
-     * @return a pointer to the dispatch's state. must be deallocated manually!
+     * get this dispatch's state.
+     * this is a snapshot of the logical (playback) state, not of the emulated chip.
+     * it is only valid for this dispatch instance.
+     * @return a pointer to the dispatch's state, or NULL if this dispatch does not
+     * support state saves. must be deallocated with freeState()!
      */
     virtual void* getState();
 
     /**
-     * set this dispatch's state. DO NOT IMPLEMENT YET.
+     * set this dispatch's state.
      * @param state a pointer to a state pertaining to this dispatch,
      * or NULL if this dispatch does not support state saves.
      */
     virtual void setState(void* state);
 
+    /**
+     * deallocate a state returned by getState().
+     * @param state the state.
+     */
+    virtual void freeState(void* state);
+
     /**
      * mute a channel.
      * @param ch the channel to mute.
@@ -736,6 +793,32 @@ class DivDispatch {
      */
     virtual void setSkipRegisterWrites(bool value);
 
+    /**
+     * set whether to skip writing to the oscilloscope buffers.
+     */
+    virtual void setSkipOscWrites(bool value);
+
+    /**
+     * set the position register writes belong to. see renderPos.
+     */
+    virtual void setRenderPos(int pos);
+
+    /**
+     * check whether this dispatch may render a whole buffer at once after all ticks in it.
+     * for this to work, everything tick() and dispatch() do to the chip must go through
+     * writes queued with renderPos, and acquire() must not read anything else they change.
+     * the engine renders up to the current position before calling reset().
+     * @return whether so.
+     */
+    virtual bool getRenderPerBuffer();
+
+    /**
+     * check whether too many writes have been queued while rendering a whole buffer.
+     * if so, the engine renders up to the current position before continuing.
+     * @return whether so.
+     */
+    virtual bool getRenderFlushNeeded();
+
     /**
      * notify instrument change.
      */
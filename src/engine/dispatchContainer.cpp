@@ -104,8 +104,9 @@ void DivDispatchContainer::setRates(double gotRate) {
   rateMemory=gotRate;
 }
 
-void DivDispatchContainer::setQuality(bool lowQual, bool dcHiPass) {
+void DivDispatchContainer::setQuality(bool lowQual, bool dcHiPass, bool simd) {
   lowQuality=lowQual;
+  simdBlip=simd;
   hiPass=dcHiPass;
   for (int i=0; i<DIV_MAX_OUTPUTS; i++) {
     if (bb[i]==NULL) continue;
@@ -165,6 +166,14 @@ void DivDispatchContainer::acquire(size_t offset, size_t count) {
   dispatch->acquire(bbInMapped,count);
 }
 
+void DivDispatchContainer::acquireDeferred() {
+  if (runPos<=renderedPos) return;
+  dispatch->setRenderPos(renderedPos);
+  acquire(renderedPos,runPos-renderedPos);
+  renderedPos=runPos;
+  dispatch->setRenderPos(renderedPos);
+}
+
 void DivDispatchContainer::flush(size_t count) {
   int outs=dispatch->getOutputCount();
 
@@ -197,6 +206,13 @@ void DivDispatchContainer::fillBuf(size_t runtotal, size_t offset, size_t size)
         prevSample[i]=temp[i];
       }
     }
+  } else if (simdBlip) {
+    // same as below, but change points are found and added in bulk
+    for (int i=0; i<outs; i++) {
+      if (bbIn[i]==NULL) continue;
+      if (bb[i]==NULL) continue;
+      blip_add_samples(bb[i],bbIn[i],runtotal,&temp[i],&prevSample[i]);
+    }
   } else {
     for (int i=0; i<outs; i++) {
       if (bbIn[i]==NULL) continue;
@@ -768,7 +784,10 @@ void DivDispatchContainer::init(DivSystem sys, DivEngine* eng, int chanCount, do
       dispatch=new DivPlatformDummy;
       break;
   }
+  dispatch->setRenderPos(-1);
   dispatch->init(eng,chanCount,gotRate,flags);
+  // nobody looks at the oscilloscope while rendering
+  dispatch->setSkipOscWrites(isRender);
 
   // initialize output buffers
   int outs=dispatch->getOutputCount();
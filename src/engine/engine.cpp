@@ -39,6 +39,7 @@
 #include "../audio/pipe.h"
 #include <math.h>
 #include <float.h>
+#include <algorithm>
 #include <fmt/printf.h>
 
 void process(void* u, float** in, float** out, int inChans, int outChans, unsigned int size) {
@@ -195,7 +196,7 @@ void DivEngine::walkSong(int& loopOrder, int& loopRow, int& loopEnd) {
   int nextRow=0;
   int effectVal=0;
   int lastSuspectedLoopEnd=-1;
-  DivPattern* pat[DIV_MAX_CHANS];
+  const DivPattern* pat[DIV_MAX_CHANS];
   unsigned char wsWalked[8192];
   memset(wsWalked,0,8192);
   for (int i=0; i<curSubSong->ordersLen; i++) {
@@ -323,6 +324,7 @@ double DivEngine::benchmarkSeek() {
 
 void DivEngine::notifyInsChange(int ins) {
   BUSY_BEGIN;
+  invalidateKeyframes();
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].dispatch->notifyInsChange(ins);
   }
@@ -331,12 +333,23 @@ void DivEngine::notifyInsChange(int ins) {
 
 void DivEngine::notifyWaveChange(int wave) {
   BUSY_BEGIN;
+  invalidateKeyframes();
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].dispatch->notifyWaveChange(wave);
   }
   BUSY_END;
 }
 
+void DivEngine::notifyPitchTable() {
+  BUSY_BEGIN;
+  // tables for the old tuning are no longer needed
+  clearPitchTables();
+  for (int i=0; i<song.systemLen; i++) {
+    disCont[i].dispatch->notifyPitchTable();
+  }
+  BUSY_END;
+}
+
 int DivEngine::loadSampleROM(String path, ssize_t expectedSize, unsigned char*& ret) {
   ret=NULL;
   if (path.empty()) {
@@ -427,6 +440,34 @@ int DivEngine::loadSampleROMs() {
   return error;
 }
 
+struct DivSampleRenderJob {
+  DivSample* sample;
+  unsigned int formatMask;
+  unsigned long long hash;
+  DivSampleRenderJob(DivSample* s, unsigned int fm, unsigned long long h):
+    sample(s),
+    formatMask(fm),
+    hash(h) {}
+};
+
+struct DivSampleRenderQueue {
+  std::vector<DivSampleRenderJob>* jobs;
+  std::atomic<size_t>* next;
+  DivSampleRenderQueue(std::vector<DivSampleRenderJob>* j, std::atomic<size_t>* n):
+    jobs(j),
+    next(n) {}
+};
+
+static void _renderSampleQueue(void* q) {
+  DivSampleRenderQueue* queue=(DivSampleRenderQueue*)q;
+  while (true) {
+    size_t next=queue->next->fetch_add(1);
+    if (next>=queue->jobs->size()) break;
+    DivSampleRenderJob& job=(*queue->jobs)[next];
+    job.sample->render(job.formatMask);
+  }
+}
+
 void DivEngine::renderSamplesP(int whichSample) {
   BUSY_BEGIN;
   renderSamples(whichSample);
@@ -449,12 +490,48 @@ void DivEngine::renderSamples(int whichSample) {
   }
 
   // step 1: render samples
-  if (whichSample==-1) {
-    for (int i=0; i<song.sampleLen; i++) {
-      song.sample[i]->render(formatMask);
+  // samples which haven't changed since the last render are skipped, and
+  // samples which were rendered before are fetched from the cache.
+  // the rest is rendered in parallel.
+  std::vector<DivSampleRenderJob> jobs;
+  for (int i=0; i<song.sampleLen; i++) {
+    if (whichSample!=-1 && whichSample!=i) continue;
+    DivSample* s=song.sample[i];
+    unsigned long long hash=s->getRenderHash(formatMask);
+    if (hash==s->renderHash) continue;
+    if (sampleCache.fetch(s,hash)) {
+      s->renderHash=hash;
+      continue;
+    }
+    jobs.push_back(DivSampleRenderJob(s,formatMask,hash));
+  }
+
+  if (!jobs.empty()) {
+    logD("rendering %d samples...",(int)jobs.size());
+    unsigned int threads=std::thread::hardware_concurrency();
+    if (threads>jobs.size()) threads=jobs.size();
+    if (threads>1) {
+      // start with the largest samples so that threads finish at around the same time
+      std::sort(jobs.begin(),jobs.end(),[](const DivSampleRenderJob& a, const DivSampleRenderJob& b) {
+        return a.sample->samples>b.sample->samples;
+      });
+      std::atomic<size_t> nextJob(0);
+      DivSampleRenderQueue queue(&jobs,&nextJob);
+      DivWorkPool* pool=new DivWorkPool(threads);
+      for (unsigned int i=0; i<threads; i++) {
+        pool->push(_renderSampleQueue,&queue);
+      }
+      pool->wait();
+      delete pool;
+    } else {
+      for (DivSampleRenderJob& i: jobs) {
+        i.sample->render(i.formatMask);
+      }
+    }
+    for (DivSampleRenderJob& i: jobs) {
+      i.sample->renderHash=i.hash;
+      sampleCache.store(i.sample,i.hash,i.formatMask);
     }
-  } else if (whichSample>=0 && whichSample<song.sampleLen) {
-    song.sample[whichSample]->render(formatMask);
   }
 
   // step 2: render samples to dispatch
@@ -465,6 +542,13 @@ void DivEngine::renderSamples(int whichSample) {
   }
 }
 
+void DivEngine::clearSampleCache() {
+  sampleCache.clear();
+  for (DivSample* i: song.sample) {
+    i->renderHash=0;
+  }
+}
+
 String DivEngine::decodeSysDesc(String desc) {
   DivConfig newDesc;
   bool hasVal=false;
@@ -694,6 +778,7 @@ void DivEngine::stompChannel(int ch) {
 }
 
 void DivEngine::changeSong(size_t songIndex) {
+  invalidateKeyframes();
   if (songIndex>=song.subsong.size()) return;
   curSubSong=song.subsong[songIndex];
   curPat=song.subsong[songIndex]->pat;
@@ -847,7 +932,7 @@ int DivEngine::duplicateSubSong(int index) {
 
     for (int j=0; j<DIV_MAX_PATTERNS; j++) {
       if (theOrig->pat[i].data[j]==NULL) continue;
-      DivPattern* origPat=theOrig->pat[i].getPattern(j,false);
+      const DivPattern* origPat=theOrig->pat[i].getPattern(j,false);
       DivPattern* copyPat=theCopy->pat[i].getPattern(j,true);
       origPat->copyOn(copyPat);
     }
@@ -1027,7 +1112,7 @@ void DivEngine::delUnusedSamples() {
       bool is17On=false;
       int bank=0;
       for (int k=0; k<i->ordersLen; k++) {
-        DivPattern* p=i->pat[j].getPattern(i->orders.ord[j][k],false);
+        const DivPattern* p=i->pat[j].getPattern(i->orders.ord[j][k],false);
         for (int l=0; l<i->patLen; l++) {
           for (int m=0; m<i->pat[j].effectCols; m++) {
             if (p->data[l][4+(m<<1)]==0x17) {
@@ -1127,6 +1212,7 @@ bool DivEngine::changeSystem(int index, DivSystem which, bool preserveOrder) {
 }
 
 bool DivEngine::addSystem(DivSystem which) {
+  invalidateKeyframes();
   if (song.systemLen>=DIV_MAX_CHIPS) {
     lastError=fmt::sprintf(_("max number of systems is %d"),DIV_MAX_CHIPS);
     return false;
@@ -1282,6 +1368,7 @@ bool DivEngine::duplicateSystem(int index, bool pat, bool end) {
 
 // TODO: maybe issue with subsongs?
 bool DivEngine::removeSystem(int index, bool preserveOrder) {
+  invalidateKeyframes();
   if (song.systemLen<=1) {
     lastError=_("cannot remove the last one");
     return false;
@@ -1335,6 +1422,7 @@ bool DivEngine::removeSystem(int index, bool preserveOrder) {
 }
 
 void DivEngine::swapSystemUnsafe(int src, int dest, bool preserveOrder) {
+  invalidateKeyframes();
   if (!preserveOrder) {
     // move channels
     unsigned char unswappedChannels[DIV_MAX_CHANS];
@@ -1647,6 +1735,14 @@ DivDispatchOscBuffer* DivEngine::getOscBuffer(int chan) {
   return disCont[dispatchOfChan[chan]].dispatch->getOscBuffer(dispatchChanOfChan[chan]);
 }
 
+void DivEngine::setOscBuffersEnabled(bool enable) {
+  BUSY_BEGIN;
+  for (int i=0; i<song.systemLen; i++) {
+    if (disCont[i].dispatch!=NULL) disCont[i].dispatch->setSkipOscWrites(!enable);
+  }
+  BUSY_END;
+}
+
 void DivEngine::enableCommandStream(bool enable) {
   cmdStreamEnabled=enable;
 }
@@ -1662,6 +1758,150 @@ void DivEngine::getCommandStream(std::vector<DivCommand>& where) {
   BUSY_END;
 }
 
+void DivEngine::invalidateKeyframes() {
+  songRevision++;
+}
+
+DivPlaybackKeyframe* DivEngine::storeKeyframe() {
+  DivPlaybackKeyframe* kf=new DivPlaybackKeyframe;
+  kf->systemLen=song.systemLen;
+  for (int i=0; i<song.systemLen; i++) {
+    kf->dispatch[i]=disCont[i].dispatch;
+    kf->dispatchState[i]=NULL;
+  }
+  for (int i=0; i<song.systemLen; i++) {
+    kf->dispatchState[i]=disCont[i].dispatch->getState();
+    if (kf->dispatchState[i]==NULL) {
+      // this dispatch does not support state saves
+      freeKeyframe(kf);
+      return NULL;
+    }
+  }
+
+  kf->chan.assign(chan,chan+chans);
+  kf->subticks=subticks;
+  kf->ticks=ticks;
+  kf->curRow=curRow;
+  kf->curOrder=curOrder;
+  kf->prevRow=prevRow;
+  kf->prevOrder=prevOrder;
+  kf->totalLoops=totalLoops;
+  kf->lastLoopPos=lastLoopPos;
+  kf->nextSpeed=nextSpeed;
+  kf->elapsedBars=elapsedBars;
+  kf->elapsedBeats=elapsedBeats;
+  kf->curSpeed=curSpeed;
+  kf->cycles=cycles;
+  kf->midiClockCycles=midiClockCycles;
+  kf->midiTimeCycles=midiTimeCycles;
+  kf->stepPlay=stepPlay;
+  kf->tickMult=tickMult;
+  kf->arpLen=curSubSong->arpLen;
+  kf->changeOrd=changeOrd;
+  kf->changePos=changePos;
+  kf->totalSeconds=totalSeconds;
+  kf->totalTicks=totalTicks;
+  kf->totalTicksR=totalTicksR;
+  kf->curMidiClock=curMidiClock;
+  kf->curMidiTime=curMidiTime;
+  kf->globalPitch=globalPitch;
+  kf->curMidiTimePiece=curMidiTimePiece;
+  kf->curMidiTimeCode=curMidiTimeCode;
+  kf->divider=divider;
+  kf->clockDrift=clockDrift;
+  kf->midiClockDrift=midiClockDrift;
+  kf->midiTimeDrift=midiTimeDrift;
+  kf->extValue=extValue;
+  kf->pendingMetroTick=pendingMetroTick;
+  kf->playing=playing;
+  kf->endOfSong=endOfSong;
+  kf->firstTick=firstTick;
+  kf->extValuePresent=extValuePresent;
+  kf->shallStop=shallStop;
+  kf->shallStopSched=shallStopSched;
+  kf->speeds=speeds;
+  kf->virtualTempoN=virtualTempoN;
+  kf->virtualTempoD=virtualTempoD;
+  kf->tempoAccum=tempoAccum;
+  memcpy(kf->walked,walked,8192);
+  return kf;
+}
+
+bool DivEngine::restoreKeyframe(DivPlaybackKeyframe* kf) {
+  if (kf->systemLen!=song.systemLen) return false;
+  if ((int)kf->chan.size()!=chans) return false;
+  for (int i=0; i<song.systemLen; i++) {
+    if (kf->dispatch[i]!=disCont[i].dispatch) return false;
+  }
+
+  for (int i=0; i<song.systemLen; i++) {
+    disCont[i].dispatch->setState(kf->dispatchState[i]);
+  }
+  for (int i=0; i<chans; i++) {
+    chan[i]=kf->chan[i];
+  }
+  subticks=kf->subticks;
+  ticks=kf->ticks;
+  curRow=kf->curRow;
+  curOrder=kf->curOrder;
+  prevRow=kf->prevRow;
+  prevOrder=kf->prevOrder;
+  totalLoops=kf->totalLoops;
+  lastLoopPos=kf->lastLoopPos;
+  nextSpeed=kf->nextSpeed;
+  elapsedBars=kf->elapsedBars;
+  elapsedBeats=kf->elapsedBeats;
+  curSpeed=kf->curSpeed;
+  cycles=kf->cycles;
+  midiClockCycles=kf->midiClockCycles;
+  midiTimeCycles=kf->midiTimeCycles;
+  stepPlay=kf->stepPlay;
+  tickMult=kf->tickMult;
+  curSubSong->arpLen=kf->arpLen;
+  changeOrd=kf->changeOrd;
+  changePos=kf->changePos;
+  totalSeconds=kf->totalSeconds;
+  totalTicks=kf->totalTicks;
+  totalTicksR=kf->totalTicksR;
+  curMidiClock=kf->curMidiClock;
+  curMidiTime=kf->curMidiTime;
+  globalPitch=kf->globalPitch;
+  curMidiTimePiece=kf->curMidiTimePiece;
+  curMidiTimeCode=kf->curMidiTimeCode;
+  divider=kf->divider;
+  clockDrift=kf->clockDrift;
+  midiClockDrift=kf->midiClockDrift;
+  midiTimeDrift=kf->midiTimeDrift;
+  extValue=kf->extValue;
+  pendingMetroTick=kf->pendingMetroTick;
+  playing=kf->playing;
+  endOfSong=kf->endOfSong;
+  firstTick=kf->firstTick;
+  extValuePresent=kf->extValuePresent;
+  shallStop=kf->shallStop;
+  shallStopSched=kf->shallStopSched;
+  speeds=kf->speeds;
+  virtualTempoN=kf->virtualTempoN;
+  virtualTempoD=kf->virtualTempoD;
+  tempoAccum=kf->tempoAccum;
+  memcpy(walked,kf->walked,8192);
+  return true;
+}
+
+void DivEngine::freeKeyframe(DivPlaybackKeyframe* kf) {
+  for (int i=0; i<kf->systemLen; i++) {
+    if (kf->dispatchState[i]!=NULL) kf->dispatch[i]->freeState(kf->dispatchState[i]);
+  }
+  delete kf;
+}
+
+void DivEngine::clearKeyframes() {
+  for (DivPlaybackKeyframe* i: keyframes) {
+    if (i!=NULL) freeKeyframe(i);
+  }
+  keyframes.clear();
+}
+
 void DivEngine::playSub(bool preserveDrift, int goalRow) {
   logV("playSub() called");
   std::chrono::high_resolution_clock::time_point timeStart=std::chrono::high_resolution_clock::now();
@@ -1671,6 +1911,16 @@ void DivEngine::playSub(bool preserveDrift, int goalRow) {
     logV("preserveDrift && curOrder is true");
     return;
   }
+  // keyframes are only taken when replaying from the very beginning
+  bool useKeyframes=(!preserveDrift && keyframeInterval>0 && curSubSong!=NULL);
+  if (useKeyframes) {
+    unsigned int rev=songRevision;
+    if (rev!=keyframeRevision || keyframeSubSong!=curSubSongIndex) {
+      clearKeyframes();
+      keyframeRevision=rev;
+      keyframeSubSong=curSubSongIndex;
+    }
+  }
   bool oldRepeatPattern=repeatPattern;
   repeatPattern=false;
   int goal=curOrder;
@@ -1711,6 +1961,19 @@ void DivEngine::playSub(bool preserveDrift, int goalRow) {
   memset(walked,0,8192);
   for (int i=0; i<song.systemLen; i++) disCont[i].dispatch->setSkipRegisterWrites(true);
   logV("goal: %d goalRow: %d",goal,goalRow);
+  // highest order reached so far. a keyframe is only taken the first time
+  // playback goes past all previous orders, so it is valid for any goal after it.
+  int maxOrder=curOrder;
+  if (useKeyframes) {
+    for (int i=MIN(goal/keyframeInterval,(int)keyframes.size()-1); i>0; i--) {
+      if (keyframes[i]==NULL) continue;
+      if (restoreKeyframe(keyframes[i])) {
+        logV("restored keyframe at order %d",curOrder);
+        maxOrder=curOrder;
+        break;
+      }
+    }
+  }
   while (playing && curOrder<goal) {
     if (nextTick(preserveDrift)) {
       skipping=false;
@@ -1725,6 +1988,14 @@ void DivEngine::playSub(bool preserveDrift, int goalRow) {
       runMidiClock(cycles);
       runMidiTime(cycles);
     }
+    if (useKeyframes && curOrder>maxOrder) {
+      maxOrder=curOrder;
+      if ((curOrder%keyframeInterval)==0) {
+        size_t index=curOrder/keyframeInterval;
+        if (index>=keyframes.size()) keyframes.resize(index+1,NULL);
+        if (keyframes[index]==NULL) keyframes[index]=storeKeyframe();
+      }
+    }
   }
   int oldOrder=curOrder;
   while (playing && (curRow<goalRow || ticks>1)) {
@@ -1793,57 +2064,56 @@ int DivEngine::calcBaseFreq(double clock, double divider, int note, bool period)
          base*(divider/clock);
 }*/
 
-double DivEngine::calcBaseFreq(double clock, double divider, int note, bool period) {
+DivPitchTable* DivEngine::getPitchTable(double clock, double divider, bool period, unsigned char blockBits) {
+  double tuning=song.tuning;
+  unsigned char linearity=song.linearPitch;
+  for (int i=0; i<DIV_MAX_PITCH_TABLES; i++) {
+    DivPitchTable* pt=pitchTables[i].load();
+    if (pt==NULL) {
+      // create a new one
+      DivPitchTable* newTable=new DivPitchTable;
+      newTable->init(tuning,clock,divider,linearity,period,blockBits);
+      if (pitchTables[i].compare_exchange_strong(pt,newTable)) {
+        logV("pitch table %d: clock %f divider %f period %d block %d",i,clock,divider,period,blockBits);
+        return newTable;
+      }
+      // someone else took this slot
+      delete newTable;
+    }
+    if (pt->matches(tuning,clock,divider,linearity,period,blockBits)) return pt;
+  }
+  return NULL;
+}
+
+void DivEngine::clearPitchTables() {
+  for (int i=0; i<DIV_MAX_PITCH_TABLES; i++) {
+    DivPitchTable* pt=pitchTables[i].exchange(NULL);
+    if (pt!=NULL) delete pt;
+  }
+}
+
+double DivEngine::calcBaseFreq(double clock, double divider, int note, bool period, bool cached) {
   if (song.linearPitch==2) { // full linear
     return (note<<7);
   }
-  double base=(period?(song.tuning*0.0625):song.tuning)*pow(2.0,(float)(note+3)/12.0);
-  return period?
-         (clock/base)/divider:
-         base*(divider/clock);
+  if (cached) {
+    DivPitchTable* pt=getPitchTable(clock,divider,period,0);
+    if (pt!=NULL) return pt->getBase(note);
+  }
+  return DivPitchTable::calcBase(song.tuning,clock,divider,note,period);
 }
 
-#define CONVERT_FNUM_BLOCK(bf,bits,note) \
-  double tuning=song.tuning; \
-  if (tuning<400.0) tuning=400.0; \
-  if (tuning>500.0) tuning=500.0; \
-  int boundaryBottom=tuning*pow(2.0,0.25)*(divider/clock); \
-  int boundaryTop=2.0*tuning*pow(2.0,0.25)*(divider/clock); \
-  while (boundaryTop>((1<<bits)-1)) { \
-    boundaryTop>>=1; \
-    boundaryBottom>>=1; \
-  } \
-  int block=(note)/12; \
-  if (block<0) block=0; \
-  if (block>7) block=7; \
-  bf>>=block; \
-  if (bf<0) bf=0; \
-  /* octave boundaries */ \
-  while (bf>0 && bf<boundaryBottom && block>0) { \
-    bf<<=1; \
-    block--; \
-  } \
-  if (bf>boundaryTop) { \
-    while (block<7 && bf>boundaryTop) { \
-      bf>>=1; \
-      block++; \
-    } \
-    if (bf>((1<<bits)-1)) { \
-      bf=(1<<bits)-1; \
-    } \
-  } \
-  /* logV("f-num: %d block: %d",bf,block); */ \
-  return bf|(block<<bits);
-
 int DivEngine::calcBaseFreqFNumBlock(double clock, double divider, int note, int bits) {
   if (song.linearPitch==2) { // full linear
     return (note<<7);
   }
+  DivPitchTable* pt=getPitchTable(clock,divider,false,bits);
+  if (pt!=NULL) return pt->getBaseFNumBlock(note);
   int bf=calcBaseFreq(clock,divider,note,false);
-  CONVERT_FNUM_BLOCK(bf,bits,note)
+  return DivPitchTable::calcFNumBlock(bf,song.tuning,clock,divider,note,bits);
 }
 
-int DivEngine::calcFreq(int base, int pitch, int arp, bool arpFixed, bool period, int octave, int pitch2, double clock, double divider, int blockBits) {
+int DivEngine::calcFreq(int base, int pitch, int arp, bool arpFixed, bool period, int octave, int pitch2, double clock, double divider, int blockBits, bool cached) {
   if (song.linearPitch==2) {
     // do frequency calculation here
     int nbase=base+pitch+pitch2;
@@ -1854,15 +2124,11 @@ int DivEngine::calcFreq(int base, int pitch, int arp, bool arpFixed, bool period
         nbase+=arp<<7;
       }
     }
-    double fbase=(period?(song.tuning*0.0625):song.tuning)*pow(2.0,(float)(nbase+384)/(128.0*12.0));
-    int bf=period?
-           round((clock/fbase)/divider):
-           round(fbase*(divider/clock));
-    if (blockBits>0) {
-      CONVERT_FNUM_BLOCK(bf,blockBits,nbase>>7)
-    } else {
-      return bf;
+    if (cached) {
+      DivPitchTable* pt=getPitchTable(clock,divider,period,MAX(blockBits,0));
+      if (pt!=NULL) return pt->get(nbase);
     }
+    return DivPitchTable::calcLinear(song.tuning,clock,divider,nbase,period,blockBits);
   }
   if (song.linearPitch==1) {
     // global pitch multiplier
@@ -2191,6 +2457,8 @@ void DivEngine::reset() {
   nextSpeed=speeds.val[0];
   divider=curSubSong->hz;
   globalPitch=0;
+  // chips rendered once per buffer have to catch up before being reset
+  if (renderPerBuffer) flushDeferredRender(true);
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].dispatch->reset();
     disCont[i].clear();
@@ -2673,6 +2941,7 @@ void DivEngine::loadTempIns(DivInstrument* which) {
 }
 
 void DivEngine::delInstrumentUnsafe(int index) {
+  invalidateKeyframes();
   if (index>=0 && index<(int)song.ins.size()) {
     for (int i=0; i<song.systemLen; i++) {
       disCont[i].dispatch->notifyInsDeletion(song.ins[index]);
@@ -2882,6 +3151,7 @@ DivWavetable* DivEngine::waveFromFile(const char* path, bool addRaw) {
 }
 
 void DivEngine::delWaveUnsafe(int index) {
+  invalidateKeyframes();
   if (index>=0 && index<(int)song.wave.size()) {
     delete song.wave[index];
     song.wave.erase(song.wave.begin()+index);
@@ -2940,6 +3210,7 @@ int DivEngine::addSamplePtr(DivSample* which) {
 }
 
 void DivEngine::delSampleUnsafe(int index, bool render) {
+  invalidateKeyframes();
   sPreview.sample=-1;
   sPreview.pos=0;
   sPreview.dir=false;
@@ -3044,9 +3315,9 @@ void DivEngine::deepCloneOrder(int pos, bool where) {
       if (curPat[i].data[j]==NULL) {
         int origOrd=order[i];
         order[i]=j;
-        DivPattern* oldPat=curPat[i].getPattern(origOrd,false);
+        const DivPattern* oldPat=curPat[i].getPattern(origOrd,false);
         DivPattern* pat=curPat[i].getPattern(j,true);
-        memcpy(pat->data,oldPat->data,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short));
+        oldPat->data.copyOn(pat->data);
         logD("found at %d",j);
         didNotFind=false;
         break;
@@ -3513,6 +3784,7 @@ void DivEngine::setOrder(unsigned char order) {
 
 void DivEngine::updateSysFlags(int system, bool restart, bool render) {
   BUSY_BEGIN_SOFT;
+  invalidateKeyframes();
   disCont[system].dispatch->setFlags(song.systemFlags[system]);
   disCont[system].setRates(got.rate);
   if (render) renderSamples();
@@ -3539,6 +3811,7 @@ void DivEngine::setSongRate(float hz) {
   saveLock.lock();
   curSubSong->hz=hz;
   divider=curSubSong->hz;
+  invalidateKeyframes();
   saveLock.unlock();
   BUSY_END;
 }
@@ -3587,7 +3860,7 @@ bool DivEngine::switchMaster(bool full) {
   if (initAudioBackend()) {
     for (int i=0; i<song.systemLen; i++) {
       disCont[i].setRates(got.rate);
-      disCont[i].setQuality(lowQuality,dcHiPass);
+      disCont[i].setQuality(lowQuality,dcHiPass,simdBlip);
     }
     if (!output->setRun(true)) {
       logE("error while activating audio!");
@@ -3706,12 +3979,13 @@ void DivEngine::initDispatch(bool isRender) {
   if (isRender) logI("render cores set");
 
   lowQuality=getConfInt("audioQuality",0);
+  simdBlip=getConfInt("audioSIMD",1);
   dcHiPass=getConfInt("audioHiPass",1);
 
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].init(song.system[i],this,getChannelCount(song.system[i]),got.rate,song.systemFlags[i],isRender);
     disCont[i].setRates(got.rate);
-    disCont[i].setQuality(lowQuality,dcHiPass);
+    disCont[i].setQuality(lowQuality,dcHiPass,simdBlip);
   }
   if (song.patchbayAuto) {
     saveLock.lock();
@@ -3725,6 +3999,10 @@ void DivEngine::initDispatch(bool isRender) {
 void DivEngine::quitDispatch() {
   BUSY_BEGIN;
   logV("terminating dispatch...");
+  // keyframes hold dispatch states which must be freed by their dispatch
+  clearKeyframes();
+  invalidateKeyframes();
+  clearPitchTables();
   for (int i=0; i<song.systemLen; i++) {
     disCont[i].quit();
   }
@@ -3805,6 +4083,14 @@ bool DivEngine::initAudioBackend() {
   if (previewVol<0.0f) previewVol=0.0f;
   if (previewVol>1.0f) previewVol=1.0f;
   renderPoolThreads=getConfInt("renderPoolThreads",0);
+  renderPoolLockFree=getConfInt("renderPoolLockFree",0);
+  renderPerBuffer=getConfInt("renderPerBuffer",0);
+  keyframeInterval=getConfInt("seekKeyframeInterval",4);
+  if (keyframeInterval<0) keyframeInterval=0;
+  invalidateKeyframes();
+  int sampleCacheSize=getConfInt("sampleCacheSize",64);
+  if (sampleCacheSize<0) sampleCacheSize=0;
+  sampleCache.setMaxSize((size_t)sampleCacheSize<<20);
 
   if (lowLatency) logI("using low latency mode.");
 
@@ -3894,6 +4180,12 @@ bool DivEngine::initAudioBackend() {
     memset(oscBuf[i],0,32768*sizeof(float));
   }
 
+  // workers render on behalf of the main engine, which owns the MIDI devices
+  if (isWorker) {
+    logV("initAudioBackend done (worker, no MIDI)");
+    return true;
+  }
+
   logI("initializing MIDI.");
   if (output->initMidi(false)) {
     midiIns=output->midiIn->listDevices();
@@ -4018,6 +4310,16 @@ bool DivEngine::preInit(bool noSafeMode) {
   return wantSafe;
 }
 
+void DivEngine::preInitWorker(DivEngine* parent) {
+  // use the configuration and systems of the parent engine
+  conf=parent->conf;
+  configPath=parent->configPath;
+  configLoaded=true;
+  systemsRegistered=true;
+  isWorker=true;
+  setAudio(DIV_AUDIO_DUMMY);
+}
+
 void DivEngine::everythingOK() {
   // TODO: re-enable with a better approach
   // see issue #1581
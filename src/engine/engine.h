@@ -28,14 +28,18 @@
 #include "dataErrors.h"
 #include "safeWriter.h"
 #include "cmdStream.h"
+#include "profiler.h"
+#include "sampleCache.h"
 #include "../audio/taAudio.h"
 #include "blip_buf.h"
+#include <atomic>
 #include <functional>
 #include <initializer_list>
 #include <thread>
 #include "../fixedQueue.h"
 
 class DivWorkPool;
+struct DivStemExport;
 
 #define addWarning(x) \
   if (warnings.empty()) { \
@@ -110,6 +114,7 @@ struct DivAudioExportOptions {
   int chans;
   int loops;
   double fadeOut;
+  int threads;
   int orderBegin, orderEnd;
   bool channelMask[DIV_MAX_CHANS];
   DivAudioExportOptions():
@@ -119,6 +124,7 @@ struct DivAudioExportOptions {
     chans(2),
     loops(0),
     fadeOut(0.0),
+    threads(0),
     orderBegin(-1),
     orderEnd(-1) {
     for (int i=0; i<DIV_MAX_CHANS; i++) {
@@ -233,25 +239,64 @@ struct DivNoteEvent {
     fromMIDI(false) {}
 };
 
+// a MIDI message to be processed at a position (in samples) of the current buffer.
+struct DivMidiInEvent {
+  unsigned int pos;
+  TAMidiMessage msg;
+  DivMidiInEvent(unsigned int p, const TAMidiMessage& m):
+    pos(p),
+    msg(m) {}
+  DivMidiInEvent():
+    pos(0) {}
+};
+
+// a snapshot of playback state taken by playSub() at the start of an order.
+// used to seek without replaying the song from the beginning.
+struct DivPlaybackKeyframe {
+  std::vector<DivChannelState> chan;
+  int systemLen;
+  DivDispatch* dispatch[DIV_MAX_CHIPS];
+  void* dispatchState[DIV_MAX_CHIPS];
+  int subticks, ticks, curRow, curOrder, prevRow, prevOrder, totalLoops, lastLoopPos, nextSpeed, elapsedBars, elapsedBeats, curSpeed;
+  int cycles, midiClockCycles, midiTimeCycles, stepPlay, tickMult, arpLen;
+  int changeOrd, changePos, totalSeconds, totalTicks, totalTicksR, curMidiClock, curMidiTime, globalPitch;
+  int curMidiTimePiece, curMidiTimeCode;
+  double divider, clockDrift, midiClockDrift, midiTimeDrift;
+  unsigned char extValue, pendingMetroTick;
+  bool playing, endOfSong, firstTick, extValuePresent, shallStop, shallStopSched;
+  DivGroovePattern speeds;
+  short virtualTempoN, virtualTempoD, tempoAccum;
+  unsigned char walked[8192];
+};
+
 struct DivDispatchContainer {
   DivDispatch* dispatch;
   blip_buffer_t* bb[DIV_MAX_OUTPUTS];
   size_t bbInLen, runtotal, runLeft, runPos, lastAvail;
+  // rendering a whole buffer at once: everything up to renderedPos has been acquired
+  size_t renderedPos;
+  bool renderDeferred;
   int temp[DIV_MAX_OUTPUTS], prevSample[DIV_MAX_OUTPUTS];
   short* bbInMapped[DIV_MAX_OUTPUTS];
   short* bbIn[DIV_MAX_OUTPUTS];
   short* bbOut[DIV_MAX_OUTPUTS];
-  bool lowQuality, dcOffCompensation, hiPass;
+  bool lowQuality, simdBlip, dcOffCompensation, hiPass;
   double rateMemory;
 
   // used in multi-thread
   int cycles;
   unsigned int size;
 
+  // time spent in the current buffer (in nanoseconds)
+  unsigned int acquireTime, fillBufTime;
+  // whether the above are measured in the current buffer
+  bool profiling;
+
   void setRates(double gotRate);
-  void setQuality(bool lowQual, bool dcHiPass);
+  void setQuality(bool lowQual, bool dcHiPass, bool simd);
   void grow(size_t size);
   void acquire(size_t offset, size_t count);
+  void acquireDeferred();
   void flush(size_t count);
   void fillBuf(size_t runtotal, size_t offset, size_t size);
   void clear();
@@ -264,12 +309,18 @@ struct DivDispatchContainer {
     runLeft(0),
     runPos(0),
     lastAvail(0),
+    renderedPos(0),
+    renderDeferred(false),
     lowQuality(false),
+    simdBlip(true),
     dcOffCompensation(false),
     hiPass(true),
     rateMemory(0.0),
     cycles(0),
-    size(0) {
+    size(0),
+    acquireTime(0),
+    fillBufTime(0),
+    profiling(false) {
     memset(bb,0,DIV_MAX_OUTPUTS*sizeof(blip_buffer_t*));
     memset(temp,0,DIV_MAX_OUTPUTS*sizeof(int));
     memset(prevSample,0,DIV_MAX_OUTPUTS*sizeof(int));
@@ -433,6 +484,7 @@ class DivEngine {
   bool configLoaded;
   bool active;
   bool lowQuality;
+  bool simdBlip;
   bool dcHiPass;
   bool playing;
   bool freelance;
@@ -444,7 +496,7 @@ class DivEngine {
   bool repeatPattern;
   bool metronome;
   bool exporting;
-  bool stopExport;
+  std::atomic<bool> stopExport;
   bool halted;
   bool forceMono;
   bool clampSamples;
@@ -457,6 +509,8 @@ class DivEngine {
   bool lowLatency;
   bool systemsRegistered;
   bool hasLoadedSomething;
+  // set up by preInitWorker(). never touches MIDI devices
+  bool isWorker;
   bool midiOutClock;
   bool midiOutTime;
   bool midiOutProgramChange;
@@ -489,9 +543,15 @@ class DivEngine {
   DivAudioExportFormats exportFormat;
   double exportFadeOut;
   int exportOutputs;
+  int exportThreads;
+  size_t exportFrames;
   bool exportChannelMask[DIV_MAX_CHANS];
   DivConfig conf;
   FixedQueue<DivNoteEvent,8192> pendingNotes;
+  FixedQueue<DivMidiInEvent,8192> midiInEvents;
+  double midiInLastBuf;
+  // time at which MIDI output of the current buffer starts. 0 outside nextBuf().
+  double midiOutBufTime;
   // bitfield
   unsigned char walked[8192];
   bool isMuted[DIV_MAX_CHANS];
@@ -536,6 +596,8 @@ class DivEngine {
   short tremTable[128];
   int reversePitchTable[4096];
   int pitchTable[4096];
+  // frequency tables for every chip clock/divider/pitch mode in use. see getPitchTable().
+  std::atomic<DivPitchTable*> pitchTables[DIV_MAX_PITCH_TABLES];
   short effectSlotMap[4096];
   int midiBaseChan;
   bool midiPoly;
@@ -559,7 +621,17 @@ class DivEngine {
   size_t totalProcessed;
 
   unsigned int renderPoolThreads;
+  bool renderPoolLockFree;
+  bool renderPerBuffer;
   DivWorkPool* renderPool;
+  DivSampleCache sampleCache;
+
+  // seek keyframes
+  std::vector<DivPlaybackKeyframe*> keyframes;
+  std::atomic<unsigned int> songRevision;
+  unsigned int keyframeRevision;
+  size_t keyframeSubSong;
+  int keyframeInterval;
 
   // MIDI stuff
   std::function<int(const TAMidiMessage&)> midiCallback=[](const TAMidiMessage&) -> int {return -2;};
@@ -577,14 +649,34 @@ class DivEngine {
   void recalcChans();
   void reset();
   void playSub(bool preserveDrift, int goalRow=0);
+  bool initStemWorker(DivEngine* parent, unsigned char* songData, size_t songLen);
+  bool exportChanStem(int ch, float** outBuf, float* outBufFinal, std::atomic<bool>* abort);
+  DivPlaybackKeyframe* storeKeyframe();
+  bool restoreKeyframe(DivPlaybackKeyframe* kf);
+  void freeKeyframe(DivPlaybackKeyframe* kf);
+  void clearKeyframes();
   void runMidiClock(int totalCycles=1);
   void runMidiTime(int totalCycles=1);
+  void processMidiIn(TAMidiMessage& msg);
+  void processPendingNotes();
+  // process MIDI input events up to pos. applies notes right away if betweenTicks is true.
+  void runMidiIn(unsigned int pos, bool betweenTicks);
+  // queue a MIDI message stamped with the current buffer position plus offset (in master clock cycles).
+  void sendMidiOut(TAMidiMessage msg, int offset=0);
+  // render chips which are rendered once per buffer up to the current position, if any of them
+  // asks for it (or always if force is true).
+  void flushDeferredRender(bool force);
+  // get the frequency table for these parameters and the current tuning/pitch linearity.
+  // creates it if necessary. returns NULL if there are too many tables already.
+  DivPitchTable* getPitchTable(double clock, double divider, bool period, unsigned char blockBits);
+  void clearPitchTables();
   bool shallSwitchCores();
 
   void testFunction();
 
   bool loadDMF(unsigned char* file, size_t len);
-  bool loadFur(unsigned char* file, size_t len, int variantID=0);
+  // if stream is not NULL, the song is read from it while it's being filled. file must be NULL then.
+  bool loadFur(unsigned char* file, size_t len, int variantID=0, SafeReaderStream* stream=NULL);
   bool loadMod(unsigned char* file, size_t len);
   bool loadS3M(unsigned char* file, size_t len);
   bool loadXM(unsigned char* file, size_t len);
@@ -661,10 +753,14 @@ class DivEngine {
     float oscSize;
     int oscReadPos, oscWritePos;
     int tickMult;
+    // set while ticking chips to start notes from MIDI input between ticks
+    bool midiSubTick;
     int lastNBIns, lastNBOuts, lastNBSize;
     std::atomic<size_t> processTime;
+    DivProfiler profiler;
 
     void runExportThread();
+    void runStemWorker(DivStemExport* job);
     void nextBuf(float** in, float** out, int inChans, int outChans, unsigned int size);
     DivInstrument* getIns(int index, DivInstrumentType fallbackType=DIV_INS_FM);
     DivWavetable* getWave(int index);
@@ -712,10 +808,18 @@ class DivEngine {
     bool haltAudioFile();
     // return back to playback cores if necessary
     void finishAudioFile();
+    // get the number of frames written by the last audio export (across all files in per-channel mode)
+    size_t getExportedFrames();
+    // set up this instance to render on behalf of another one (same configuration, dummy audio)
+    void preInitWorker(DivEngine* parent);
     // notify instrument parameter change
     void notifyInsChange(int ins);
     // notify wavetable change
     void notifyWaveChange(int wave);
+    // notify tuning or pitch linearity change
+    void notifyPitchTable();
+    // invalidate the seek keyframe cache. call after editing the song.
+    void invalidateKeyframes();
 
     // dispatch a command
     int dispatchCmd(DivCommand c);
@@ -773,13 +877,15 @@ class DivEngine {
     void factoryReset();
 
     // calculate base frequency/period
-    double calcBaseFreq(double clock, double divider, int note, bool period);
+    // set cached to false if the divider depends on the sample rate (or is otherwise unbounded).
+    double calcBaseFreq(double clock, double divider, int note, bool period, bool cached=true);
 
     // calculate base frequency in f-num/block format
     int calcBaseFreqFNumBlock(double clock, double divider, int note, int bits);
 
     // calculate frequency/period
-    int calcFreq(int base, int pitch, int arp, bool arpFixed, bool period=false, int octave=0, int pitch2=0, double clock=1.0, double divider=1.0, int blockBits=0);
+    // see calcBaseFreq() for cached.
+    int calcFreq(int base, int pitch, int arp, bool arpFixed, bool period=false, int octave=0, int pitch2=0, double clock=1.0, double divider=1.0, int blockBits=0, bool cached=true);
 
     // calculate arpeggio
     int calcArp(int note, int arp, int offset=0);
@@ -1116,6 +1222,9 @@ class DivEngine {
     // get osc buffer
     DivDispatchOscBuffer* getOscBuffer(int chan);
 
+    // enable or disable writing to the osc buffers of all chips
+    void setOscBuffersEnabled(bool enable);
+
     // enable command stream dumping
     void enableCommandStream(bool enable);
 
@@ -1189,6 +1298,9 @@ class DivEngine {
     // >=0: render specific sample
     void renderSamplesP(int whichSample=-1);
 
+    // empty the sample render cache and mark all samples as not rendered
+    void clearSampleCache();
+
     // public swap channels
     void swapChannelsP(int src, int dest);
 
@@ -1324,6 +1436,7 @@ class DivEngine {
       configLoaded(false),
       active(false),
       lowQuality(false),
+      simdBlip(true),
       dcHiPass(true),
       playing(false),
       freelance(false),
@@ -1348,6 +1461,7 @@ class DivEngine {
       lowLatency(false),
       systemsRegistered(false),
       hasLoadedSomething(false),
+      isWorker(false),
       midiOutClock(false),
       midiOutTime(false),
       midiOutProgramChange(false),
@@ -1404,6 +1518,10 @@ class DivEngine {
       exportFormat(DIV_EXPORT_FORMAT_S16),
       exportFadeOut(0.0),
       exportOutputs(2),
+      exportThreads(0),
+      exportFrames(0),
+      midiInLastBuf(0.0),
+      midiOutBufTime(0.0),
       cmdStreamInt(NULL),
       midiBaseChan(0),
       midiPoly(true),
@@ -1426,7 +1544,13 @@ class DivEngine {
       previewVol(1.0f),
       totalProcessed(0),
       renderPoolThreads(0),
+      renderPoolLockFree(false),
+      renderPerBuffer(false),
       renderPool(NULL),
+      songRevision(0),
+      keyframeRevision(0),
+      keyframeSubSong(0),
+      keyframeInterval(4),
       curOrders(NULL),
       curPat(NULL),
       tempIns(NULL),
@@ -1434,6 +1558,7 @@ class DivEngine {
       oscReadPos(0),
       oscWritePos(0),
       tickMult(1),
+      midiSubTick(false),
       lastNBIns(0),
       lastNBOuts(0),
       lastNBSize(0),
@@ -1451,16 +1576,16 @@ class DivEngine {
       memset(tremTable,0,128*sizeof(short));
       memset(reversePitchTable,0,4096*sizeof(int));
       memset(pitchTable,0,4096*sizeof(int));
+      for (int i=0; i<DIV_MAX_PITCH_TABLES; i++) {
+        pitchTables[i]=NULL;
+      }
       memset(effectSlotMap,-1,4096*sizeof(short));
-      memset(sysDefs,0,DIV_MAX_CHIP_DEFS*sizeof(void*));
       memset(walked,0,8192);
       memset(oscBuf,0,DIV_MAX_OUTPUTS*(sizeof(float*)));
       memset(exportChannelMask,1,DIV_MAX_CHANS*sizeof(bool));
 
-      for (int i=0; i<DIV_MAX_CHIP_DEFS; i++) {
-        sysFileMapFur[i]=DIV_SYSTEM_NULL;
-        sysFileMapDMF[i]=DIV_SYSTEM_NULL;
-      }
+      // sysDefs and the file maps are static (zero-initialized) and shared
+      // with other instances such as stem export workers, so leave them alone
 
       changeSong(0);
     }
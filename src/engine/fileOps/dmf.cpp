@@ -1287,7 +1287,7 @@ SafeWriter* DivEngine::saveDMF(unsigned char version) {
     for (int j=0; j<curSubSong->ordersLen; j++) {
       w->writeC(curOrders->ord[i][j]);
       if (version>=25) {
-        DivPattern* pat=curPat[i].getPattern(j,false);
+        const DivPattern* pat=curPat[i].getPattern(j,false);
         w->writeString(pat->name,true);
       }
     }
@@ -1573,7 +1573,7 @@ SafeWriter* DivEngine::saveDMF(unsigned char version) {
     w->writeC(curPat[i].effectCols);
 
     for (int j=0; j<curSubSong->ordersLen; j++) {
-      DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][j],false);
+      const DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][j],false);
       for (int k=0; k<curSubSong->patLen; k++) {
         if ((pat->data[k][0]==101 || pat->data[k][0]==102) && pat->data[k][1]==0) {
           w->writeS(100);
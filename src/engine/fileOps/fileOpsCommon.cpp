@@ -19,6 +19,37 @@
 
 #include "fileOpsCommon.h"
 
+// inflates into the stream until the current block is full or the data ends.
+// pos is the amount of data written so far.
+static int _inflateBlock(SafeReaderStream* stream, z_stream* zl, size_t& pos) {
+  size_t offset=pos&(SAFEREADER_BLOCK_SIZE-1);
+  unsigned char* block=(offset==0)?stream->addBlock():stream->getBlock(pos>>SAFEREADER_BLOCK_BITS);
+  zl->next_out=block+offset;
+  zl->avail_out=SAFEREADER_BLOCK_SIZE-offset;
+  int ret=inflate(zl,Z_SYNC_FLUSH);
+  pos+=(SAFEREADER_BLOCK_SIZE-offset)-zl->avail_out;
+  return ret;
+}
+
+// decompresses the rest of the file in another thread, publishing each block as it is done.
+static void _inflateStream(SafeReaderStream* stream, z_stream* zl, size_t pos) {
+  int nextErr=Z_OK;
+  while (nextErr==Z_OK) {
+    nextErr=_inflateBlock(stream,zl,pos);
+    stream->publish(pos);
+  }
+  if (nextErr!=Z_STREAM_END) {
+    if (zl->msg==NULL) {
+      logE("error while decompressing! %d",nextErr);
+    } else {
+      logE("error while decompressing! %s",zl->msg);
+    }
+  }
+  inflateEnd(zl);
+  delete zl;
+  stream->finish(nextErr!=Z_STREAM_END);
+}
+
 bool DivEngine::load(unsigned char* f, size_t slen, const char* nameHint) {
   unsigned char* file;
   size_t len;
@@ -47,99 +78,125 @@ bool DivEngine::load(unsigned char* f, size_t slen, const char* nameHint) {
   }
 
   // step 1: try loading as a zlib-compressed file
+  // the first block is inflated here to tell whether this is zlib at all. the rest is inflated
+  // in another thread, so that the file can be parsed while it is being decompressed.
   logD("trying zlib...");
+  SafeReaderStream* stream=NULL;
+  std::thread* inflateThread=NULL;
   try {
-    z_stream zl;
-    memset(&zl,0,sizeof(z_stream));
+    z_stream* zl=new z_stream;
+    memset(zl,0,sizeof(z_stream));
 
-    zl.avail_in=slen;
-    zl.next_in=(Bytef*)f;
-    zl.zalloc=NULL;
-    zl.zfree=NULL;
-    zl.opaque=NULL;
+    zl->avail_in=slen;
+    zl->next_in=(Bytef*)f;
+    zl->zalloc=NULL;
+    zl->zfree=NULL;
+    zl->opaque=NULL;
 
     int nextErr;
-    nextErr=inflateInit(&zl);
+    nextErr=inflateInit(zl);
     if (nextErr!=Z_OK) {
-      if (zl.msg==NULL) {
+      if (zl->msg==NULL) {
         logD("zlib error: unknown! %d",nextErr);
       } else {
-        logD("zlib error: %s",zl.msg);
+        logD("zlib error: %s",zl->msg);
       }
-      inflateEnd(&zl);
+      inflateEnd(zl);
+      delete zl;
       lastError="not a .dmf/.fur song";
       throw NotZlibException(0);
     }
 
-    std::vector<InflateBlock*> blocks;
-    while (true) {
-      InflateBlock* ib=new InflateBlock(DIV_READ_SIZE);
-      zl.next_out=ib->buf;
-      zl.avail_out=ib->len;
-
-      nextErr=inflate(&zl,Z_SYNC_FLUSH);
-      if (nextErr!=Z_OK && nextErr!=Z_STREAM_END) {
-        if (zl.msg==NULL) {
-          logD("zlib error: unknown error! %d",nextErr);
-          lastError="unknown decompression error";
-        } else {
-          logD("zlib inflate: %s",zl.msg);
-          lastError=fmt::sprintf("decompression error: %s",zl.msg);
-        }
-        for (InflateBlock* i: blocks) delete i;
-        blocks.clear();
-        delete ib;
-        inflateEnd(&zl);
-        throw NotZlibException(0);
-      }
-      ib->blockSize=ib->len-zl.avail_out;
-      blocks.push_back(ib);
-      if (nextErr==Z_STREAM_END) {
-        break;
-      }
-    }
-    nextErr=inflateEnd(&zl);
-    if (nextErr!=Z_OK) {
-      if (zl.msg==NULL) {
-        logD("zlib end error: unknown error! %d",nextErr);
-        lastError="unknown decompression finish error";
+    stream=new SafeReaderStream;
+    size_t pos=0;
+    nextErr=_inflateBlock(stream,zl,pos);
+    if (nextErr!=Z_OK && nextErr!=Z_STREAM_END) {
+      if (zl->msg==NULL) {
+        logD("zlib error: unknown error! %d",nextErr);
+        lastError="unknown decompression error";
       } else {
-        logD("zlib end: %s",zl.msg);
-        lastError=fmt::sprintf("decompression finish error: %s",zl.msg);
+        logD("zlib inflate: %s",zl->msg);
+        lastError=fmt::sprintf("decompression error: %s",zl->msg);
       }
-      for (InflateBlock* i: blocks) delete i;
-      blocks.clear();
+      inflateEnd(zl);
+      delete zl;
+      delete stream;
+      stream=NULL;
       throw NotZlibException(0);
     }
-
-    size_t finalSize=0;
-    size_t curSeek=0;
-    for (InflateBlock* i: blocks) {
-      finalSize+=i->blockSize;
-    }
-    if (finalSize<1) {
+    if (pos<1) {
       logD("compressed too small!");
       lastError="file too small";
-      for (InflateBlock* i: blocks) delete i;
-      blocks.clear();
+      inflateEnd(zl);
+      delete zl;
+      delete stream;
+      stream=NULL;
       throw NotZlibException(0);
     }
-    file=new unsigned char[finalSize];
-    for (InflateBlock* i: blocks) {
-      memcpy(&file[curSeek],i->buf,i->blockSize);
-      curSeek+=i->blockSize;
-      delete i;
+    stream->publish(pos);
+    if (nextErr==Z_STREAM_END) {
+      inflateEnd(zl);
+      delete zl;
+      stream->finish();
+    } else {
+      // this thread deletes zl when it's done
+      inflateThread=new std::thread(_inflateStream,stream,zl,pos);
     }
-    blocks.clear();
-    len=finalSize;
-    delete[] f;
   } catch (NotZlibException& e) {
     logD("not zlib. loading as raw...");
+  }
+
+  // step 2: try loading as .fur or .dmf
+  if (stream!=NULL) {
+    // .fur files are parsed while being decompressed
+    bool done=false;
+    size_t filled=stream->waitFor(21,done);
+    if (filled>=16) {
+      const unsigned char* header=stream->getBlock(0);
+      int variantID=-1;
+      if (memcmp(header,DIV_FUR_MAGIC,16)==0) {
+        variantID=DIV_FUR_VARIANT_VANILLA;
+      } else if (memcmp(header,DIV_FUR_MAGIC_DS0,16)==0) {
+        variantID=DIV_FUR_VARIANT_B;
+      }
+      if (variantID>=0) {
+        bool ret=loadFur(NULL,0,variantID,stream);
+        if (inflateThread!=NULL) {
+          inflateThread->join();
+          delete inflateThread;
+        }
+        if (!ret && stream->hasFailed()) {
+          lastError="decompression error";
+        }
+        delete stream;
+        delete[] f;
+        return ret;
+      }
+    }
+
+    // everything else is parsed afterwards
+    if (inflateThread!=NULL) {
+      inflateThread->join();
+      delete inflateThread;
+    }
+    if (stream->hasFailed()) {
+      // not zlib after all
+      logD("not zlib. loading as raw...");
+      lastError="decompression error";
+      delete stream;
+      stream=NULL;
+    } else {
+      len=stream->waitFor(SIZE_MAX,done);
+      file=stream->flatten();
+      delete stream;
+      delete[] f;
+    }
+  }
+  if (stream==NULL) {
     file=f;
     len=slen;
   }
 
-  // step 2: try loading as .fur or .dmf
   if (memcmp(file,DIV_DMF_MAGIC,16)==0) {
     return loadDMF(file,len); 
   } else if (memcmp(file,DIV_FTM_MAGIC,18)==0) {
@@ -160,7 +217,7 @@ bool DivEngine::load(unsigned char* f, size_t slen, const char* nameHint) {
   if (extS==".tfe") {
     return loadTFMv1(file,len);
   } else if (loadMod(file,len)) {
-    delete[] f;
+    delete[] file;
     return true;
   }
   
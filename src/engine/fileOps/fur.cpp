@@ -18,6 +18,7 @@
  */
 
 #include "fileOpsCommon.h"
+#include "../workPool.h"
 
 short newFormatNotes[180]={
   12, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, // -5
@@ -691,7 +692,43 @@ void DivEngine::convertOldFlags(unsigned int oldFlags, DivConfig& newFlags, DivS
   }
 }
 
-bool DivEngine::loadFur(unsigned char* file, size_t len, int variantID) {
+struct DivSampleReadJob {
+  DivSample* sample;
+  SafeReader reader;
+  short version;
+  DivDataErrors result;
+  bool endOfFile;
+  DivSampleReadJob(DivSample* s, const SafeReader& r, short v):
+    sample(s),
+    reader(r),
+    version(v),
+    result(DIV_DATA_SUCCESS),
+    endOfFile(false) {}
+};
+
+struct DivSampleReadQueue {
+  std::vector<DivSampleReadJob>* jobs;
+  std::atomic<size_t>* next;
+  DivSampleReadQueue(std::vector<DivSampleReadJob>* j, std::atomic<size_t>* n):
+    jobs(j),
+    next(n) {}
+};
+
+static void _readSampleQueue(void* q) {
+  DivSampleReadQueue* queue=(DivSampleReadQueue*)q;
+  while (true) {
+    size_t next=queue->next->fetch_add(1);
+    if (next>=queue->jobs->size()) break;
+    DivSampleReadJob& job=(*queue->jobs)[next];
+    try {
+      job.result=job.sample->readSampleData(job.reader,job.version);
+    } catch (EndOfFileException& e) {
+      job.endOfFile=true;
+    }
+  }
+}
+
+bool DivEngine::loadFur(unsigned char* file, size_t len, int variantID, SafeReaderStream* stream) {
   unsigned int insPtr[256];
   unsigned int wavePtr[256];
   unsigned int samplePtr[256];
@@ -702,7 +739,7 @@ bool DivEngine::loadFur(unsigned char* file, size_t len, int variantID) {
   int numberOfSubSongs=0;
   char magic[5];
   memset(magic,0,5);
-  SafeReader reader=SafeReader(file,len);
+  SafeReader reader=(stream==NULL)?SafeReader(file,len):SafeReader(stream);
   warnings="";
   assetDirPtr[0]=0;
   assetDirPtr[1]=0;
@@ -1672,7 +1709,10 @@ bool DivEngine::loadFur(unsigned char* file, size_t len, int variantID) {
     }
 
     // read samples
+    // each sample gets its own reader, so they can be read in parallel
     ds.sample.reserve(ds.sampleLen);
+    std::vector<DivSampleReadJob> sampleJobs;
+    sampleJobs.reserve(ds.sampleLen);
     for (int i=0; i<ds.sampleLen; i++) {
       DivSample* sample=new DivSample;
 
@@ -1685,15 +1725,33 @@ bool DivEngine::loadFur(unsigned char* file, size_t len, int variantID) {
         return false;
       }
 
-      if (sample->readSampleData(reader,ds.version)!=DIV_DATA_SUCCESS) {
+      ds.sample.push_back(sample);
+      sampleJobs.push_back(DivSampleReadJob(sample,reader,ds.version));
+    }
+
+    unsigned int threads=std::thread::hardware_concurrency();
+    if (threads>sampleJobs.size()) threads=sampleJobs.size();
+    std::atomic<size_t> nextSampleJob(0);
+    DivSampleReadQueue sampleQueue(&sampleJobs,&nextSampleJob);
+    if (threads>1) {
+      DivWorkPool* pool=new DivWorkPool(threads);
+      for (unsigned int i=0; i<threads; i++) {
+        pool->push(_readSampleQueue,&sampleQueue);
+      }
+      pool->wait();
+      delete pool;
+    } else {
+      _readSampleQueue(&sampleQueue);
+    }
+
+    for (DivSampleReadJob& i: sampleJobs) {
+      if (i.endOfFile) throw EndOfFileException(&reader,reader.size());
+      if (i.result!=DIV_DATA_SUCCESS) {
         lastError="invalid sample header/data!";
         ds.unload();
-        delete sample;
         delete[] file;
         return false;
       }
-
-      ds.sample.push_back(sample);
     }
 
     // read patterns
@@ -2557,7 +2615,7 @@ SafeWriter* DivEngine::saveFur(bool notPrimary, bool newPatternFormat) {
   /// PATTERN
   patPtr.reserve(patsToWrite.size());
   for (PatToWrite& i: patsToWrite) {
-    DivPattern* pat=song.subsong[i.subsong]->pat[i.chan].getPattern(i.pat,false);
+    const DivPattern* pat=song.subsong[i.subsong]->pat[i.chan].getPattern(i.pat,false);
     patPtr.push_back(w->tell());
 
     if (newPatternFormat) {
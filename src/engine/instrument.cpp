@@ -25,6 +25,52 @@
 
 const DivInstrument defaultIns;
 
+static const int emptyMacroData[256]={0};
+
+const int* DivInstrumentMacroData::empty() {
+  return emptyMacroData;
+}
+
+int* DivInstrumentMacroData::alloc() {
+  int* newData=new int[256];
+  memset(newData,0,256*sizeof(int));
+  // another thread may have allocated it meanwhile
+  int* expected=NULL;
+  if (!data.compare_exchange_strong(expected,newData,std::memory_order_acq_rel)) {
+    delete[] newData;
+    return expected;
+  }
+  return newData;
+}
+
+size_t DivInstrumentMacroData::getMemUsage() const {
+  return sizeof(DivInstrumentMacroData)+((data.load(std::memory_order_relaxed)==NULL)?0:256*sizeof(int));
+}
+
+DivInstrumentMacroData& DivInstrumentMacroData::operator=(const DivInstrumentMacroData& other) {
+  if (this==&other) return *this;
+  const int* src=other.data.load(std::memory_order_acquire);
+  int* dest=data.load(std::memory_order_acquire);
+  if (src==NULL) {
+    // don't free. the values may still be in use
+    if (dest!=NULL) memset(dest,0,256*sizeof(int));
+    return *this;
+  }
+  if (dest==NULL) dest=alloc();
+  memcpy(dest,src,256*sizeof(int));
+  return *this;
+}
+
+DivInstrumentMacroData::DivInstrumentMacroData(const DivInstrumentMacroData& other):
+  data(NULL) {
+  *this=other;
+}
+
+DivInstrumentMacroData::~DivInstrumentMacroData() {
+  int* oldData=data.load();
+  if (oldData!=NULL) delete[] oldData;
+}
+
 #define _C(x) x==other.x
 
 bool DivInstrumentFM::operator==(const DivInstrumentFM& other) {
@@ -2260,7 +2306,7 @@ DivDataErrors DivInstrument::readInsDataNew(SafeReader& reader, short version, b
 
   // <187 C64 cutoff macro compatibility
   if (type==DIV_INS_C64 && volIsCutoff && version<187) {
-    memcpy(&std.algMacro,&std.volMacro,sizeof(DivInstrumentMacro));
+    std.algMacro=std.volMacro;
     std.algMacro.macroType=DIV_MACRO_ALG;
     std.volMacro=DivInstrumentMacro(DIV_MACRO_VOL,true);
 
@@ -3019,7 +3065,7 @@ DivDataErrors DivInstrument::readInsDataOld(SafeReader &reader, short version) {
 
   // <187 C64 cutoff macro compatibility
   if (type==DIV_INS_C64 && volIsCutoff && version<187) {
-    memcpy(&std.algMacro,&std.volMacro,sizeof(DivInstrumentMacro));
+    std.algMacro=std.volMacro;
     std.algMacro.macroType=DIV_MACRO_ALG;
     std.volMacro=DivInstrumentMacro(DIV_MACRO_VOL,true);
 
@@ -23,6 +23,7 @@
 #include "dataErrors.h"
 #include "../ta-utils.h"
 #include "../pch.h"
+#include <atomic>
 
 struct DivSong;
 
@@ -251,9 +252,61 @@ struct DivInstrumentFM {
   }
 };
 
+/**
+ * storage of macro values. use it like an array of 256 ints.
+ * the values are allocated on first non-const access. until then, all of them read as 0
+ * and every empty macro shares the same buffer.
+ * the buffer is only freed when the macro is destroyed, so it may be read while being edited.
+ */
+struct DivInstrumentMacroData {
+  std::atomic<int*> data;
+
+  int* alloc();
+  static const int* empty();
+
+  inline int* get() {
+    int* ret=data.load(std::memory_order_acquire);
+    if (ret==NULL) ret=alloc();
+    return ret;
+  }
+
+  inline const int* get() const {
+    const int* ret=data.load(std::memory_order_acquire);
+    if (ret==NULL) ret=empty();
+    return ret;
+  }
+
+  template<typename T> inline int& operator[](T pos) {
+    return get()[pos];
+  }
+
+  template<typename T> inline const int& operator[](T pos) const {
+    return get()[pos];
+  }
+
+  inline operator int*() {
+    return get();
+  }
+
+  inline operator const int*() const {
+    return get();
+  }
+
+  /**
+   * get the amount of memory used by the values.
+   */
+  size_t getMemUsage() const;
+
+  DivInstrumentMacroData& operator=(const DivInstrumentMacroData& other);
+  DivInstrumentMacroData(const DivInstrumentMacroData& other);
+  DivInstrumentMacroData():
+    data(NULL) {}
+  ~DivInstrumentMacroData();
+};
+
 // this is getting out of hand
 struct DivInstrumentMacro {
-  int val[256];
+  DivInstrumentMacroData val;
   unsigned int mode;
   unsigned char open;
   unsigned char len, delay, speed, loop, rel;
@@ -278,7 +331,6 @@ struct DivInstrumentMacro {
     vScroll(0),
     vZoom(-1),
     lenMemory(0) {
-    memset(val,0,256*sizeof(int));
     memset(typeMemory,0,16*sizeof(int));
   }
 };
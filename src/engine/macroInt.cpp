@@ -38,7 +38,7 @@
 #define LFO_LOOP source.val[14]
 #define LFO_GLOBAL source.val[15]
 
-void DivMacroStruct::prepare(DivInstrumentMacro& source, DivEngine* e) {
+void DivMacroStruct::prepare(const DivInstrumentMacro& source, DivEngine* e) {
   has=had=actualHad=will=true;
   mode=source.mode;
   type=(source.open>>1)&3;
@@ -47,7 +47,7 @@ void DivMacroStruct::prepare(DivInstrumentMacro& source, DivEngine* e) {
   lfoPos=LFO_PHASE;
 }
 
-void DivMacroStruct::doMacro(DivInstrumentMacro& source, bool released, bool tick) {
+void DivMacroStruct::doMacro(const DivInstrumentMacro& source, bool released, bool tick) {
   if (!tick) {
     had=false;
     return;
@@ -174,16 +174,48 @@ void DivMacroStruct::doMacro(DivInstrumentMacro& source, bool released, bool tic
   }
 }
 
+void DivMacroInt::activate(DivMacroStruct* which) {
+  for (size_t i=0; i<macroListLen; i++) {
+    if (macroList[i]!=which) continue;
+    if (!macroActive[i]) {
+      activeList[activeLen]=macroList[i];
+      activeSource[activeLen]=macroSource[i];
+      activeIndex[activeLen++]=i;
+      macroActive[i]=true;
+    }
+    return;
+  }
+}
+
+void DivMacroInt::runActive(bool tick, bool onlyBegan) {
+  for (size_t i=0; i<activeLen;) {
+    DivMacroStruct* m=activeList[i];
+    bool doTick=onlyBegan?m->began:tick;
+    m->doMacro(*activeSource[i],released,doTick);
+    // drop macros which are done
+    if (doTick && m->idle()) {
+      macroActive[activeIndex[i]]=false;
+      activeLen--;
+      activeList[i]=activeList[activeLen];
+      activeSource[i]=activeSource[activeLen];
+      activeIndex[i]=activeIndex[activeLen];
+      continue;
+    }
+    i++;
+  }
+}
+
 void DivMacroInt::next() {
   if (ins==NULL) return;
+  // a note was started between ticks (MIDI input).
+  // only start the macros of new notes, leaving the rest and the tick count alone.
+  if (e!=NULL && e->midiSubTick) {
+    runActive(false,true);
+    return;
+  }
   // run macros
-  // TODO: potentially get rid of list to avoid allocations
   subTick--;
-  for (size_t i=0; i<macroListLen; i++) {
-    if (macroList[i]!=NULL && macroSource[i]!=NULL) {
-      macroList[i]->doMacro(*macroSource[i],released,subTick==0);
-    }
-  }
+  runActive(subTick==0,false);
   if (subTick<=0) {
     if (e==NULL) {
       subTick=1;
@@ -196,6 +228,7 @@ void DivMacroInt::next() {
 #define CONSIDER(x,y) \
   case y: \
     x.masked=enabled; \
+    if (!enabled) activate(&x); \
     break;
 
 #define CONSIDER_OP(oi,o) \
@@ -283,7 +316,7 @@ void DivMacroInt::mask(unsigned char id, bool enabled) {
 
 void DivMacroInt::restart(unsigned char id) {
   DivMacroStruct* macroState=NULL;
-  DivInstrumentMacro* macro=NULL;
+  const DivInstrumentMacro* macro=NULL;
 
   if (e==NULL) return;
   if (ins==NULL) return;
@@ -323,6 +356,7 @@ void DivMacroInt::restart(unsigned char id) {
 
   macroState->init();
   macroState->prepare(*macro,e);
+  activate(macroState);
 }
 
 #undef CONSIDER_OP
@@ -347,8 +381,10 @@ void DivMacroInt::init(DivInstrument* which) {
   // initialize
   for (size_t i=0; i<macroListLen; i++) {
     if (macroList[i]!=NULL) macroList[i]->init();
+    macroActive[i]=false;
   }
   macroListLen=0;
+  activeLen=0;
   subTick=1;
 
   hasRelease=false;
@@ -489,6 +525,10 @@ void DivMacroInt::init(DivInstrument* which) {
   for (size_t i=0; i<macroListLen; i++) {
     if (macroSource[i]!=NULL) {
       macroList[i]->prepare(*macroSource[i],e);
+      activeList[activeLen]=macroList[i];
+      activeSource[activeLen]=macroSource[i];
+      activeIndex[activeLen++]=i;
+      macroActive[i]=true;
       // check ADSR mode
       if ((macroSource[i]->open&6)==2) {
         if (macroSource[i]->val[8]>0) {
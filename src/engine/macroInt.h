@@ -30,7 +30,7 @@ struct DivMacroStruct {
   bool has, had, actualHad, finished, will, linger, began, masked, activeRelease;
   unsigned int mode, type;
   unsigned char macroType;
-  void doMacro(DivInstrumentMacro& source, bool released, bool tick);
+  void doMacro(const DivInstrumentMacro& source, bool released, bool tick);
   void init() {
     pos=lastPos=lfoPos=mode=type=delay=0;
     has=had=actualHad=will=false;
@@ -39,7 +39,14 @@ struct DivMacroStruct {
     // TODO: test whether this breaks anything?
     val=0;
   }
-  void prepare(DivInstrumentMacro& source, DivEngine* e);
+  void prepare(const DivInstrumentMacro& source, DivEngine* e);
+  /**
+   * whether further ticks would not change this macro's state.
+   * a macro in this state can be left out of the tick loop until it is restarted or unmasked.
+   */
+  inline bool idle() {
+    return !has && !had && (masked || (!actualHad && !finished));
+  }
   DivMacroStruct(unsigned char mType):
     pos(0),
     lastPos(0),
@@ -64,10 +71,19 @@ class DivMacroInt {
   DivEngine* e;
   DivInstrument* ins;
   DivMacroStruct* macroList[128];
-  DivInstrumentMacro* macroSource[128];
+  const DivInstrumentMacro* macroSource[128];
   size_t macroListLen;
+  // running macros (indices into macroList), in separate arrays for the tick loop
+  DivMacroStruct* activeList[128];
+  const DivInstrumentMacro* activeSource[128];
+  unsigned char activeIndex[128];
+  bool macroActive[128];
+  size_t activeLen;
   int subTick;
   bool released;
+
+  void activate(DivMacroStruct* which);
+  void runActive(bool tick, bool onlyBegan);
   public:
     // common macro
     DivMacroStruct vol;
@@ -158,6 +174,7 @@ class DivMacroInt {
       e(NULL),
       ins(NULL),
       macroListLen(0),
+      activeLen(0),
       subTick(1),
       released(false),
       vol(DIV_MACRO_VOL),
@@ -183,6 +200,10 @@ class DivMacroInt {
       hasRelease(false) {
       memset(macroList,0,128*sizeof(void*));
       memset(macroSource,0,128*sizeof(void*));
+      memset(activeList,0,128*sizeof(void*));
+      memset(activeSource,0,128*sizeof(void*));
+      memset(activeIndex,0,128);
+      memset(macroActive,0,128*sizeof(bool));
     }
 };
 
@@ -0,0 +1,166 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "memoryPacker.h"
+#include "../ta-log.h"
+#include <algorithm>
+#include <unordered_map>
+#include <string.h>
+
+size_t DivMemoryPacker::alignLen(size_t len) {
+  return ((len+memAlign-1)/memAlign)*memAlign;
+}
+
+size_t DivMemoryPacker::bankBegin(int bank) {
+  if (memBank==0) return alignLen(memStart);
+  return alignLen(MAX(memStart,(size_t)bank*memBank));
+}
+
+size_t DivMemoryPacker::bankEnd(int bank) {
+  if (memBank==0) return memCapacity;
+  return MIN(memCapacity,(size_t)(bank+1)*memBank);
+}
+
+void DivMemoryPacker::init(size_t start, size_t capacity, size_t align, size_t bankSize) {
+  items.clear();
+  bankFill.clear();
+  memStart=start;
+  memCapacity=capacity;
+  memAlign=MAX(align,1);
+  memBank=bankSize;
+  memUsed=start;
+  dupSaved=0;
+}
+
+int DivMemoryPacker::add(int asset, const unsigned char* data, size_t len) {
+  items.push_back(DivMemoryPackerItem(asset,data,len));
+  return (int)items.size()-1;
+}
+
+bool DivMemoryPacker::pack() {
+  // find duplicates
+  std::unordered_multimap<unsigned long long,int> seen;
+  std::vector<int> order;
+  for (size_t i=0; i<items.size(); i++) {
+    DivMemoryPackerItem& item=items[i];
+    item.placed=false;
+    item.bank=-1;
+    item.dupOf=-1;
+    if (item.len==0) continue;
+    unsigned long long hash=14695981039346656037ULL^item.len;
+    for (size_t j=0; j<item.len; j++) {
+      hash=(hash^item.data[j])*1099511628211ULL;
+    }
+    auto range=seen.equal_range(hash);
+    for (auto j=range.first; j!=range.second; j++) {
+      const DivMemoryPackerItem& other=items[j->second];
+      if (other.len==item.len && memcmp(other.data,item.data,item.len)==0) {
+        item.dupOf=j->second;
+        break;
+      }
+    }
+    if (item.dupOf>=0) continue;
+    seen.emplace(hash,(int)i);
+    order.push_back(i);
+  }
+
+  // give items to banks
+  int bankCount=1;
+  if (memBank>0) {
+    bankCount=(memCapacity+memBank-1)/memBank;
+    std::stable_sort(order.begin(),order.end(),[this](int a, int b) {
+      return items[a].len>items[b].len;
+    });
+  }
+  bankFill.assign(bankCount,0);
+  bool allPlaced=true;
+  for (int i: order) {
+    DivMemoryPackerItem& item=items[i];
+    size_t len=alignLen(item.len);
+    for (int j=0; j<bankCount; j++) {
+      if (bankBegin(j)+bankFill[j]+len<=bankEnd(j)) {
+        item.bank=j;
+        item.placed=true;
+        bankFill[j]+=len;
+        break;
+      }
+    }
+    if (!item.placed) allPlaced=false;
+  }
+
+  // place them
+  std::vector<size_t> bankPos;
+  for (int i=0; i<bankCount; i++) {
+    bankPos.push_back(bankBegin(i));
+  }
+  memUsed=memStart;
+  dupSaved=0;
+  for (DivMemoryPackerItem& item: items) {
+    if (item.dupOf>=0) {
+      const DivMemoryPackerItem& other=items[item.dupOf];
+      item.pos=other.pos;
+      item.bank=other.bank;
+      item.placed=other.placed;
+      if (item.placed) dupSaved+=alignLen(item.len);
+      continue;
+    }
+    if (!item.placed) continue;
+    item.pos=bankPos[item.bank];
+    bankPos[item.bank]+=alignLen(item.len);
+    if (item.pos+item.len>memUsed) memUsed=item.pos+item.len;
+  }
+
+  return allPlaced;
+}
+
+const DivMemoryPackerItem& DivMemoryPacker::get(int index) {
+  return items[index];
+}
+
+size_t DivMemoryPacker::getItemCount() {
+  return items.size();
+}
+
+size_t DivMemoryPacker::getUsed() {
+  return memUsed;
+}
+
+size_t DivMemoryPacker::getDupSaved() {
+  return dupSaved;
+}
+
+void DivMemoryPacker::fillCompo(DivMemoryComposition& compo, DivMemoryEntryType type) {
+  for (DivMemoryPackerItem& item: items) {
+    if (!item.placed) continue;
+    compo.entries.push_back(DivMemoryEntry(type,"Sample",item.asset,item.pos,item.pos+item.len));
+  }
+  fillCompoGaps(compo);
+}
+
+void DivMemoryPacker::fillCompoGaps(DivMemoryComposition& compo) {
+  if (memBank==0) return;
+  for (int i=0; i<(int)bankFill.size(); i++) {
+    size_t end=bankBegin(i)+bankFill[i];
+    // only banks before the end of used memory count
+    if (end>=memUsed) break;
+    if (end<bankEnd(i)) {
+      compo.entries.push_back(DivMemoryEntry(DIV_MEMORY_PADDING,"Gap",-1,end,bankEnd(i)));
+    }
+  }
+}
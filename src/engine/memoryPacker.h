@@ -0,0 +1,122 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _MEMORYPACKER_H
+#define _MEMORYPACKER_H
+
+#include "dispatch.h"
+
+struct DivMemoryPackerItem {
+  int asset;
+  const unsigned char* data;
+  size_t len;
+  // results of pack()
+  size_t pos;
+  int bank;
+  // index of the item this one shares its data with, or -1
+  int dupOf;
+  bool placed;
+
+  DivMemoryPackerItem(int a, const unsigned char* d, size_t l):
+    asset(a),
+    data(d),
+    len(l),
+    pos(0),
+    bank(-1),
+    dupOf(-1),
+    placed(false) {}
+};
+
+/**
+ * lays out samples in a chip's sample memory.
+ * - items with identical data are only stored once.
+ * - if the memory is split in banks which a sample may not cross, items are given to the
+ *   banks largest first (first-fit decreasing) so that little space is lost at bank ends.
+ *   within a bank they are placed in the order they were added.
+ * - otherwise items are placed in the order they were added.
+ * the data pointers must stay valid until pack() is done.
+ */
+class DivMemoryPacker {
+  std::vector<DivMemoryPackerItem> items;
+  std::vector<size_t> bankFill;
+  size_t memStart, memCapacity, memAlign, memBank;
+  size_t memUsed, dupSaved;
+
+  size_t alignLen(size_t len);
+  size_t bankBegin(int bank);
+  size_t bankEnd(int bank);
+  public:
+    /**
+     * set up the memory layout and remove all items.
+     * @param start the first usable address.
+     * @param capacity the size of the memory.
+     * @param align the alignment of each sample (their sizes are rounded up to it as well).
+     * @param bankSize if not 0, no sample may cross a multiple of this.
+     */
+    void init(size_t start, size_t capacity, size_t align=1, size_t bankSize=0);
+
+    /**
+     * add a sample.
+     * @param asset the sample index.
+     * @param data the data which will be stored (used to find duplicates).
+     * @param len the length of the data. this must not be larger than a bank.
+     * @return the index of the item.
+     */
+    int add(int asset, const unsigned char* data, size_t len);
+
+    /**
+     * place all items.
+     * @return whether every item fit.
+     */
+    bool pack();
+
+    const DivMemoryPackerItem& get(int index);
+    size_t getItemCount();
+
+    /**
+     * @return the end of the last placed item.
+     */
+    size_t getUsed();
+
+    /**
+     * @return the number of bytes saved by sharing data between samples.
+     */
+    size_t getDupSaved();
+
+    /**
+     * add an entry for every placed item to a memory composition, plus padding
+     * entries for the space lost at bank ends.
+     */
+    void fillCompo(DivMemoryComposition& compo, DivMemoryEntryType type=DIV_MEMORY_SAMPLE);
+
+    /**
+     * only add the padding entries for the space lost at bank ends.
+     */
+    void fillCompoGaps(DivMemoryComposition& compo);
+
+    DivMemoryPacker():
+      memStart(0),
+      memCapacity(0),
+      memAlign(1),
+      memBank(0),
+      memUsed(0),
+      dupSaved(0) {}
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "parallelDeflate.h"
+#include "workPool.h"
+#include "../ta-log.h"
+#include <zlib.h>
+#include <string.h>
+#include <vector>
+
+struct DivDeflateChunk {
+  const unsigned char* data;
+  size_t len;
+  size_t dictLen;
+  bool last;
+  unsigned char* out;
+  size_t outLen;
+  uLong adler;
+  bool ok;
+  DivDeflateChunk():
+    data(NULL),
+    len(0),
+    dictLen(0),
+    last(false),
+    out(NULL),
+    outLen(0),
+    adler(1),
+    ok(false) {}
+};
+
+struct DivDeflateQueue {
+  std::vector<DivDeflateChunk>* chunks;
+  std::atomic<size_t>* next;
+  std::atomic<size_t>* progress;
+  int level;
+  DivDeflateQueue(std::vector<DivDeflateChunk>* c, std::atomic<size_t>* n, std::atomic<size_t>* p, int l):
+    chunks(c),
+    next(n),
+    progress(p),
+    level(l) {}
+};
+
+// compress a chunk into raw deflate data.
+// all chunks but the last end with a sync flush (an empty stored block), which byte-aligns the
+// output without ending the stream, so that the next chunk can be appended as is.
+static void deflateChunk(DivDeflateChunk& c, int level) {
+  z_stream zl;
+  memset(&zl,0,sizeof(z_stream));
+  if (deflateInit2(&zl,level,Z_DEFLATED,-15,8,Z_DEFAULT_STRATEGY)!=Z_OK) return;
+  // prime with the end of the previous chunk so that matches across the boundary are not lost
+  if (c.dictLen>0) {
+    if (deflateSetDictionary(&zl,c.data-c.dictLen,c.dictLen)!=Z_OK) {
+      deflateEnd(&zl);
+      return;
+    }
+  }
+  size_t outCap=deflateBound(&zl,c.len)+16;
+  c.out=new unsigned char[outCap];
+  zl.next_in=(Bytef*)c.data;
+  zl.avail_in=c.len;
+  zl.next_out=c.out;
+  zl.avail_out=outCap;
+  int ret=deflate(&zl,c.last?Z_FINISH:Z_SYNC_FLUSH);
+  if (c.last) {
+    c.ok=(ret==Z_STREAM_END);
+  } else {
+    c.ok=(ret==Z_OK && zl.avail_in==0 && zl.avail_out>0);
+  }
+  c.outLen=outCap-zl.avail_out;
+  deflateEnd(&zl);
+  c.adler=adler32(1,c.data,c.len);
+}
+
+static void _deflateQueue(void* q) {
+  DivDeflateQueue* queue=(DivDeflateQueue*)q;
+  while (true) {
+    size_t next=queue->next->fetch_add(1);
+    if (next>=queue->chunks->size()) break;
+    DivDeflateChunk& c=(*queue->chunks)[next];
+    deflateChunk(c,queue->level);
+    if (queue->progress!=NULL) queue->progress->fetch_add(c.len);
+  }
+}
+
+SafeWriter* parallelDeflate(const unsigned char* data, size_t len, int level, unsigned int threads, std::atomic<size_t>* progress) {
+  // split
+  std::vector<DivDeflateChunk> chunks;
+  size_t pos=0;
+  do {
+    DivDeflateChunk c;
+    c.data=data+pos;
+    c.len=MIN(len-pos,(size_t)DIV_DEFLATE_CHUNK_SIZE);
+    c.dictLen=MIN(pos,(size_t)DIV_DEFLATE_DICT_SIZE);
+    pos+=c.len;
+    c.last=(pos>=len);
+    chunks.push_back(c);
+  } while (pos<len);
+
+  // compress
+  if (threads==0) threads=std::thread::hardware_concurrency();
+  if (threads>chunks.size()) threads=chunks.size();
+  std::atomic<size_t> nextChunk(0);
+  DivDeflateQueue queue(&chunks,&nextChunk,progress,level);
+  if (threads>1) {
+    logD("compressing %d chunks with %d threads...",(int)chunks.size(),threads);
+    DivWorkPool* pool=new DivWorkPool(threads);
+    for (unsigned int i=0; i<threads; i++) {
+      pool->push(_deflateQueue,&queue);
+    }
+    pool->wait();
+    delete pool;
+  } else {
+    _deflateQueue(&queue);
+  }
+
+  // put everything together
+  bool ok=true;
+  uLong adler=1;
+  for (DivDeflateChunk& i: chunks) {
+    if (!i.ok) ok=false;
+    adler=adler32_combine(adler,i.adler,i.len);
+  }
+
+  SafeWriter* w=NULL;
+  if (ok) {
+    w=new SafeWriter;
+    w->init();
+    // zlib header (deflate, 32K window, default level)
+    w->writeC(0x78);
+    w->writeC(0x9c);
+    for (DivDeflateChunk& i: chunks) {
+      w->write(i.out,i.outLen);
+    }
+    w->writeI_BE(adler);
+  } else {
+    logE("error while compressing!");
+  }
+
+  for (DivDeflateChunk& i: chunks) {
+    if (i.out!=NULL) delete[] i.out;
+  }
+  return w;
+}
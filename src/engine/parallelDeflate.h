@@ -0,0 +1,44 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _PARALLELDEFLATE_H
+#define _PARALLELDEFLATE_H
+
+#include <atomic>
+#include "safeWriter.h"
+
+// size of each chunk which is compressed on its own
+#define DIV_DEFLATE_CHUNK_SIZE (256*1024)
+// amount of data from the previous chunk used as dictionary
+#define DIV_DEFLATE_DICT_SIZE 32768
+
+/**
+ * compress a buffer into a zlib stream.
+ * the input is split into chunks which are compressed in parallel (like pigz does), but the
+ * result is a regular zlib stream which inflate() can read.
+ * @param data the input.
+ * @param len length of the input.
+ * @param level compression level (0-9 or Z_DEFAULT_COMPRESSION).
+ * @param threads number of threads to use. 0 means one per core.
+ * @param progress if not NULL, the size of each chunk is added to it once it's compressed.
+ * @return a SafeWriter with the compressed data, or NULL on error.
+ */
+SafeWriter* parallelDeflate(const unsigned char* data, size_t len, int level, unsigned int threads=0, std::atomic<size_t>* progress=NULL);
+
+#endif
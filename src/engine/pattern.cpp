@@ -22,8 +22,86 @@
 
 static DivPattern emptyPat;
 
+const short* DivPatternData::emptyBlock() {
+  static short* block=NULL;
+  static std::once_flag blockInit;
+  std::call_once(blockInit,[]() {
+    block=new short[DIV_PATTERN_BLOCK_SIZE];
+    memset(block,-1,DIV_PATTERN_BLOCK_SIZE*sizeof(short));
+    for (int i=0; i<DIV_PATTERN_BLOCK_ROWS; i++) {
+      block[i*DIV_MAX_COLS]=0;
+      block[i*DIV_MAX_COLS+1]=0;
+    }
+  });
+  return block;
+}
+
+short* DivPatternData::allocBlock(int block) {
+  short* newBlock=new short[DIV_PATTERN_BLOCK_SIZE];
+  memcpy(newBlock,emptyBlock(),DIV_PATTERN_BLOCK_SIZE*sizeof(short));
+  // another thread may have allocated it meanwhile
+  short* expected=NULL;
+  if (!blocks[block].compare_exchange_strong(expected,newBlock,std::memory_order_acq_rel)) {
+    delete[] newBlock;
+    return expected;
+  }
+  return newBlock;
+}
+
+void DivPatternData::clear() {
+  for (int i=0; i<DIV_PATTERN_BLOCKS; i++) {
+    short* block=blocks[i].load(std::memory_order_acquire);
+    if (block!=NULL) memcpy(block,emptyBlock(),DIV_PATTERN_BLOCK_SIZE*sizeof(short));
+  }
+}
+
+void DivPatternData::copyOn(DivPatternData& dest) const {
+  for (int i=0; i<DIV_PATTERN_BLOCKS; i++) {
+    short* block=blocks[i].load(std::memory_order_acquire);
+    short* destBlock=dest.blocks[i].load(std::memory_order_acquire);
+    if (block==NULL) {
+      if (destBlock!=NULL) memcpy(destBlock,emptyBlock(),DIV_PATTERN_BLOCK_SIZE*sizeof(short));
+      continue;
+    }
+    if (destBlock==NULL) destBlock=dest.allocBlock(i);
+    memcpy(destBlock,block,DIV_PATTERN_BLOCK_SIZE*sizeof(short));
+  }
+}
+
+bool DivPatternData::equals(const DivPatternData& other) const {
+  for (int i=0; i<DIV_PATTERN_BLOCKS; i++) {
+    const short* block=blocks[i].load(std::memory_order_acquire);
+    const short* otherBlock=other.blocks[i].load(std::memory_order_acquire);
+    if (block==otherBlock) continue;
+    if (block==NULL) block=emptyBlock();
+    if (otherBlock==NULL) otherBlock=emptyBlock();
+    if (memcmp(block,otherBlock,DIV_PATTERN_BLOCK_SIZE*sizeof(short))!=0) return false;
+  }
+  return true;
+}
+
+size_t DivPatternData::getMemUsage() const {
+  size_t ret=sizeof(DivPatternData);
+  for (int i=0; i<DIV_PATTERN_BLOCKS; i++) {
+    if (blocks[i].load(std::memory_order_relaxed)!=NULL) ret+=DIV_PATTERN_BLOCK_SIZE*sizeof(short);
+  }
+  return ret;
+}
+
+DivPatternData::DivPatternData() {
+  for (int i=0; i<DIV_PATTERN_BLOCKS; i++) {
+    blocks[i]=NULL;
+  }
+}
+
+DivPatternData::~DivPatternData() {
+  for (int i=0; i<DIV_PATTERN_BLOCKS; i++) {
+    short* block=blocks[i].load();
+    if (block!=NULL) delete[] block;
+  }
+}
+
 DivPattern::DivPattern() {
-  clear();
 }
 
 DivPattern* DivChannelData::getPattern(int index, bool create) {
@@ -45,7 +123,7 @@ std::vector<std::pair<int,int>> DivChannelData::optimize() {
       for (int j=0; j<DIV_MAX_PATTERNS; j++) {
         if (j==i) continue;
         if (data[j]==NULL) continue;
-        if (memcmp(data[i]->data,data[j]->data,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short))==0) {
+        if (data[i]->data.equals(data[j]->data)) {
           delete data[j];
           data[j]=NULL;
           logV("%d == %d",i,j);
@@ -84,17 +162,13 @@ void DivChannelData::wipePatterns() {
   }
 }
 
-void DivPattern::copyOn(DivPattern* dest) {
+void DivPattern::copyOn(DivPattern* dest) const {
   dest->name=name;
-  memcpy(dest->data,data,sizeof(data));
+  data.copyOn(dest->data);
 }
 
 void DivPattern::clear() {
-  memset(data,-1,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short));
-  for (int i=0; i<DIV_MAX_ROWS; i++) {
-    data[i][0]=0;
-    data[i][1]=0;
-  }
+  data.clear();
 }
 
 DivChannelData::DivChannelData():
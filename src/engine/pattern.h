@@ -19,10 +19,67 @@
 
 #include "safeReader.h"
 #include "../pch.h"
+#include <atomic>
+
+// pattern data is stored in blocks of rows, which are allocated when written to
+#define DIV_PATTERN_BLOCK_ROWS 16
+#define DIV_PATTERN_BLOCKS (DIV_MAX_ROWS/DIV_PATTERN_BLOCK_ROWS)
+#define DIV_PATTERN_BLOCK_SIZE (DIV_PATTERN_BLOCK_ROWS*DIV_MAX_COLS)
+
+/**
+ * storage of pattern data. use it like an array: data[ROW][TYPE].
+ * non-const access allocates the block containing the row if it isn't already.
+ * const access never allocates, and reads unallocated rows as empty.
+ * blocks are only freed when the pattern is destroyed, so rows may be read while another
+ * thread writes to the pattern (as it was possible with a plain array).
+ */
+struct DivPatternData {
+  std::atomic<short*> blocks[DIV_PATTERN_BLOCKS];
+
+  short* allocBlock(int block);
+  static const short* emptyBlock();
+
+  inline short* operator[](int row) {
+    short* block=blocks[row/DIV_PATTERN_BLOCK_ROWS].load(std::memory_order_acquire);
+    if (block==NULL) block=allocBlock(row/DIV_PATTERN_BLOCK_ROWS);
+    return block+(row%DIV_PATTERN_BLOCK_ROWS)*DIV_MAX_COLS;
+  }
+
+  inline const short* operator[](int row) const {
+    const short* block=blocks[row/DIV_PATTERN_BLOCK_ROWS].load(std::memory_order_acquire);
+    if (block==NULL) block=emptyBlock();
+    return block+(row%DIV_PATTERN_BLOCK_ROWS)*DIV_MAX_COLS;
+  }
+
+  /**
+   * reset all rows to empty. does not free memory.
+   */
+  void clear();
+
+  /**
+   * copy the rows to another pattern.
+   */
+  void copyOn(DivPatternData& dest) const;
+
+  /**
+   * check whether the rows are the same as another pattern's.
+   */
+  bool equals(const DivPatternData& other) const;
+
+  /**
+   * get the amount of memory used by the rows.
+   */
+  size_t getMemUsage() const;
+
+  DivPatternData();
+  ~DivPatternData();
+  DivPatternData(const DivPatternData&)=delete;
+  DivPatternData& operator=(const DivPatternData&)=delete;
+};
 
 struct DivPattern {
   String name;
-  short data[DIV_MAX_ROWS][DIV_MAX_COLS];
+  DivPatternData data;
 
   /**
    * clear the pattern.
@@ -33,7 +90,7 @@ struct DivPattern {
    * copy this pattern to another.
    * @param dest the destination pattern.
    */
-  void copyOn(DivPattern* dest);
+  void copyOn(DivPattern* dest) const;
   DivPattern();
 };
 
@@ -17,7 +17,130 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
- #include "dispatch.h"
+#include "dispatch.h"
+#include <math.h>
 
+DivPitchTable::~DivPitchTable() {
+  for (int i=0; i<DIV_PITCH_TABLE_NOTES; i++) {
+    int* row=pitch[i].load();
+    if (row!=NULL) delete[] row;
+  }
+}
 
- 
\ No newline at end of file
+double DivPitchTable::calcBase(double tuning, double clock, double divider, int note, bool isPeriod) {
+  double base=(isPeriod?(tuning*0.0625):tuning)*pow(2.0,(float)(note+3)/12.0);
+  return isPeriod?
+         (clock/base)/divider:
+         base*(divider/clock);
+}
+
+int DivPitchTable::calcFNumBlock(int bf, double tuning, double clock, double divider, int note, int bits) {
+  if (tuning<400.0) tuning=400.0;
+  if (tuning>500.0) tuning=500.0;
+  int boundaryBottom=tuning*pow(2.0,0.25)*(divider/clock);
+  int boundaryTop=2.0*tuning*pow(2.0,0.25)*(divider/clock);
+  while (boundaryTop>((1<<bits)-1)) {
+    boundaryTop>>=1;
+    boundaryBottom>>=1;
+  }
+  int block=(note)/12;
+  if (block<0) block=0;
+  if (block>7) block=7;
+  bf>>=block;
+  if (bf<0) bf=0;
+  // octave boundaries
+  while (bf>0 && bf<boundaryBottom && block>0) {
+    bf<<=1;
+    block--;
+  }
+  if (bf>boundaryTop) {
+    while (block<7 && bf>boundaryTop) {
+      bf>>=1;
+      block++;
+    }
+    if (bf>((1<<bits)-1)) {
+      bf=(1<<bits)-1;
+    }
+  }
+  // logV("f-num: %d block: %d",bf,block);
+  return bf|(block<<bits);
+}
+
+int DivPitchTable::calcLinear(double tuning, double clock, double divider, int nbase, bool isPeriod, int block) {
+  double fbase=(isPeriod?(tuning*0.0625):tuning)*pow(2.0,(float)(nbase+384)/(128.0*12.0));
+  int bf=isPeriod?
+         round((clock/fbase)/divider):
+         round(fbase*(divider/clock));
+  if (block>0) {
+    return calcFNumBlock(bf,tuning,clock,divider,nbase>>7,block);
+  }
+  return bf;
+}
+
+bool DivPitchTable::matches(double t, double c, double d, unsigned char linear, bool isPeriod, unsigned char block) {
+  return (clock==c && divider==d && tuning==t && linearity==linear && period==isPeriod && blockBits==block);
+}
+
+int DivPitchTable::get(int nbase) {
+  int note=(nbase>>7)-DIV_PITCH_TABLE_FIRST;
+  if (note<0 || note>=DIV_PITCH_TABLE_NOTES) {
+    return calcLinear(tuning,clock,divider,nbase,period,blockBits);
+  }
+  int* row=pitch[note].load();
+  if (row==NULL) {
+    // fill in this note
+    int* newRow=new int[128];
+    int noteBase=nbase&(~127);
+    for (int i=0; i<128; i++) {
+      newRow[i]=calcLinear(tuning,clock,divider,noteBase+i,period,blockBits);
+    }
+    // another thread may have done so already
+    if (pitch[note].compare_exchange_strong(row,newRow)) {
+      row=newRow;
+    } else {
+      delete[] newRow;
+    }
+  }
+  return row[nbase&127];
+}
+
+double DivPitchTable::getBase(int note) {
+  int index=note-DIV_PITCH_TABLE_FIRST;
+  if (index<0 || index>=DIV_PITCH_TABLE_NOTES) {
+    return calcBase(tuning,clock,divider,note,period);
+  }
+  return base[index];
+}
+
+int DivPitchTable::getBaseFNumBlock(int note) {
+  int index=note-DIV_PITCH_TABLE_FIRST;
+  if (index<0 || index>=DIV_PITCH_TABLE_NOTES) {
+    return calcFNumBlock(calcBase(tuning,clock,divider,note,false),tuning,clock,divider,note,blockBits);
+  }
+  return baseFNumBlock[index];
+}
+
+void DivPitchTable::init(double t, double c, double d, unsigned char linear, bool isPeriod, unsigned char block) {
+  tuning=t;
+  clock=c;
+  divider=d;
+  linearity=linear;
+  period=isPeriod;
+  blockBits=block;
+
+  for (int i=0; i<DIV_PITCH_TABLE_NOTES; i++) {
+    int* row=pitch[i].exchange(NULL);
+    if (row!=NULL) delete[] row;
+  }
+
+  // full linear tables are filled in as needed
+  if (linearity==2) return;
+
+  for (int i=0; i<DIV_PITCH_TABLE_NOTES; i++) {
+    int note=i+DIV_PITCH_TABLE_FIRST;
+    base[i]=calcBase(tuning,clock,divider,note,period);
+    if (!period) {
+      baseFNumBlock[i]=calcFNumBlock(base[i],tuning,clock,divider,note,blockBits);
+    }
+  }
+}
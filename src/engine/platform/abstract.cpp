@@ -76,6 +76,9 @@ void* DivDispatch::getState() {
 void DivDispatch::setState(void* state) {
 }
 
+void DivDispatch::freeState(void* state) {
+}
+
 void DivDispatch::muteChannel(int ch, bool mute) {
 }
 
@@ -142,6 +145,22 @@ void DivDispatch::setSkipRegisterWrites(bool value) {
   skipRegisterWrites=value;
 }
 
+void DivDispatch::setSkipOscWrites(bool value) {
+  skipOscWrites=value;
+}
+
+void DivDispatch::setRenderPos(int pos) {
+  renderPos=pos;
+}
+
+bool DivDispatch::getRenderPerBuffer() {
+  return false;
+}
+
+bool DivDispatch::getRenderFlushNeeded() {
+  return false;
+}
+
 void DivDispatch::notifyInsChange(int ins) {
 
 }
@@ -20,6 +20,7 @@
 #define _USE_MATH_DEFINES
 #include "amiga.h"
 #include "../engine.h"
+#include "../memoryPacker.h"
 #include "../../ta-log.h"
 #include <math.h>
 
@@ -182,9 +183,9 @@ void DivPlatformAmiga::acquire(short** buf, size_t len) {
           outL+=(output*sep2)>>7;
           outR+=(output*sep1)>>7;
         }
-        oscBuf[i]->data[oscBuf[i]->needle++]=(amiga.nextOut[i]*MIN(64,amiga.audVol[i]&127))<<1;
+        if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=(amiga.nextOut[i]*MIN(64,amiga.audVol[i]&127))<<1;
       } else {
-        oscBuf[i]->data[oscBuf[i]->needle++]=0;
+        if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=0;
       }
     }
 
@@ -900,6 +901,32 @@ int DivPlatformAmiga::getRegisterPoolSize() {
   return 128;
 }
 
+void* DivPlatformAmiga::getState() {
+  State* s=new State;
+  for (int i=0; i<4; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->filtConst=filtConst;
+  s->filterOn=filterOn;
+  s->updateADKCon=updateADKCon;
+  return s;
+}
+
+void DivPlatformAmiga::setState(void* state) {
+  if (state==NULL) return;
+  State* s=(State*)state;
+  for (int i=0; i<4; i++) {
+    chan[i]=s->chan[i];
+  }
+  filtConst=s->filtConst;
+  filterOn=s->filterOn;
+  updateADKCon=s->updateADKCon;
+}
+
+void DivPlatformAmiga::freeState(void* state) {
+  delete (State*)state;
+}
+
 int DivPlatformAmiga::getRegisterPoolDepth() {
   return 16;
 }
@@ -940,32 +967,31 @@ void DivPlatformAmiga::renderSamples(int sysID) {
 
   // first 1024 bytes reserved for wavetable
   // the next 2 bytes are reserved for end of sample
-  size_t memPos=1026;
+  DivMemoryPacker packer;
+  packer.init(1026,getSampleMemCapacity(),2);
   for (int i=0; i<parent->song.sampleLen; i++) {
     DivSample* s=parent->song.sample[i];
-    if (!s->renderOn[0][sysID]) {
-      sampleOff[i]=0;
+    if (!s->renderOn[0][sysID]) continue;
+    packer.add(i,(const unsigned char*)s->data8,MAX(0,s->getLoopEndPosition(DIV_SAMPLE_DEPTH_8BIT)));
+  }
+  packer.pack();
+  for (size_t i=0; i<packer.getItemCount(); i++) {
+    const DivMemoryPackerItem& item=packer.get(i);
+    if (item.len==0) {
+      sampleLoaded[item.asset]=true;
       continue;
     }
-
-    if (memPos>=getSampleMemCapacity()) {
-      logW("out of Amiga memory for sample %d!",i);
-      break;
-    }
-
-    int length=s->getLoopEndPosition(DIV_SAMPLE_DEPTH_8BIT);
-    int actualLength=MIN((int)(getSampleMemCapacity()-memPos),length);
-    if (actualLength>0) {
-      sampleOff[i]=memPos;
-      memcpy(&sampleMem[memPos],s->data8,actualLength);
-      memCompo.entries.push_back(DivMemoryEntry(DIV_MEMORY_SAMPLE,"Sample",i,memPos,memPos+actualLength));
-      memPos+=actualLength;
+    if (!item.placed) {
+      logW("out of Amiga memory for sample %d!",item.asset);
+      continue;
     }
-    // align memPos to short
-    if (memPos&1) memPos++;
-    sampleLoaded[i]=true;
+    if (item.dupOf<0) memcpy(&sampleMem[item.pos],item.data,item.len);
+    sampleOff[item.asset]=item.pos;
+    sampleLoaded[item.asset]=true;
   }
-  sampleMemLen=memPos;
+  packer.fillCompo(memCompo);
+  // align to short
+  sampleMemLen=(packer.getUsed()+1)&(~1);
 
   memCompo.capacity=1<<chipMem;
   memCompo.used=sampleMemLen;
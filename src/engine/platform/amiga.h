@@ -128,6 +128,12 @@ class DivPlatformAmiga: public DivDispatch {
   };
   FixedQueue<QueuedWrite,512> writes;
 
+  struct State {
+    Channel chan[4];
+    int filtConst;
+    bool filterOn, updateADKCon;
+  };
+
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
   friend class DivExportAmigaValidation;
@@ -143,6 +149,9 @@ class DivPlatformAmiga: public DivDispatch {
     DivDispatchOscBuffer* getOscBuffer(int chan);
     unsigned char* getRegisterPool();
     int getRegisterPoolSize();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     int getRegisterPoolDepth();
     void reset();
     void forceIns();
@@ -23,6 +23,9 @@
 #include <string.h>
 #include <math.h>
 
+// maximum number of samples generated by ymfm at once
+#define YMFM_BATCH_SIZE 256
+
 const char* regCheatSheetOPM[]={
   "Test", "00",
   "NoteCtl", "08",
@@ -75,7 +78,7 @@ void DivPlatformArcade::acquire_nuked(short** buf, size_t len) {
       OPM_Clock(&fm,o,NULL,NULL,NULL);
     }
 
-    for (int i=0; i<8; i++) {
+    if (!skipOscWrites) for (int i=0; i<8; i++) {
       int chOut=(int16_t)fm.ch_out[i];
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<1,-32768,32767);
     }
@@ -93,11 +96,21 @@ void DivPlatformArcade::acquire_nuked(short** buf, size_t len) {
 
 void DivPlatformArcade::acquire_ymfm(short** buf, size_t len) {
   thread_local int os[2];
+  ymfm::ym2151::output_data out[YMFM_BATCH_SIZE];
+  ymfm::fm_debug_tap taps[8];
 
   ymfm::ym2151::fm_engine* fme=fm_ymfm->debug_engine();
 
-  for (size_t h=0; h<len; h++) {
-    os[0]=0; os[1]=0;
+  for (int i=0; i<8; i++) {
+    taps[i].channel=i;
+    taps[i].source=ymfm::fm_debug_tap::OUTPUT_SUM;
+    taps[i].shift=0;
+  }
+
+  for (size_t h=0; h<len;) {
+    // one sample at a time while there are writes.
+    // after that the rest of the buffer is generated at once.
+    size_t batch=1;
     if (!writes.empty()) {
       if (--delay<1) {
         QueuedWrite& w=writes.front();
@@ -107,25 +120,36 @@ void DivPlatformArcade::acquire_ymfm(short** buf, size_t len) {
         writes.pop_front();
         delay=1;
       }
+    } else {
+      batch=MIN(len-h,YMFM_BATCH_SIZE);
     }
 
-    fm_ymfm->generate(&out_ymfm);
-
-    for (int i=0; i<8; i++) {
-      int chOut=fme->debug_channel(i)->debug_output(0)+fme->debug_channel(i)->debug_output(1);
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut,-32768,32767);
+    // without taps ymfm doesn't track per-channel output at all
+    int tapCount=skipOscWrites?0:8;
+    for (int i=0; i<tapCount; i++) {
+      batch=MIN(batch,(size_t)(65536-oscBuf[i]->needle));
     }
+    for (int i=0; i<tapCount; i++) {
+      taps[i].data=&oscBuf[i]->data[oscBuf[i]->needle];
+      oscBuf[i]->needle+=batch;
+    }
+
+    fme->debug_set_taps(taps,tapCount);
+    fm_ymfm->generate(out,batch);
+    fme->debug_set_taps(NULL,0);
 
-    os[0]=out_ymfm.data[0];
-    if (os[0]<-32768) os[0]=-32768;
-    if (os[0]>32767) os[0]=32767;
+    for (size_t i=0; i<batch; i++, h++) {
+      os[0]=out[i].data[0];
+      if (os[0]<-32768) os[0]=-32768;
+      if (os[0]>32767) os[0]=32767;
 
-    os[1]=out_ymfm.data[1];
-    if (os[1]<-32768) os[1]=-32768;
-    if (os[1]>32767) os[1]=32767;
+      os[1]=out[i].data[1];
+      if (os[1]<-32768) os[1]=-32768;
+      if (os[1]>32767) os[1]=32767;
 
-    buf[0][h]=os[0];
-    buf[1][h]=os[1];
+      buf[0][h]=os[0];
+      buf[1][h]=os[1];
+    }
   }
 }
 
@@ -47,7 +47,6 @@ class DivPlatformArcade: public DivPlatformOPM {
     unsigned char amDepth, pmDepth;
 
     ymfm::ym2151* fm_ymfm;
-    ymfm::ym2151::output_data out_ymfm;
     DivArcadeInterface iface;
 
     bool useYMFM;
@@ -187,9 +187,11 @@ void DivPlatformAY8910::acquire_mame(short** buf, size_t len) {
       buf[0][i]=ayBuf[0][0];
       buf[1][i]=buf[0][i];
 
-      oscBuf[0]->data[oscBuf[0]->needle++]=CLAMP(sunsoftVolTable[31-(ay->lastIndx&31)]<<3,-32768,32767);
-      oscBuf[1]->data[oscBuf[1]->needle++]=CLAMP(sunsoftVolTable[31-((ay->lastIndx>>5)&31)]<<3,-32768,32767);
-      oscBuf[2]->data[oscBuf[2]->needle++]=CLAMP(sunsoftVolTable[31-((ay->lastIndx>>10)&31)]<<3,-32768,32767);
+      if (!skipOscWrites) {
+        oscBuf[0]->data[oscBuf[0]->needle++]=CLAMP(sunsoftVolTable[31-(ay->lastIndx&31)]<<3,-32768,32767);
+        oscBuf[1]->data[oscBuf[1]->needle++]=CLAMP(sunsoftVolTable[31-((ay->lastIndx>>5)&31)]<<3,-32768,32767);
+        oscBuf[2]->data[oscBuf[2]->needle++]=CLAMP(sunsoftVolTable[31-((ay->lastIndx>>10)&31)]<<3,-32768,32767);
+      }
     }
   } else {
     for (size_t i=0; i<len; i++) {
@@ -205,9 +207,11 @@ void DivPlatformAY8910::acquire_mame(short** buf, size_t len) {
         buf[1][i]=buf[0][i];
       }
 
-      oscBuf[0]->data[oscBuf[0]->needle++]=ayBuf[0][0]<<2;
-      oscBuf[1]->data[oscBuf[1]->needle++]=ayBuf[1][0]<<2;
-      oscBuf[2]->data[oscBuf[2]->needle++]=ayBuf[2][0]<<2;
+      if (!skipOscWrites) {
+        oscBuf[0]->data[oscBuf[0]->needle++]=ayBuf[0][0]<<2;
+        oscBuf[1]->data[oscBuf[1]->needle++]=ayBuf[1][0]<<2;
+        oscBuf[2]->data[oscBuf[2]->needle++]=ayBuf[2][0]<<2;
+      }
     }
   }
 }
@@ -234,9 +238,11 @@ void DivPlatformAY8910::acquire_atomic(short** buf, size_t len) {
       buf[1][i]=buf[0][i];
     }
 
-    oscBuf[0]->data[oscBuf[0]->needle++]=ay_atomic.o_analog[0];
-    oscBuf[1]->data[oscBuf[1]->needle++]=ay_atomic.o_analog[1];
-    oscBuf[2]->data[oscBuf[2]->needle++]=ay_atomic.o_analog[2];
+    if (!skipOscWrites) {
+      oscBuf[0]->data[oscBuf[0]->needle++]=ay_atomic.o_analog[0];
+      oscBuf[1]->data[oscBuf[1]->needle++]=ay_atomic.o_analog[1];
+      oscBuf[2]->data[oscBuf[2]->needle++]=ay_atomic.o_analog[2];
+    }
   }
 }
 
@@ -793,6 +799,44 @@ int DivPlatformAY8910::getRegisterPoolSize() {
   return 16;
 }
 
+void* DivPlatformAY8910::getState() {
+  State* s=new State;
+  for (int i=0; i<3; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->sampleBank=sampleBank;
+  s->ayEnvMode=ayEnvMode;
+  s->ayEnvPeriod=ayEnvPeriod;
+  s->ayEnvSlideLow=ayEnvSlideLow;
+  s->ayEnvSlide=ayEnvSlide;
+  s->portAVal=portAVal;
+  s->portBVal=portBVal;
+  s->ioPortA=ioPortA;
+  s->ioPortB=ioPortB;
+  return s;
+}
+
+void DivPlatformAY8910::setState(void* state) {
+  if (state==NULL) return;
+  State* s=(State*)state;
+  for (int i=0; i<3; i++) {
+    chan[i]=s->chan[i];
+  }
+  sampleBank=s->sampleBank;
+  ayEnvMode=s->ayEnvMode;
+  ayEnvPeriod=s->ayEnvPeriod;
+  ayEnvSlideLow=s->ayEnvSlideLow;
+  ayEnvSlide=s->ayEnvSlide;
+  portAVal=s->portAVal;
+  portBVal=s->portBVal;
+  ioPortA=s->ioPortA;
+  ioPortB=s->ioPortB;
+}
+
+void DivPlatformAY8910::freeState(void* state) {
+  delete (State*)state;
+}
+
 void DivPlatformAY8910::flushWrites() {
   while (!writes.empty()) writes.pop();
 }
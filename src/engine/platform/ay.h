@@ -131,6 +131,15 @@ class DivPlatformAY8910: public DivDispatch {
     void acquire_mame(short** buf, size_t len);
     void acquire_atomic(short** buf, size_t len);
   
+    struct State {
+      Channel chan[3];
+      unsigned char sampleBank, ayEnvMode;
+      unsigned short ayEnvPeriod;
+      short ayEnvSlideLow, ayEnvSlide;
+      unsigned char portAVal, portBVal;
+      bool ioPortA, ioPortB;
+    };
+
     friend void putDispatchChip(void*,int);
     friend void putDispatchChan(void*,int,int);
   
@@ -144,6 +153,9 @@ class DivPlatformAY8910: public DivDispatch {
     int mapVelocity(int ch, float vel);
     unsigned char* getRegisterPool();
     int getRegisterPoolSize();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void setCore(unsigned char core);
     void flushWrites();
     void reset();
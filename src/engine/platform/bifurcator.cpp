@@ -62,7 +62,7 @@ void DivPlatformBifurcator::acquire(short** buf, size_t len) {
       int out=chan[i].curx-32768;
       int outL=out*chan[i].chVolL/256;
       int outR=out*chan[i].chVolR/256;
-      oscBuf[i]->data[oscBuf[i]->needle++]=(short)((outL+outR)/2);
+      if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=(short)((outL+outR)/2);
       l+=outL/4;
       r+=outR/4;
     }
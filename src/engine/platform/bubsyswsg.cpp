@@ -49,12 +49,12 @@ void DivPlatformBubSysWSG::acquire(short** buf, size_t len) {
     // Wavetable part
     for (int i=0; i<2; i++) {
       if (isMuted[i]) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=0;
+        if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=0;
         continue;
       } else {
         chanOut=chan[i].waveROM[k005289.addr(i)]*(regPool[2+i]&0xf);
         out+=chanOut;
-        if (writeOscBuf==0) {
+        if (!skipOscWrites && writeOscBuf==0) {
           oscBuf[i]->data[oscBuf[i]->needle++]=chanOut<<7;
         }
       }
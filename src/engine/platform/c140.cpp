@@ -19,6 +19,7 @@
 
 #include "c140.h"
 #include "../engine.h"
+#include "../memoryPacker.h"
 #include "../../ta-log.h"
 #include <math.h>
 
@@ -90,7 +91,7 @@ void DivPlatformC140::acquire_219(short** buf, size_t len) {
     buf[0][h]=c219.lout;
     buf[1][h]=c219.rout;
 
-    for (int i=0; i<totalChans; i++) {
+    if (!skipOscWrites) for (int i=0; i<totalChans; i++) {
       if (c219.voice[i].inv_lout) {
         oscBuf[i]->data[oscBuf[i]->needle++]=(c219.voice[i].lout-c219.voice[i].rout)>>10;
       } else {
@@ -123,7 +124,7 @@ void DivPlatformC140::acquire_140(short** buf, size_t len) {
     buf[0][h]=c140.lout;
     buf[1][h]=c140.rout;
 
-    for (int i=0; i<totalChans; i++) {
+    if (!skipOscWrites) for (int i=0; i<totalChans; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=(c140.voice[i].lout+c140.voice[i].rout)>>10;
     }
   }
@@ -608,13 +609,13 @@ void DivPlatformC140::renderSamples(int sysID) {
   memCompo=DivMemoryComposition();
   memCompo.name="Sample ROM";
 
-  size_t memPos=0;
+  // render the samples first so that identical ones can be found
+  std::vector<std::vector<unsigned char>> rendered;
+  rendered.resize(parent->song.sampleLen);
   for (int i=0; i<parent->song.sampleLen; i++) {
     DivSample* s=parent->song.sample[i];
-    if (!s->renderOn[0][sysID]) {
-      sampleOff[i]=0;
-      continue;
-    }
+    if (!s->renderOn[0][sysID]) continue;
+    std::vector<unsigned char>& mem=rendered[i];
 
     if (is219) { // C219 (8-bit)
       unsigned int length=s->length8+4;
@@ -623,18 +624,7 @@ void DivPlatformC140::renderSamples(int sysID) {
         length=131072;
       }
       if (length&1) length++;
-      if ((memPos&0xfe0000)!=((memPos+length)&0xfe0000)) {
-        memPos=((memPos+0x1ffff)&0xfe0000);
-      }
-      logV("%d",length);
-      if (memPos>=(getSampleMemCapacity())) {
-        logW("out of C219 memory for sample %d!",i);
-        break;
-      }
-      if (memPos+length>=(getSampleMemCapacity())) {
-        length=getSampleMemCapacity()-memPos;
-        logW("out of C219 memory for sample %d!",i);
-      }
+      mem.resize(length,0);
       if (s->depth==DIV_SAMPLE_DEPTH_C219) {
         unsigned char next=0;
         unsigned int sPos=0;
@@ -647,7 +637,7 @@ void DivPlatformC140::renderSamples(int sysID) {
               }
             }
           }
-          sampleMem[(memPos+i)^1]=next;
+          mem[i^1]=next;
         }
       } else {
         signed char next=0;
@@ -661,39 +651,25 @@ void DivPlatformC140::renderSamples(int sysID) {
               }
             }
           }
-          sampleMem[(memPos+i)^1]=next;
+          mem[i^1]=next;
         }
       }
-      sampleOff[i]=memPos>>1;
-      sampleLoaded[i]=true;
-      memCompo.entries.push_back(DivMemoryEntry((DivMemoryEntryType)(DIV_MEMORY_BANK0+((memPos>>17)&3)),"Sample",i,memPos,memPos+length));
-      memPos+=length;
     } else { // C140 (16-bit)
       unsigned int length=s->length16+4;
       // fit sample size to single bank size
       if (length>(131072)) {
         length=131072;
       }
-      if ((memPos&0xfe0000)!=((memPos+length)&0xfe0000)) {
-        memPos=((memPos+0x1ffff)&0xfe0000);
-      }
-      if (memPos>=(getSampleMemCapacity())) {
-        logW("out of C140 memory for sample %d!",i);
-        break;
-      }
+      mem.resize(length,0);
       // why is C140 not G.711-compliant? this weird bit mangling had me puzzled for 3 hours...
-      if (memPos+length>=(getSampleMemCapacity())) {
-        length=getSampleMemCapacity()-memPos;
-        logW("out of C140 memory for sample %d!",i);
-      }
       if (s->depth==DIV_SAMPLE_DEPTH_MULAW) {
         for (unsigned int i=0; i<length; i+=2) {
           if ((i>>1)>=s->lengthMuLaw) break;
           unsigned char x=s->dataMuLaw[i>>1]^0xff;
           if (x&0x80) x^=15;
           unsigned char c140Mu=(x&0x80)|((x&15)<<3)|((x&0x70)>>4);
-          sampleMem[i+memPos]=0;
-          sampleMem[1+i+memPos]=c140Mu;
+          mem[i]=0;
+          mem[1+i]=c140Mu;
         }
       } else {
         short next=0;
@@ -707,17 +683,34 @@ void DivPlatformC140::renderSamples(int sysID) {
               }
             }
           }
-          sampleMem[memPos+i]=((unsigned short)next);
-          sampleMem[memPos+i+1]=((unsigned short)next)>>8;
+          mem[i]=((unsigned short)next);
+          mem[i+1]=((unsigned short)next)>>8;
         }
       }
-      sampleOff[i]=memPos>>1;
-      sampleLoaded[i]=true;
-      memCompo.entries.push_back(DivMemoryEntry(DIV_MEMORY_SAMPLE,"Sample",i,memPos,memPos+length));
-      memPos+=length;
     }
   }
-  sampleMemLen=memPos+256;
+
+  // samples may not cross a bank
+  DivMemoryPacker packer;
+  packer.init(0,getSampleMemCapacity(),2,0x20000);
+  for (int i=0; i<parent->song.sampleLen; i++) {
+    if (rendered[i].empty()) continue;
+    packer.add(i,rendered[i].data(),rendered[i].size());
+  }
+  packer.pack();
+  for (size_t i=0; i<packer.getItemCount(); i++) {
+    const DivMemoryPackerItem& item=packer.get(i);
+    if (!item.placed) {
+      logW("out of %s memory for sample %d!",is219?"C219":"C140",item.asset);
+      continue;
+    }
+    if (item.dupOf<0) memcpy(&sampleMem[item.pos],item.data,item.len);
+    sampleOff[item.asset]=item.pos>>1;
+    sampleLoaded[item.asset]=true;
+    memCompo.entries.push_back(DivMemoryEntry(is219?((DivMemoryEntryType)(DIV_MEMORY_BANK0+((item.pos>>17)&3))):DIV_MEMORY_SAMPLE,"Sample",item.asset,item.pos,item.pos+item.len));
+  }
+  packer.fillCompoGaps(memCompo);
+  sampleMemLen=packer.getUsed()+256;
 
   memCompo.used=sampleMemLen;
   memCompo.capacity=getSampleMemCapacity(0);
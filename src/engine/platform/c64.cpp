@@ -24,7 +24,7 @@
 #include <math.h>
 #include "../../ta-log.h"
 
-#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);} }
+#define rWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v,renderPos)); if (dumpWrites) {addWrite(a,v);} }
 
 #define CHIP_FREQBASE 524288
 
@@ -100,10 +100,68 @@ short DivPlatformC64::runFakeFilter(unsigned char ch, int in) {
   return CLAMP(fout,-32768,32767);
 }
 
+void DivPlatformC64::acquire_block(short** buf, size_t len) {
+  int dcOff=(sidCore)?0:sid->get_dc(0);
+  size_t i=0;
+  while (i<len) {
+    // writes are still one cycle apart
+    if (!writes.empty() && (renderPos<0 || writes.front().pos<=renderPos+(int)i)) {
+      QueuedWrite w=writes.front();
+      if (sidCore==1) {
+        if (blockOutPos>=blockOutLen) blockOutPos=blockOutLen=0;
+        sid_fp->write(w.addr,w.val);
+        blockOutLen+=sid_fp->clock(1,&blockOut[blockOutLen]);
+      } else {
+        sid->write(w.addr,w.val);
+        // a single cycle produces at most one sample
+        cycle_count dt=1;
+        if (sid->clock(dt,&buf[0][i],1)>0) {
+          if (!skipOscWrites) {
+            oscBuf[0]->data[oscBuf[0]->needle++]=runFakeFilter(0,(sid->last_chan_out[0]-dcOff)>>5);
+            oscBuf[1]->data[oscBuf[1]->needle++]=runFakeFilter(1,(sid->last_chan_out[1]-dcOff)>>5);
+            oscBuf[2]->data[oscBuf[2]->needle++]=runFakeFilter(2,(sid->last_chan_out[2]-dcOff)>>5);
+          }
+          i++;
+        }
+      }
+      regPool[w.addr&0x1f]=w.val;
+      writes.pop();
+      continue;
+    }
+    if (sidCore==1) {
+      if (blockOutPos>=blockOutLen) {
+        blockOutPos=0;
+        blockOutLen=sid_fp->clock(blockCycles,blockOut);
+        continue;
+      }
+      buf[0][i]=blockOut[blockOutPos++];
+      if (!skipOscWrites) {
+        oscBuf[0]->data[oscBuf[0]->needle++]=runFakeFilter(0,(sid_fp->lastChanOut[0]-dcOff)>>5);
+        oscBuf[1]->data[oscBuf[1]->needle++]=runFakeFilter(1,(sid_fp->lastChanOut[1]-dcOff)>>5);
+        oscBuf[2]->data[oscBuf[2]->needle++]=runFakeFilter(2,(sid_fp->lastChanOut[2]-dcOff)>>5);
+      }
+    } else {
+      // run until the next sample
+      cycle_count dt=blockCycles+1;
+      if (sid->clock(dt,&buf[0][i],1)<1) continue;
+      if (!skipOscWrites) {
+        oscBuf[0]->data[oscBuf[0]->needle++]=runFakeFilter(0,(sid->last_chan_out[0]-dcOff)>>5);
+        oscBuf[1]->data[oscBuf[1]->needle++]=runFakeFilter(1,(sid->last_chan_out[1]-dcOff)>>5);
+        oscBuf[2]->data[oscBuf[2]->needle++]=runFakeFilter(2,(sid->last_chan_out[2]-dcOff)>>5);
+      }
+    }
+    i++;
+  }
+}
+
 void DivPlatformC64::acquire(short** buf, size_t len) {
+  if (blockClock && sidCore<2) {
+    acquire_block(buf,len);
+    return;
+  }
   int dcOff=(sidCore)?0:sid->get_dc(0);
   for (size_t i=0; i<len; i++) {
-    if (!writes.empty()) {
+    if (!writes.empty() && (renderPos<0 || writes.front().pos<=renderPos+(int)i)) {
       QueuedWrite w=writes.front();
       if (sidCore==2) {
         dSID_write(sid_d,w.addr,w.val);
@@ -118,7 +176,7 @@ void DivPlatformC64::acquire(short** buf, size_t len) {
     if (sidCore==2) {
       double o=dSID_render(sid_d);
       buf[0][i]=32767*CLAMP(o,-1.0,1.0);
-      if (++writeOscBuf>=4) {
+      if (!skipOscWrites && ++writeOscBuf>=4) {
         writeOscBuf=0;
         oscBuf[0]->data[oscBuf[0]->needle++]=sid_d->lastOut[0];
         oscBuf[1]->data[oscBuf[1]->needle++]=sid_d->lastOut[1];
@@ -126,7 +184,7 @@ void DivPlatformC64::acquire(short** buf, size_t len) {
       }
     } else if (sidCore==1) {
       sid_fp->clock(4,&buf[0][i]);
-      if (++writeOscBuf>=4) {
+      if (!skipOscWrites && ++writeOscBuf>=4) {
         writeOscBuf=0;
         oscBuf[0]->data[oscBuf[0]->needle++]=runFakeFilter(0,(sid_fp->lastChanOut[0]-dcOff)>>5);
         oscBuf[1]->data[oscBuf[1]->needle++]=runFakeFilter(1,(sid_fp->lastChanOut[1]-dcOff)>>5);
@@ -135,7 +193,7 @@ void DivPlatformC64::acquire(short** buf, size_t len) {
     } else {
       sid->clock();
       buf[0][i]=sid->output();
-      if (++writeOscBuf>=16) {
+      if (!skipOscWrites && ++writeOscBuf>=16) {
         writeOscBuf=0;
         oscBuf[0]->data[oscBuf[0]->needle++]=runFakeFilter(0,(sid->last_chan_out[0]-dcOff)>>5);
         oscBuf[1]->data[oscBuf[1]->needle++]=runFakeFilter(1,(sid->last_chan_out[1]-dcOff)>>5);
@@ -145,6 +203,25 @@ void DivPlatformC64::acquire(short** buf, size_t len) {
   }
 }
 
+void DivPlatformC64::setRenderPos(int pos) {
+  // writes left over from the last buffer are due now
+  if (pos<0) {
+    for (size_t i=0; i<writes.size(); i++) {
+      writes[i].pos=-1;
+    }
+  }
+  renderPos=pos;
+}
+
+bool DivPlatformC64::getRenderPerBuffer() {
+  return true;
+}
+
+bool DivPlatformC64::getRenderFlushNeeded() {
+  // render before the queue fills up
+  return writes.size()>384;
+}
+
 void DivPlatformC64::updateFilter() {
   rWrite(0x15,filtCut&7);
   rWrite(0x16,filtCut>>3);
@@ -626,6 +703,42 @@ int DivPlatformC64::getRegisterPoolSize() {
   return 32;
 }
 
+void* DivPlatformC64::getState() {
+  State* s=new State;
+  for (int i=0; i<3; i++) {
+    s->chan[i]=chan[i];
+  }
+  for (int i=0; i<3; i++) {
+    s->chanOrder[i]=chanOrder[i];
+  }
+  s->filtControl=filtControl;
+  s->filtRes=filtRes;
+  s->vol=vol;
+  s->filtCut=filtCut;
+  s->resetTime=resetTime;
+  return s;
+}
+
+void DivPlatformC64::setState(void* state) {
+  if (state==NULL) return;
+  State* s=(State*)state;
+  for (int i=0; i<3; i++) {
+    chan[i]=s->chan[i];
+  }
+  for (int i=0; i<3; i++) {
+    chanOrder[i]=s->chanOrder[i];
+  }
+  filtControl=s->filtControl;
+  filtRes=s->filtRes;
+  vol=s->vol;
+  filtCut=s->filtCut;
+  resetTime=s->resetTime;
+}
+
+void DivPlatformC64::freeState(void* state) {
+  delete (State*)state;
+}
+
 bool DivPlatformC64::getDCOffRequired() {
   return true;
 }
@@ -644,6 +757,8 @@ float DivPlatformC64::getPostAmp() {
 
 void DivPlatformC64::reset() {
   while (!writes.empty()) writes.pop();
+  blockOutPos=0;
+  blockOutLen=0;
   for (int i=0; i<3; i++) {
     chan[i]=DivPlatformC64::Channel();
     chan[i].std.setEngine(parent);
@@ -705,7 +820,9 @@ void DivPlatformC64::setChipModel(bool is6581) {
 }
 
 void DivPlatformC64::setCore(unsigned char which) {
-  sidCore=which;
+  // 3 and 4 are reSID and reSIDfp with block clocking
+  blockClock=(which>=3);
+  sidCore=blockClock?(which-3):which;
 }
 
 void DivPlatformC64::setFlags(const DivConfig& flags) {
@@ -726,7 +843,18 @@ void DivPlatformC64::setFlags(const DivConfig& flags) {
   for (int i=0; i<3; i++) {
     oscBuf[i]->rate=rate/16;
   }
-  if (sidCore>0) {
+  if (blockClock && sidCore<2) {
+    rate=hostRate;
+    for (int i=0; i<3; i++) {
+      oscBuf[i]->rate=rate;
+    }
+    blockCycles=ceil(chipClock/rate);
+    if (sidCore==1) {
+      sid_fp->setSamplingParameters(chipClock,reSIDfp::RESAMPLE,rate,MIN(20000.0,rate*0.45));
+    } else {
+      sid->set_sampling_parameters(chipClock,SAMPLE_FAST,rate);
+    }
+  } else if (sidCore>0) {
     rate/=(sidCore==2)?coreQuality:4;
     if (sidCore==1) sid_fp->setSamplingParameters(chipClock,reSIDfp::DECIMATE,rate,0);
   }
@@ -790,6 +918,9 @@ int DivPlatformC64::init(DivEngine* p, int channels, int sugRate, const DivConfi
   skipRegisterWrites=false;
   needInitTables=true;
   writeOscBuf=0;
+  hostRate=(sugRate>0)?sugRate:44100;
+  blockOutPos=0;
+  blockOutLen=0;
   for (int i=0; i<3; i++) {
     isMuted[i]=false;
     oscBuf[i]=new DivDispatchOscBuffer;
@@ -67,16 +67,24 @@ class DivPlatformC64: public DivDispatch {
   struct QueuedWrite {
       unsigned char addr;
       unsigned char val;
-      QueuedWrite(): addr(0), val(0) {}
-      QueuedWrite(unsigned char a, unsigned char v): addr(a), val(v) {}
+      // render position at which this write takes place (when rendering per buffer)
+      int pos;
+      QueuedWrite(): addr(0), val(0), pos(-1) {}
+      QueuedWrite(unsigned char a, unsigned char v, int p): addr(a), val(v), pos(p) {}
   };
-  FixedQueue<QueuedWrite,128> writes;
+  FixedQueue<QueuedWrite,512> writes;
 
   unsigned char filtControl, filtRes, vol;
   unsigned char writeOscBuf;
   unsigned char sidCore;
   int filtCut, resetTime, initResetTime;
 
+  // block clocking: reSID/reSIDfp run in bursts and output at the host rate
+  bool blockClock;
+  int hostRate, blockCycles;
+  short blockOut[256];
+  int blockOutPos, blockOutLen;
+
   bool keyPriority, sidIs6581, needInitTables, no1EUpdate, multiplyRel, macroRace;
   unsigned char chanOrder[3];
   unsigned char testAD, testSR;
@@ -87,6 +95,13 @@ class DivPlatformC64: public DivDispatch {
   int coreQuality;
   unsigned char regPool[32];
   
+  struct State {
+    Channel chan[3];
+    unsigned char filtControl, filtRes, vol;
+    int filtCut, resetTime;
+    unsigned char chanOrder[3];
+  };
+
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
 
@@ -94,15 +109,22 @@ class DivPlatformC64: public DivDispatch {
 
   void acquire_classic(short* bufL, short* bufR, size_t start, size_t len);
   void acquire_fp(short* bufL, short* bufR, size_t start, size_t len);
+  void acquire_block(short** buf, size_t len);
 
   void updateFilter();
   public:
     void acquire(short** buf, size_t len);
+    void setRenderPos(int pos);
+    bool getRenderPerBuffer();
+    bool getRenderFlushNeeded();
     int dispatch(DivCommand c);
     void* getChanState(int chan);
     DivDispatchOscBuffer* getOscBuffer(int chan);
     unsigned char* getRegisterPool();
     int getRegisterPoolSize();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void reset();
     void forceIns();
     void tick(bool sysTick=true);
@@ -50,7 +50,7 @@ void DivPlatformESFM::acquire(short** buf, size_t len) {
     }
 
     ESFM_generate(&chip,o);
-    for (int c=0; c<18; c++) {
+    if (!skipOscWrites) for (int c=0; c<18; c++) {
       oscBuf[c]->data[oscBuf[c]->needle++]=ESFM_get_channel_output_native(&chip,c);
     }
 
@@ -62,7 +62,7 @@ void DivPlatformFDS::acquire_puNES(short* buf, size_t len) {
     if (sample>32767) sample=32767;
     if (sample<-32768) sample=-32768;
     buf[i]=sample;
-    if (++writeOscBuf>=32) {
+    if (!skipOscWrites && ++writeOscBuf>=32) {
       writeOscBuf=0;
       oscBuf->data[oscBuf->needle++]=sample*3;
     }
@@ -78,7 +78,7 @@ void DivPlatformFDS::acquire_NSFPlay(short* buf, size_t len) {
     if (sample>32767) sample=32767;
     if (sample<-32768) sample=-32768;
     buf[i]=sample;
-    if (++writeOscBuf>=32) {
+    if (!skipOscWrites && ++writeOscBuf>=32) {
       writeOscBuf=0;
       oscBuf->data[oscBuf->needle++]=sample*3;
     }
@@ -87,7 +87,7 @@ void DivPlatformGBADMA::acquire(short** buf, size_t len) {
         outL[i]=(chan[i].pan&2)?out:0;
         outR[i]=(chan[i].pan&1)?out:0;
       }
-      oscBuf[i]->data[oscBuf[i]->needle++]=(short)((outL[i]+outR[i])<<5);
+      if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=(short)((outL[i]+outR[i])<<5);
     }
     int l=outL[0]+outL[1];
     int r=outR[0]+outR[1];
@@ -132,10 +132,10 @@ void DivPlatformGBAMinMod::acquire(short** buf, size_t len) {
     }
     buf[0][h]=sampL;
     buf[1][h]=sampR;
-    for (int i=0; i<chanMax; i++) {
+    if (!skipOscWrites) for (int i=0; i<chanMax; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=oscOut[i][sampPos];
     }
-    for (int i=chanMax; i<16; i++) {
+    if (!skipOscWrites) for (int i=chanMax; i<16; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=0;
     }
     while (updTimer>=updCycles) {
@@ -26,6 +26,9 @@
 #define CHIP_FREQBASE fmFreqBase
 #define CHIP_DIVIDER fmDivBase
 
+// maximum number of samples generated by ymfm at once
+#define YMFM_BATCH_SIZE 256
+
 #define IS_REALLY_MUTED(x) (isMuted[x] && (x<5 || !softPCM || (isMuted[5] && isMuted[6])))
 
 void DivYM2612Interface::ymfm_set_timer(uint32_t tnum, int32_t duration_in_clocks) {
@@ -181,6 +184,7 @@ void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
         os[1]+=o[1];
       }
       //OPN2_Write(&fm,0,0);
+      if (skipOscWrites) continue;
       if (i==5) {
         if (fm.dacen) {
           if (softPCM) {
@@ -214,13 +218,21 @@ void DivPlatformGenesis::acquire_nuked(short** buf, size_t len) {
 
 void DivPlatformGenesis::acquire_ymfm(short** buf, size_t len) {
   thread_local int os[2];
+  ymfm::ym2612::output_data out[YMFM_BATCH_SIZE];
+  ymfm::fm_debug_tap taps[6];
 
   ymfm::ym2612::fm_engine* fme=fm_ymfm->debug_engine();
 
-  for (size_t h=0; h<len; h++) {
+  for (int i=0; i<6; i++) {
+    taps[i].channel=i;
+    taps[i].source=ymfm::fm_debug_tap::OUTPUT_SUM;
+    taps[i].shift=5;
+  }
+
+  for (size_t h=0; h<len;) {
+    size_t batch=1;
     processDAC(rate);
   
-    os[0]=0; os[1]=0;
     if (!writes.empty()) {
       QueuedWrite& w=writes.front();
       fm_ymfm->write(0x0+((w.addr>>8)<<1),w.addr);
@@ -244,48 +256,64 @@ void DivPlatformGenesis::acquire_ymfm(short** buf, size_t len) {
         dacWrite=-1;
       }
       flushFirst=false;
+
+      // if nothing is pending, the DAC isn't being fed and the timers aren't
+      // running, the rest of the buffer may be generated at once
+      if (writes.empty() && !softPCM && !(chan[5].dacMode && chan[5].dacSample!=-1) && !iface.timersRunning()) {
+        batch=MIN(len-h,YMFM_BATCH_SIZE);
+      }
     }
-    
+
+    if (!skipOscWrites) for (int i=0; i<7; i++) {
+      batch=MIN(batch,(size_t)(65536-oscBuf[i]->needle));
+    }
+
+    // channel 6 is the DAC when it is enabled
+    bool dacEnabled=fm_ymfm->debug_dac_enable();
+    int tapCount=dacEnabled?5:6;
+    // without taps ymfm doesn't track per-channel output at all
+    if (skipOscWrites) tapCount=0;
+    for (int i=0; i<tapCount; i++) {
+      taps[i].data=&oscBuf[i]->data[oscBuf[i]->needle];
+      oscBuf[i]->needle+=batch;
+    }
+
+    fme->debug_set_taps(taps,tapCount);
     if (chipType==1) {
-      fm_ymfm->generate(&out_ymfm);
+      fm_ymfm->generate(out,batch);
     } else {
-      ((ymfm::ym3438*)fm_ymfm)->generate(&out_ymfm);
+      ((ymfm::ym3438*)fm_ymfm)->generate(out,batch);
     }
-    iface.clock();
-    os[0]=out_ymfm.data[0];
-    os[1]=out_ymfm.data[1];
-    //OPN2_Write(&fm,0,0);
+    fme->debug_set_taps(NULL,0);
 
-    for (int i=0; i<6; i++) {
-      int chOut=(fme->debug_channel(i)->debug_output(0)+fme->debug_channel(i)->debug_output(1))<<5;
-      if (chOut<-32768) chOut=-32768;
-      if (chOut>32767) chOut=32767;
-      if (i==5) {
-        if (fm_ymfm->debug_dac_enable()) {
+    for (size_t i=0; i<batch; i++, h++) {
+      iface.clock();
+
+      if (!skipOscWrites) {
+        if (dacEnabled) {
           if (softPCM) {
             oscBuf[5]->data[oscBuf[5]->needle++]=chan[5].dacOutput<<6;
             oscBuf[6]->data[oscBuf[6]->needle++]=chan[6].dacOutput<<6;
           } else {
-            oscBuf[i]->data[oscBuf[i]->needle++]=((fm_ymfm->debug_dac_data()^0x100)-0x100)<<6;
+            oscBuf[5]->data[oscBuf[5]->needle++]=((fm_ymfm->debug_dac_data()^0x100)-0x100)<<6;
             oscBuf[6]->data[oscBuf[6]->needle++]=0;
           }
         } else {
-          oscBuf[i]->data[oscBuf[i]->needle++]=chOut;
           oscBuf[6]->data[oscBuf[6]->needle++]=0;
         }
-      } else {
-        oscBuf[i]->data[oscBuf[i]->needle++]=chOut;
       }
-    }
-    
-    if (os[0]<-32768) os[0]=-32768;
-    if (os[0]>32767) os[0]=32767;
 
-    if (os[1]<-32768) os[1]=-32768;
-    if (os[1]>32767) os[1]=32767;
-  
-    buf[0][h]=os[0];
-    buf[1][h]=os[1];
+      os[0]=out[i].data[0];
+      if (os[0]<-32768) os[0]=-32768;
+      if (os[0]>32767) os[0]=32767;
+
+      os[1]=out[i].data[1];
+      if (os[1]<-32768) os[1]=-32768;
+      if (os[1]>32767) os[1]=32767;
+    
+      buf[0][h]=os[0];
+      buf[1][h]=os[1];
+    }
   }
 }
 
@@ -300,6 +328,8 @@ void DivPlatformGenesis::acquire276OscSub() {
   }
 
   llePrevCycle=fm_276.fsm_cnt2[1];
+  // the cycle counter is re-synchronized above once writes resume
+  if (skipOscWrites) return;
 
   if (fm_276.flags==fmopn2_flags_ym3438) {
     lleOscData[lleCycle/(24*2)]+=fm_276.out_l+fm_276.out_r;
@@ -1596,6 +1626,47 @@ int DivPlatformGenesis::getRegisterPoolSize() {
   return 512;
 }
 
+void DivPlatformGenesis::storeState(State* s) {
+  for (int i=0; i<10; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->softPCMTimer=softPCMTimer;
+  s->dacWrite=dacWrite;
+  s->lfoValue=lfoValue;
+  s->lastExtChPan=lastExtChPan;
+  s->extMode=extMode;
+  s->canWriteDAC=canWriteDAC;
+  s->flushFirst=flushFirst;
+}
+
+void DivPlatformGenesis::restoreState(const State* s) {
+  for (int i=0; i<10; i++) {
+    chan[i]=s->chan[i];
+  }
+  softPCMTimer=s->softPCMTimer;
+  dacWrite=s->dacWrite;
+  lfoValue=s->lfoValue;
+  lastExtChPan=s->lastExtChPan;
+  extMode=s->extMode;
+  canWriteDAC=s->canWriteDAC;
+  flushFirst=s->flushFirst;
+}
+
+void* DivPlatformGenesis::getState() {
+  State* s=new State;
+  storeState(s);
+  return s;
+}
+
+void DivPlatformGenesis::setState(void* state) {
+  if (state==NULL) return;
+  restoreState((State*)state);
+}
+
+void DivPlatformGenesis::freeState(void* state) {
+  delete (State*)state;
+}
+
 float DivPlatformGenesis::getPostAmp() {
   return 2.0f;
 }
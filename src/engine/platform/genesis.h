@@ -33,8 +33,13 @@ class DivYM2612Interface: public ymfm::ymfm_interface {
   public:
     void clock();
     void ymfm_set_timer(uint32_t tnum, int32_t duration_in_clocks);
+    bool timersRunning() {
+      return setA>=0 || setB>=0;
+    }
     DivYM2612Interface():
       ymfm::ymfm_interface(),
+      setA(-1),
+      setB(-1),
       countA(0),
       countB(0) {}
 };
@@ -82,7 +87,6 @@ class DivPlatformGenesis: public DivPlatformOPN {
     fmopn2_t fm_276;
 
     ymfm::ym2612* fm_ymfm;
-    ymfm::ym2612::output_data out_ymfm;
     DivYM2612Interface iface;
 
     int softPCMTimer;
@@ -98,6 +102,17 @@ class DivPlatformGenesis: public DivPlatformOPN {
     int dacShifter, o_lro, o_bco;
   
     unsigned char dacVolTable[128];
+
+    struct State {
+      Channel chan[10];
+      int softPCMTimer;
+      short dacWrite;
+      unsigned char lfoValue, lastExtChPan;
+      bool extMode, canWriteDAC, flushFirst;
+    };
+
+    void storeState(State* s);
+    void restoreState(const State* s);
   
     friend void putDispatchChip(void*,int);
     friend void putDispatchChan(void*,int,int);
@@ -123,6 +138,9 @@ class DivPlatformGenesis: public DivPlatformOPN {
     virtual int mapVelocity(int ch, float vel);
     unsigned char* getRegisterPool();
     int getRegisterPoolSize();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void reset();
     void forceIns();
     void tick(bool sysTick=true);
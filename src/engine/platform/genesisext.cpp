@@ -790,6 +790,28 @@ void* DivPlatformGenesisExt::getChanState(int ch) {
   return &chan[ch];
 }
 
+void* DivPlatformGenesisExt::getState() {
+  StateExt* s=new StateExt;
+  storeState(s);
+  for (int i=0; i<4; i++) {
+    s->opChan[i]=opChan[i];
+  }
+  return s;
+}
+
+void DivPlatformGenesisExt::setState(void* state) {
+  if (state==NULL) return;
+  StateExt* s=(StateExt*)state;
+  restoreState(s);
+  for (int i=0; i<4; i++) {
+    opChan[i]=s->opChan[i];
+  }
+}
+
+void DivPlatformGenesisExt::freeState(void* state) {
+  delete (StateExt*)state;
+}
+
 DivMacroInt* DivPlatformGenesisExt::getChanMacroInt(int ch) {
   if (ch>=6) return &chan[ch-3].std;
   if (ch>=2) return &opChan[ch-2].std;
@@ -30,6 +30,10 @@ class DivPlatformGenesisExt: public DivPlatformGenesis {
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
   inline void commitStateExt(int ch, DivInstrument* ins);
+
+  struct StateExt: public State {
+    OPNOpChannelStereo opChan[4];
+  };
   public:
     int dispatch(DivCommand c);
     void* getChanState(int chan);
@@ -37,6 +41,9 @@ class DivPlatformGenesisExt: public DivPlatformGenesis {
     unsigned short getPan(int chan);
     DivDispatchOscBuffer* getOscBuffer(int chan);
     int mapVelocity(int ch, float vel);
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void reset();
     void forceIns();
     void tick(bool sysTick=true);
@@ -80,7 +80,7 @@ void DivPlatformK007232::acquire(short** buf, size_t len) {
       buf[1][h]=(rout[0]+rout[1])<<4;
       if (++oscDivider>=8) {
         oscDivider=0;
-        for (int i=0; i<2; i++) {
+        if (!skipOscWrites) for (int i=0; i<2; i++) {
           oscBuf[i]->data[oscBuf[i]->needle++]=(lout[i]+rout[i])<<3;
         }
       }
@@ -90,7 +90,7 @@ void DivPlatformK007232::acquire(short** buf, size_t len) {
       buf[0][h]=(out[0]+out[1])<<4;
       if (++oscDivider>=8) {
         oscDivider=0;
-        for (int i=0; i<2; i++) {
+        if (!skipOscWrites) for (int i=0; i<2; i++) {
           oscBuf[i]->data[oscBuf[i]->needle++]=out[i]<<4;
         }
       }
@@ -36,6 +36,9 @@
 
 #define CHIP_FREQBASE 16000000
 
+// in tuned mode the divider follows the duty, so don't cache pitch tables for it
+#define NOTE_LYNX(x) round(parent->calcBaseFreq(chipClock,CHIP_DIVIDER,x,true,!tuned))
+
 static int32_t clamp(int32_t v, int32_t lo, int32_t hi)
 {
   return v<lo?lo:(v>hi?hi:v);
@@ -153,7 +156,7 @@ void DivPlatformLynx::acquire(short** buf, size_t len) {
       }
     }
 
-    mikey->sampleAudio(buf[0]+h,buf[1]+h,1,oscBuf);
+    mikey->sampleAudio(buf[0]+h,buf[1]+h,1,skipOscWrites?NULL:oscBuf);
   }
 }
 
@@ -174,7 +177,7 @@ void DivPlatformLynx::tick(bool sysTick) {
       if (!chan[i].inPorta) {
         double CHIP_DIVIDER=tuned?DUTY_DIVIDERS[chan[i].duty.val&0x1ff]*8:64;
         chan[i].actualNote=parent->calcArp(chan[i].note,chan[i].std.arp.val);
-        chan[i].baseFreq=NOTE_PERIODIC(chan[i].actualNote);
+        chan[i].baseFreq=NOTE_LYNX(chan[i].actualNote);
         if (chan[i].pcm) chan[i].sampleBaseFreq=NOTE_FREQUENCY(chan[i].actualNote);
         chan[i].freqChanged=true;
       }
@@ -249,7 +252,7 @@ void DivPlatformLynx::tick(bool sysTick) {
           }
         }
         double divider=tuned?DUTY_DIVIDERS[chan[i].duty.val&0x1ff]*8:64;
-        chan[i].fd=parent->calcFreq(chan[i].baseFreq,chan[i].pitch,chan[i].fixedArp?chan[i].baseNoteOverride:chan[i].arpOff,chan[i].fixedArp,true,0,chan[i].pitch2,chipClock,divider);
+        chan[i].fd=parent->calcFreq(chan[i].baseFreq,chan[i].pitch,chan[i].fixedArp?chan[i].baseNoteOverride:chan[i].arpOff,chan[i].fixedArp,true,0,chan[i].pitch2,chipClock,divider,0,!tuned);
         WRITE_CONTROL(i, (chan[i].fd.clockDivider|0x18|chan[i].duty.int_feedback7));
         WRITE_BACKUP( i, chan[i].fd.backup );
       }
@@ -259,7 +262,7 @@ void DivPlatformLynx::tick(bool sysTick) {
       if (!chan[i].pcm) {
         if (tuned) {
           double divider=DUTY_DIVIDERS[chan[i].duty.val&0x1ff]*8;
-          chan[i].fd=parent->calcFreq(chan[i].baseFreq,chan[i].pitch,chan[i].fixedArp?chan[i].baseNoteOverride:chan[i].arpOff,chan[i].fixedArp,true,0,chan[i].pitch2,chipClock,divider);
+          chan[i].fd=parent->calcFreq(chan[i].baseFreq,chan[i].pitch,chan[i].fixedArp?chan[i].baseNoteOverride:chan[i].arpOff,chan[i].fixedArp,true,0,chan[i].pitch2,chipClock,divider,0,!tuned);
         }
         WRITE_FEEDBACK(i, chan[i].duty.feedback);
         WRITE_CONTROL(i, (chan[i].fd.clockDivider|0x18|chan[i].duty.int_feedback7));
@@ -309,7 +312,7 @@ int DivPlatformLynx::dispatch(DivCommand c) {
         }
       }
       if (c.value!=DIV_NOTE_NULL) {
-        chan[c.chan].baseFreq=NOTE_PERIODIC(c.value);
+        chan[c.chan].baseFreq=NOTE_LYNX(c.value);
         chan[c.chan].freqChanged=true;
         chan[c.chan].note=c.value;
         chan[c.chan].actualNote=c.value;
@@ -369,7 +372,7 @@ int DivPlatformLynx::dispatch(DivCommand c) {
       chan[c.chan].freqChanged=true;
       break;
     case DIV_CMD_NOTE_PORTA: {
-      int destFreq=NOTE_PERIODIC(c.value2+chan[c.chan].sampleNoteDelta);
+      int destFreq=NOTE_LYNX(c.value2+chan[c.chan].sampleNoteDelta);
       bool return2=false;
       if (destFreq>chan[c.chan].baseFreq) {
         chan[c.chan].baseFreq+=c.value;
@@ -396,7 +399,7 @@ int DivPlatformLynx::dispatch(DivCommand c) {
     }
     case DIV_CMD_LEGATO: {
       int whatAMess=c.value+chan[c.chan].sampleNoteDelta+((HACKY_LEGATO_MESS)?(chan[c.chan].std.arp.val):(0));
-      chan[c.chan].baseFreq=NOTE_PERIODIC(whatAMess);
+      chan[c.chan].baseFreq=NOTE_LYNX(whatAMess);
       if (chan[c.chan].pcm) {
         chan[c.chan].sampleBaseFreq=NOTE_FREQUENCY(whatAMess);
       }
@@ -409,7 +412,7 @@ int DivPlatformLynx::dispatch(DivCommand c) {
       if (chan[c.chan].active && c.value2) {
         if (parent->song.resetMacroOnPorta) chan[c.chan].macroInit(parent->getIns(chan[c.chan].ins,DIV_INS_MIKEY));
       }
-      if (!chan[c.chan].inPorta && c.value && !parent->song.brokenPortaArp && chan[c.chan].std.arp.will && !NEW_ARP_STRAT) chan[c.chan].baseFreq=NOTE_PERIODIC(chan[c.chan].note);
+      if (!chan[c.chan].inPorta && c.value && !parent->song.brokenPortaArp && chan[c.chan].std.arp.will && !NEW_ARP_STRAT) chan[c.chan].baseFreq=NOTE_LYNX(chan[c.chan].note);
       chan[c.chan].inPorta=c.value;
       break;
     case DIV_CMD_SAMPLE_POS:
@@ -83,7 +83,7 @@ void DivPlatformMMC5::acquire(short** buf, size_t len) {
     if (sample<-32768) sample=-32768;
     buf[0][i]=sample;
 
-    if (++writeOscBuf>=32) {
+    if (!skipOscWrites && ++writeOscBuf>=32) {
       writeOscBuf=0;
       oscBuf[0]->data[oscBuf[0]->needle++]=isMuted[0]?0:((mmc5->S3.output)<<11);
       oscBuf[1]->data[oscBuf[1]->needle++]=isMuted[1]?0:((mmc5->S4.output)<<11);
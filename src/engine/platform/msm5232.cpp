@@ -56,7 +56,7 @@ void DivPlatformMSM5232::acquire(short** buf, size_t len) {
 
     for (int i=0; i<8; i++) {
       if (isMuted[i]) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=0;
+        if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=0;
       } else {
         int o=(
           ((regPool[12+(i>>2)]&1)?((msm->vo16[i]*partVolume[3+(i&4)])>>8):0)+
@@ -64,7 +64,7 @@ void DivPlatformMSM5232::acquire(short** buf, size_t len) {
           ((regPool[12+(i>>2)]&4)?((msm->vo4[i]*partVolume[1+(i&4)])>>8):0)+
           ((regPool[12+(i>>2)]&8)?((msm->vo2[i]*partVolume[i&4])>>8):0)
         )<<2;
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(o,-32768,32767);
+        if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(o,-32768,32767);
       }
     }
 
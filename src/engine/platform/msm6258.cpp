@@ -86,11 +86,11 @@ void DivPlatformMSM6258::acquire(short** buf, size_t len) {
     if (isMuted[0]) {
       buf[0][h]=0;
       buf[1][h]=0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=0;
+      if (!skipOscWrites) oscBuf[0]->data[oscBuf[0]->needle++]=0;
     } else {
       buf[0][h]=(msmPan&2)?msmOut:0;
       buf[1][h]=(msmPan&1)?msmOut:0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=msmPan?(msmOut>>1):0;
+      if (!skipOscWrites) oscBuf[0]->data[oscBuf[0]->needle++]=msmPan?(msmOut>>1):0;
     }
   }
 }
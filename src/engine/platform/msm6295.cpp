@@ -94,7 +94,7 @@ void DivPlatformMSM6295::acquire(short** buf, size_t len) {
 
     if (++updateOsc>=22) {
       updateOsc=0;
-      for (int i=0; i<4; i++) {
+      if (!skipOscWrites) for (int i=0; i<4; i++) {
         oscBuf[i]->data[oscBuf[i]->needle++]=msm.voice_out(i)<<5;
       }
     }
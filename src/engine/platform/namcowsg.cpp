@@ -176,7 +176,7 @@ void DivPlatformNamcoWSG::acquire(short** buf, size_t len) {
       buf[0]+h, buf[1]+h
     };
     namco->sound_stream_update(bufC,1);
-    for (int i=0; i<chans; i++) {
+    if (!skipOscWrites) for (int i=0; i<chans; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=(namco->m_channel_list[i].last_out*chans)>>1;
     }
   }
@@ -80,7 +80,7 @@ void DivPlatformNDS::acquire(short** buf, size_t len) {
     buf[0][i]=lout;
     buf[1][i]=rout;
 
-    for (int i=0; i<16; i++) {
+    if (!skipOscWrites) for (int i=0; i<16; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=(nds.chan_lout(i)+nds.chan_rout(i))>>1;
     }
   }
@@ -118,7 +118,7 @@ void DivPlatformNES::acquire_puNES(short** buf, size_t len) {
     if (sample>32767) sample=32767;
     if (sample<-32768) sample=-32768;
     buf[0][i]=sample;
-    if (++writeOscBuf>=32) {
+    if (!skipOscWrites && ++writeOscBuf>=32) {
       writeOscBuf=0;
       oscBuf[0]->data[oscBuf[0]->needle++]=isMuted[0]?0:(nes->S1.output<<11);
       oscBuf[1]->data[oscBuf[1]->needle++]=isMuted[1]?0:(nes->S2.output<<11);
@@ -145,7 +145,7 @@ void DivPlatformNES::acquire_NSFPlay(short** buf, size_t len) {
     if (sample>32767) sample=32767;
     if (sample<-32768) sample=-32768;
     buf[0][i]=sample;
-    if (++writeOscBuf>=4) {
+    if (!skipOscWrites && ++writeOscBuf>=4) {
       writeOscBuf=0;
       oscBuf[0]->data[oscBuf[0]->needle++]=nes1_NP->out[0]<<11;
       oscBuf[1]->data[oscBuf[1]->needle++]=nes1_NP->out[1]<<11;
@@ -172,7 +172,7 @@ void DivPlatformNES::acquire_NSFPlayE(short** buf, size_t len) {
     if (sample>32767) sample=32767;
     if (sample<-32768) sample=-32768;
     buf[0][i]=sample;
-    if (++writeOscBuf>=4) {
+    if (!skipOscWrites && ++writeOscBuf>=4) {
       writeOscBuf=0;
       oscBuf[0]->data[oscBuf[0]->needle++]=e1_NP->out[0]<<11;
       oscBuf[1]->data[oscBuf[1]->needle++]=e1_NP->out[1]<<11;
@@ -785,6 +785,58 @@ int DivPlatformNES::getRegisterPoolSize() {
   return 32;
 }
 
+void* DivPlatformNES::getState() {
+  State* s=new State;
+  for (int i=0; i<5; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->dacPeriod=dacPeriod;
+  s->dacRate=dacRate;
+  s->dpcmPos=dpcmPos;
+  s->dacPos=dacPos;
+  s->dacAntiClick=dacAntiClick;
+  s->dacSample=dacSample;
+  s->dpcmBank=dpcmBank;
+  s->sampleBank=sampleBank;
+  s->linearCount=linearCount;
+  s->nextDPCMFreq=nextDPCMFreq;
+  s->nextDPCMDelta=nextDPCMDelta;
+  s->lastDPCMFreq=lastDPCMFreq;
+  s->dpcmMode=dpcmMode;
+  s->dacAntiClickOn=dacAntiClickOn;
+  s->goingToLoop=goingToLoop;
+  s->countMode=countMode;
+  return s;
+}
+
+void DivPlatformNES::setState(void* state) {
+  if (state==NULL) return;
+  State* s=(State*)state;
+  for (int i=0; i<5; i++) {
+    chan[i]=s->chan[i];
+  }
+  dacPeriod=s->dacPeriod;
+  dacRate=s->dacRate;
+  dpcmPos=s->dpcmPos;
+  dacPos=s->dacPos;
+  dacAntiClick=s->dacAntiClick;
+  dacSample=s->dacSample;
+  dpcmBank=s->dpcmBank;
+  sampleBank=s->sampleBank;
+  linearCount=s->linearCount;
+  nextDPCMFreq=s->nextDPCMFreq;
+  nextDPCMDelta=s->nextDPCMDelta;
+  lastDPCMFreq=s->lastDPCMFreq;
+  dpcmMode=s->dpcmMode;
+  dacAntiClickOn=s->dacAntiClickOn;
+  goingToLoop=s->goingToLoop;
+  countMode=s->countMode;
+}
+
+void DivPlatformNES::freeState(void* state) {
+  delete (State*)state;
+}
+
 float DivPlatformNES::getPostAmp() {
   return 2.0f;
 }
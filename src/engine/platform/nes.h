@@ -74,6 +74,16 @@ class DivPlatformNES: public DivDispatch {
   unsigned int sampleOffDPCM[256];
   DivMemoryComposition memCompo;
 
+  struct State {
+    Channel chan[5];
+    int dacPeriod, dacRate, dpcmPos;
+    unsigned int dacPos, dacAntiClick;
+    int dacSample;
+    unsigned char dpcmBank, sampleBank, linearCount;
+    signed char nextDPCMFreq, nextDPCMDelta, lastDPCMFreq;
+    bool dpcmMode, dacAntiClickOn, goingToLoop, countMode;
+  };
+
   friend void putDispatchChip(void*,int);
   friend void putDispatchChan(void*,int,int);
 
@@ -91,6 +101,9 @@ class DivPlatformNES: public DivDispatch {
     DivDispatchOscBuffer* getOscBuffer(int chan);
     unsigned char* getRegisterPool();
     int getRegisterPoolSize();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void reset();
     void forceIns();
     void tick(bool sysTick=true);
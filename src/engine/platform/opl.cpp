@@ -23,6 +23,9 @@
 #include <string.h>
 #include <math.h>
 
+// maximum number of samples generated by ymfm at once
+#define YMFM_BATCH_SIZE 256
+
 #define rWrite(a,v) if (!skipRegisterWrites) {pendingWrites[a]=v;}
 #define immWrite(a,v) if (!skipRegisterWrites) {writes.push(QueuedWrite(a,v)); if (dumpWrites) {addWrite(a,v);} }
 
@@ -211,54 +214,56 @@ void DivPlatformOPL::acquire_nuked(short** buf, size_t len) {
       if (!isMuted[adpcmChan]) {
         os[0]-=aOut.data[0]>>3;
         os[1]-=aOut.data[0]>>3;
-        oscBuf[adpcmChan]->data[oscBuf[adpcmChan]->needle++]=aOut.data[0]>>1;
-      } else {
-        oscBuf[adpcmChan]->data[oscBuf[adpcmChan]->needle++]=0;
+      }
+      if (!skipOscWrites) {
+        oscBuf[adpcmChan]->data[oscBuf[adpcmChan]->needle++]=isMuted[adpcmChan]?0:(aOut.data[0]>>1);
       }
     }
 
-    if (fm.rhy&0x20) {
-      for (int i=0; i<melodicChans+1; i++) {
-        unsigned char ch=outChanMap[i];
-        int chOut=0;
-        if (ch==255) continue;
-        if (fm.channel[i].out[0]!=NULL) {
-          chOut+=*fm.channel[ch].out[0];
-        }
-        if (fm.channel[i].out[1]!=NULL) {
-          chOut+=*fm.channel[ch].out[1];
-        }
-        if (fm.channel[i].out[2]!=NULL) {
-          chOut+=*fm.channel[ch].out[2];
-        }
-        if (fm.channel[i].out[3]!=NULL) {
-          chOut+=*fm.channel[ch].out[3];
-        }
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<(i==melodicChans?1:2),-32768,32767);
-      }
-      // special
-      oscBuf[melodicChans+1]->data[oscBuf[melodicChans+1]->needle++]=fm.slot[16].out*4;
-      oscBuf[melodicChans+2]->data[oscBuf[melodicChans+2]->needle++]=fm.slot[14].out*4;
-      oscBuf[melodicChans+3]->data[oscBuf[melodicChans+3]->needle++]=fm.slot[17].out*4;
-      oscBuf[melodicChans+4]->data[oscBuf[melodicChans+4]->needle++]=fm.slot[13].out*4;
-    } else {
-      for (int i=0; i<chans; i++) {
-        unsigned char ch=outChanMap[i];
-        int chOut=0;
-        if (ch==255) continue;
-        if (fm.channel[i].out[0]!=NULL) {
-          chOut+=*fm.channel[ch].out[0];
-        }
-        if (fm.channel[i].out[1]!=NULL) {
-          chOut+=*fm.channel[ch].out[1];
-        }
-        if (fm.channel[i].out[2]!=NULL) {
-          chOut+=*fm.channel[ch].out[2];
+    if (!skipOscWrites) {
+      if (fm.rhy&0x20) {
+        for (int i=0; i<melodicChans+1; i++) {
+          unsigned char ch=outChanMap[i];
+          int chOut=0;
+          if (ch==255) continue;
+          if (fm.channel[i].out[0]!=NULL) {
+            chOut+=*fm.channel[ch].out[0];
+          }
+          if (fm.channel[i].out[1]!=NULL) {
+            chOut+=*fm.channel[ch].out[1];
+          }
+          if (fm.channel[i].out[2]!=NULL) {
+            chOut+=*fm.channel[ch].out[2];
+          }
+          if (fm.channel[i].out[3]!=NULL) {
+            chOut+=*fm.channel[ch].out[3];
+          }
+          oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<(i==melodicChans?1:2),-32768,32767);
         }
-        if (fm.channel[i].out[3]!=NULL) {
-          chOut+=*fm.channel[ch].out[3];
+        // special
+        oscBuf[melodicChans+1]->data[oscBuf[melodicChans+1]->needle++]=fm.slot[16].out*4;
+        oscBuf[melodicChans+2]->data[oscBuf[melodicChans+2]->needle++]=fm.slot[14].out*4;
+        oscBuf[melodicChans+3]->data[oscBuf[melodicChans+3]->needle++]=fm.slot[17].out*4;
+        oscBuf[melodicChans+4]->data[oscBuf[melodicChans+4]->needle++]=fm.slot[13].out*4;
+      } else {
+        for (int i=0; i<chans; i++) {
+          unsigned char ch=outChanMap[i];
+          int chOut=0;
+          if (ch==255) continue;
+          if (fm.channel[i].out[0]!=NULL) {
+            chOut+=*fm.channel[ch].out[0];
+          }
+          if (fm.channel[i].out[1]!=NULL) {
+            chOut+=*fm.channel[ch].out[1];
+          }
+          if (fm.channel[i].out[2]!=NULL) {
+            chOut+=*fm.channel[ch].out[2];
+          }
+          if (fm.channel[i].out[3]!=NULL) {
+            chOut+=*fm.channel[ch].out[3];
+          }
+          oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<2,-32768,32767);
         }
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<2,-32768,32767);
       }
     }
     
@@ -292,86 +297,143 @@ void DivPlatformOPL::acquire_nuked(short** buf, size_t len) {
   }
 }
 
-void DivPlatformOPL::acquire_ymfm1(short** buf, size_t len) {
-  ymfm::ymfm_output<1> out;
-
-  ymfm::ym3526::fm_engine* fme=fm_ymfm1->debug_fm_engine();
-  ymfm::fm_channel<ymfm::opl_registers_base<1>>* fmChan[9];
-
-  for (int i=0; i<9; i++) {
-    fmChan[i]=fme->debug_channel(i);
-  }
-
-  for (size_t h=0; h<len; h++) {
-    if (!writes.empty() && --delay<0) {
-      delay=1;
-      QueuedWrite& w=writes.front();
-
-      fm_ymfm1->write(0,w.addr);
-      fm_ymfm1->write(1,w.val);
-
-      regPool[w.addr&511]=w.val;
-      writes.pop();
+// set up the oscilloscope taps for the ymfm cores.
+// tapOsc receives the oscilloscope buffer of each tap.
+int DivPlatformOPL::setupYMFMTaps(ymfm::fm_debug_tap* taps, unsigned char* tapOsc, bool opl3) {
+  int count=0;
+  // without taps ymfm doesn't track per-channel output at all
+  if (skipOscWrites) return 0;
+  auto addTap=[&](int osc, int ch, unsigned char source, unsigned char shift) {
+    taps[count].data=NULL;
+    taps[count].channel=ch;
+    taps[count].source=source;
+    taps[count].shift=shift;
+    tapOsc[count]=osc;
+    count++;
+  };
+
+  if (opl3) {
+    if (properDrums) {
+      for (int i=0; i<16; i++) {
+        unsigned char ch=(i<12 && chan[i&(~1)].fourOp)?outChanMap[i^1]:outChanMap[i];
+        if (ch==255) continue;
+        addTap(i,ch,ymfm::fm_debug_tap::OUTPUT_FIRST,(i==15)?0:1);
+      }
+      addTap(16,7,ymfm::fm_debug_tap::SPECIAL2,1);
+      addTap(17,8,ymfm::fm_debug_tap::SPECIAL1,1);
+      addTap(18,8,ymfm::fm_debug_tap::SPECIAL2,1);
+      addTap(19,7,ymfm::fm_debug_tap::SPECIAL1,1);
+    } else {
+      for (int i=0; i<18; i++) {
+        unsigned char ch=outChanMap[i];
+        if (ch==255) continue;
+        addTap(i,ch,ymfm::fm_debug_tap::OUTPUT_FIRST,1);
+      }
     }
-
-    fm_ymfm1->generate(&out,1);
-
-    buf[0][h]=out.data[0];
-
+  } else {
     if (properDrums) {
       for (int i=0; i<7; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
+        addTap(i,i,ymfm::fm_debug_tap::OUTPUT_SUM,2);
       }
-      oscBuf[7]->data[oscBuf[7]->needle++]=CLAMP(fmChan[7]->debug_special1()<<2,-32768,32767);
-      oscBuf[8]->data[oscBuf[8]->needle++]=CLAMP(fmChan[8]->debug_special1()<<2,-32768,32767);
-      oscBuf[9]->data[oscBuf[9]->needle++]=CLAMP(fmChan[8]->debug_special2()<<2,-32768,32767);
-      oscBuf[10]->data[oscBuf[10]->needle++]=CLAMP(fmChan[7]->debug_special2()<<2,-32768,32767);
+      addTap(7,7,ymfm::fm_debug_tap::SPECIAL1,2);
+      addTap(8,8,ymfm::fm_debug_tap::SPECIAL1,2);
+      addTap(9,8,ymfm::fm_debug_tap::SPECIAL2,2);
+      addTap(10,7,ymfm::fm_debug_tap::SPECIAL2,2);
     } else {
       for (int i=0; i<9; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
+        addTap(i,i,ymfm::fm_debug_tap::OUTPUT_SUM,2);
       }
     }
   }
+  return count;
 }
 
-void DivPlatformOPL::acquire_ymfm2(short** buf, size_t len) {
-  ymfm::ymfm_output<1> out;
+// point the taps to the oscilloscope buffers and reserve space for the batch.
+// returns the batch size, which is limited so that no buffer wraps around.
+size_t DivPlatformOPL::bindYMFMTaps(ymfm::fm_debug_tap* taps, const unsigned char* tapOsc, int tapCount, size_t batch) {
+  for (int i=0; i<tapCount; i++) {
+    batch=MIN(batch,(size_t)(65536-oscBuf[tapOsc[i]]->needle));
+  }
+  for (int i=0; i<tapCount; i++) {
+    DivDispatchOscBuffer* ob=oscBuf[tapOsc[i]];
+    taps[i].data=&ob->data[ob->needle];
+    ob->needle+=batch;
+  }
+  return batch;
+}
 
-  ymfm::ym3812::fm_engine* fme=fm_ymfm2->debug_fm_engine();
-  ymfm::fm_channel<ymfm::opl_registers_base<2>>* fmChan[9];
+void DivPlatformOPL::acquire_ymfm1(short** buf, size_t len) {
+  ymfm::ymfm_output<1> out[YMFM_BATCH_SIZE];
+  ymfm::fm_debug_tap taps[20];
+  unsigned char tapOsc[20];
 
-  for (int i=0; i<9; i++) {
-    fmChan[i]=fme->debug_channel(i);
-  }
+  ymfm::ym3526::fm_engine* fme=fm_ymfm1->debug_fm_engine();
+  int tapCount=setupYMFMTaps(taps,tapOsc,false);
 
-  for (size_t h=0; h<len; h++) {
-    if (!writes.empty() && --delay<0) {
-      delay=1;
-      QueuedWrite& w=writes.front();
+  for (size_t h=0; h<len;) {
+    // one sample at a time while there are writes.
+    // after that the rest of the buffer is generated at once.
+    size_t batch=1;
+    if (!writes.empty()) {
+      if (--delay<0) {
+        delay=1;
+        QueuedWrite& w=writes.front();
 
-      fm_ymfm2->write(0,w.addr);
-      fm_ymfm2->write(1,w.val);
+        fm_ymfm1->write(0,w.addr);
+        fm_ymfm1->write(1,w.val);
 
-      regPool[w.addr&511]=w.val;
-      writes.pop();
+        regPool[w.addr&511]=w.val;
+        writes.pop();
+      }
+    } else {
+      batch=MIN(len-h,YMFM_BATCH_SIZE);
     }
 
-    fm_ymfm2->generate(&out,1);
+    batch=bindYMFMTaps(taps,tapOsc,tapCount,batch);
+    fme->debug_set_taps(taps,tapCount);
+    fm_ymfm1->generate(out,batch);
+    fme->debug_set_taps(NULL,0);
 
-    buf[0][h]=out.data[0];
+    for (size_t i=0; i<batch; i++, h++) {
+      buf[0][h]=out[i].data[0];
+    }
+  }
+}
 
-    if (properDrums) {
-      for (int i=0; i<7; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
+void DivPlatformOPL::acquire_ymfm2(short** buf, size_t len) {
+  ymfm::ymfm_output<1> out[YMFM_BATCH_SIZE];
+  ymfm::fm_debug_tap taps[20];
+  unsigned char tapOsc[20];
+
+  ymfm::ym3812::fm_engine* fme=fm_ymfm2->debug_fm_engine();
+  int tapCount=setupYMFMTaps(taps,tapOsc,false);
+
+  for (size_t h=0; h<len;) {
+    // one sample at a time while there are writes.
+    // after that the rest of the buffer is generated at once.
+    size_t batch=1;
+    if (!writes.empty()) {
+      if (--delay<0) {
+        delay=1;
+        QueuedWrite& w=writes.front();
+
+        fm_ymfm2->write(0,w.addr);
+        fm_ymfm2->write(1,w.val);
+
+        regPool[w.addr&511]=w.val;
+        writes.pop();
       }
-      oscBuf[7]->data[oscBuf[7]->needle++]=CLAMP(fmChan[7]->debug_special1()<<2,-32768,32767);
-      oscBuf[8]->data[oscBuf[8]->needle++]=CLAMP(fmChan[8]->debug_special1()<<2,-32768,32767);
-      oscBuf[9]->data[oscBuf[9]->needle++]=CLAMP(fmChan[8]->debug_special2()<<2,-32768,32767);
-      oscBuf[10]->data[oscBuf[10]->needle++]=CLAMP(fmChan[7]->debug_special2()<<2,-32768,32767);
     } else {
-      for (int i=0; i<9; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
-      }
+      batch=MIN(len-h,YMFM_BATCH_SIZE);
+    }
+
+    batch=bindYMFMTaps(taps,tapOsc,tapCount,batch);
+    fme->debug_set_taps(taps,tapCount);
+    fm_ymfm2->generate(out,batch);
+    fme->debug_set_taps(NULL,0);
+
+    for (size_t i=0; i<batch; i++, h++) {
+      buf[0][h]=out[i].data[0];
     }
   }
 }
@@ -403,103 +465,73 @@ void DivPlatformOPL::acquire_ymfm8950(short** buf, size_t len) {
 
     buf[0][h]=out.data[0];
 
-    if (properDrums) {
-      for (int i=0; i<7; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
-      }
-      oscBuf[7]->data[oscBuf[7]->needle++]=CLAMP(fmChan[7]->debug_special1()<<2,-32768,32767);
-      oscBuf[8]->data[oscBuf[8]->needle++]=CLAMP(fmChan[8]->debug_special1()<<2,-32768,32767);
-      oscBuf[9]->data[oscBuf[9]->needle++]=CLAMP(fmChan[8]->debug_special2()<<2,-32768,32767);
-      oscBuf[10]->data[oscBuf[10]->needle++]=CLAMP(fmChan[7]->debug_special2()<<2,-32768,32767);
-      oscBuf[11]->data[oscBuf[11]->needle++]=CLAMP(abe->get_last_out(0),-32768,32767);
-    } else {
-      for (int i=0; i<9; i++) {
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
+    if (!skipOscWrites) {
+      if (properDrums) {
+        for (int i=0; i<7; i++) {
+          oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
+        }
+        oscBuf[7]->data[oscBuf[7]->needle++]=CLAMP(fmChan[7]->debug_special1()<<2,-32768,32767);
+        oscBuf[8]->data[oscBuf[8]->needle++]=CLAMP(fmChan[8]->debug_special1()<<2,-32768,32767);
+        oscBuf[9]->data[oscBuf[9]->needle++]=CLAMP(fmChan[8]->debug_special2()<<2,-32768,32767);
+        oscBuf[10]->data[oscBuf[10]->needle++]=CLAMP(fmChan[7]->debug_special2()<<2,-32768,32767);
+        oscBuf[11]->data[oscBuf[11]->needle++]=CLAMP(abe->get_last_out(0),-32768,32767);
+      } else {
+        for (int i=0; i<9; i++) {
+          oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fmChan[i]->debug_output(0)<<2,-32768,32767);
+        }
+        oscBuf[9]->data[oscBuf[9]->needle++]=CLAMP(abe->get_last_out(0),-32768,32767);
       }
-      oscBuf[9]->data[oscBuf[9]->needle++]=CLAMP(abe->get_last_out(0),-32768,32767);
     }
   }
 }
 
 void DivPlatformOPL::acquire_ymfm3(short** buf, size_t len) {
-  ymfm::ymfm_output<4> out;
+  ymfm::ymfm_output<4> out[YMFM_BATCH_SIZE];
+  ymfm::fm_debug_tap taps[20];
+  unsigned char tapOsc[20];
 
   ymfm::ymf262::fm_engine* fme=fm_ymfm3->debug_fm_engine();
-  ymfm::fm_channel<ymfm::opl_registers_base<3>>* fmChan[18];
+  int tapCount=setupYMFMTaps(taps,tapOsc,true);
 
-  for (int i=0; i<18; i++) {
-    fmChan[i]=fme->debug_channel(i);
-  }
+  for (size_t h=0; h<len;) {
+    // one sample at a time while there are writes.
+    // after that the rest of the buffer is generated at once.
+    size_t batch=1;
+    if (!writes.empty()) {
+      if (--delay<0) {
+        delay=1;
+        QueuedWrite& w=writes.front();
 
-  for (size_t h=0; h<len; h++) {
-    if (!writes.empty() && --delay<0) {
-      delay=1;
-      QueuedWrite& w=writes.front();
+        fm_ymfm3->write((w.addr&0x100)?2:0,w.addr);
+        fm_ymfm3->write(1,w.val);
 
-      fm_ymfm3->write((w.addr&0x100)?2:0,w.addr);
-      fm_ymfm3->write(1,w.val);
-
-      regPool[w.addr&511]=w.val;
-      writes.pop();
+        regPool[w.addr&511]=w.val;
+        writes.pop();
+      }
+    } else {
+      batch=MIN(len-h,YMFM_BATCH_SIZE);
     }
 
-    fm_ymfm3->generate(&out,1);
+    batch=bindYMFMTaps(taps,tapOsc,tapCount,batch);
+    fme->debug_set_taps(taps,tapCount);
+    fm_ymfm3->generate(out,batch);
+    fme->debug_set_taps(NULL,0);
 
-    buf[0][h]=out.data[0]>>1;
-    if (totalOutputs>1) {
-      buf[1][h]=out.data[1]>>1;
-    }
-    if (totalOutputs>2) {
-      buf[2][h]=out.data[2]>>1;
-    }
-    if (totalOutputs>3) {
-      buf[3][h]=out.data[3]>>1;
-    }
-    if (totalOutputs==6) {
-      // placeholder for OPL4
-      buf[4][h]=0;
-      buf[5][h]=0;
-    }
-
-    if (properDrums) {
-      for (int i=0; i<16; i++) {
-        unsigned char ch=(i<12 && chan[i&(~1)].fourOp)?outChanMap[i^1]:outChanMap[i];
-        if (ch==255) continue;
-        int chOut=fmChan[ch]->debug_output(0);
-        if (chOut==0) {
-          chOut=fmChan[ch]->debug_output(1);
-        }
-        if (chOut==0) {
-          chOut=fmChan[ch]->debug_output(2);
-        }
-        if (chOut==0) {
-          chOut=fmChan[ch]->debug_output(3);
-        }
-        if (i==15) {
-          oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut,-32768,32767);
-        } else {
-          oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<1,-32768,32767);
-        }
+    for (size_t i=0; i<batch; i++, h++) {
+      buf[0][h]=out[i].data[0]>>1;
+      if (totalOutputs>1) {
+        buf[1][h]=out[i].data[1]>>1;
       }
-      oscBuf[16]->data[oscBuf[16]->needle++]=CLAMP(fmChan[7]->debug_special2()<<1,-32768,32767);
-      oscBuf[17]->data[oscBuf[17]->needle++]=CLAMP(fmChan[8]->debug_special1()<<1,-32768,32767);
-      oscBuf[18]->data[oscBuf[18]->needle++]=CLAMP(fmChan[8]->debug_special2()<<1,-32768,32767);
-      oscBuf[19]->data[oscBuf[19]->needle++]=CLAMP(fmChan[7]->debug_special1()<<1,-32768,32767);
-    } else {
-      for (int i=0; i<18; i++) {
-        unsigned char ch=outChanMap[i];
-        if (ch==255) continue;
-        int chOut=fmChan[ch]->debug_output(0);
-        if (chOut==0) {
-          chOut=fmChan[ch]->debug_output(1);
-        }
-        if (chOut==0) {
-          chOut=fmChan[ch]->debug_output(2);
-        }
-        if (chOut==0) {
-          chOut=fmChan[ch]->debug_output(3);
-        }
-        oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(chOut<<1,-32768,32767);
+      if (totalOutputs>2) {
+        buf[2][h]=out[i].data[2]>>1;
+      }
+      if (totalOutputs>3) {
+        buf[3][h]=out[i].data[3]>>1;
+      }
+      if (totalOutputs==6) {
+        // placeholder for OPL4
+        buf[4][h]=0;
+        buf[5][h]=0;
       }
     }
   }
@@ -641,7 +673,7 @@ void DivPlatformOPL::acquire_nukedLLE2(short** buf, size_t len) {
       }
     }
 
-    for (int i=0; i<11; i++) {
+    if (!skipOscWrites) for (int i=0; i<11; i++) {
       if (i>=6 && properDrums) {
         chOut[i]<<=1;
       } else {
@@ -659,9 +691,9 @@ void DivPlatformOPL::acquire_nukedLLE2(short** buf, size_t len) {
 
       if (!isMuted[adpcmChan]) {
         dacOut-=aOut.data[0]>>3;
-        oscBuf[adpcmChan]->data[oscBuf[adpcmChan]->needle++]=aOut.data[0]>>1;
-      } else {
-        oscBuf[adpcmChan]->data[oscBuf[adpcmChan]->needle++]=0;
+      }
+      if (!skipOscWrites) {
+        oscBuf[adpcmChan]->data[oscBuf[adpcmChan]->needle++]=isMuted[adpcmChan]?0:(aOut.data[0]>>1);
       }
     }
 
@@ -772,7 +804,7 @@ void DivPlatformOPL::acquire_nukedLLE3(short** buf, size_t len) {
       }
     }
 
-    for (int i=0; i<20; i++) {
+    if (!skipOscWrites) for (int i=0; i<20; i++) {
       /*if (i>=15 && properDrums) {
         chOut[i]<<=1;
       } else {
@@ -826,7 +858,7 @@ double DivPlatformOPL::NOTE_ADPCMB(int note) {
   if (adpcmChan<0) return 0;
   if (chan[adpcmChan].sample>=0 && chan[adpcmChan].sample<parent->song.sampleLen) {
     double off=65535.0*(double)(parent->getSample(chan[adpcmChan].sample)->centerRate)/8363.0;
-    return parent->calcBaseFreq((double)chipClock/144,off,note,false);
+    return parent->calcBaseFreq((double)chipClock/144,off,note,false,false);
   }
   return 0;
 }
@@ -1059,7 +1091,7 @@ void DivPlatformOPL::tick(bool sysTick) {
     if (chan[adpcmChan].freqChanged || chan[adpcmChan].keyOn || chan[adpcmChan].keyOff) {
       if (chan[adpcmChan].sample>=0 && chan[adpcmChan].sample<parent->song.sampleLen) {
         double off=65535.0*(double)(parent->getSample(chan[adpcmChan].sample)->centerRate)/8363.0;
-        chan[adpcmChan].freq=parent->calcFreq(chan[adpcmChan].baseFreq,chan[adpcmChan].pitch,chan[adpcmChan].fixedArp?chan[adpcmChan].baseNoteOverride:chan[adpcmChan].arpOff,chan[adpcmChan].fixedArp,false,4,chan[adpcmChan].pitch2,(double)chipClock/144,off);
+        chan[adpcmChan].freq=parent->calcFreq(chan[adpcmChan].baseFreq,chan[adpcmChan].pitch,chan[adpcmChan].fixedArp?chan[adpcmChan].baseNoteOverride:chan[adpcmChan].arpOff,chan[adpcmChan].fixedArp,false,4,chan[adpcmChan].pitch2,(double)chipClock/144,off,0,false);
       } else {
         chan[adpcmChan].freq=0;
       }
@@ -2148,6 +2180,54 @@ int DivPlatformOPL::getRegisterPoolSize() {
   return (oplType<3)?256:512;
 }
 
+void* DivPlatformOPL::getState() {
+  State* s=new State;
+  for (int i=0; i<20; i++) {
+    s->chan[i]=chan[i];
+  }
+  for (int i=0; i<5; i++) {
+    s->drumVol[i]=drumVol[i];
+  }
+  s->chanMap=chanMap;
+  s->melodicChans=melodicChans;
+  s->totalChans=totalChans;
+  s->sampleBank=sampleBank;
+  s->drumState=drumState;
+  s->lfoValue=lfoValue;
+  s->properDrums=properDrums;
+  s->dam=dam;
+  s->dvb=dvb;
+  s->update4OpMask=update4OpMask;
+  return s;
+}
+
+void DivPlatformOPL::setState(void* state) {
+  if (state==NULL) return;
+  State* s=(State*)state;
+  for (int i=0; i<20; i++) {
+    chan[i]=s->chan[i];
+  }
+  for (int i=0; i<5; i++) {
+    drumVol[i]=s->drumVol[i];
+  }
+  chanMap=s->chanMap;
+  melodicChans=s->melodicChans;
+  totalChans=s->totalChans;
+  sampleBank=s->sampleBank;
+  drumState=s->drumState;
+  lfoValue=s->lfoValue;
+  properDrums=s->properDrums;
+  slots=properDrums?slotsDrums:slotsNonDrums;
+  iface.sampleBank=sampleBank;
+  dam=s->dam;
+  dvb=s->dvb;
+  update4OpMask=s->update4OpMask;
+}
+
+void DivPlatformOPL::freeState(void* state) {
+  delete (State*)state;
+}
+
 void DivPlatformOPL::reset() {
   while (!writes.empty()) writes.pop();
   memset(regPool,0,512);
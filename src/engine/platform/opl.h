@@ -134,9 +134,21 @@ class DivPlatformOPL: public DivDispatch {
     double NOTE_ADPCMB(int note);
     void commitState(int ch, DivInstrument* ins);
 
+    struct State {
+      Channel chan[20];
+      const unsigned short* chanMap;
+      int melodicChans, totalChans, sampleBank;
+      unsigned char drumState, lfoValue;
+      unsigned char drumVol[5];
+      bool properDrums, dam, dvb, update4OpMask;
+    };
+
     friend void putDispatchChip(void*,int);
     friend void putDispatchChan(void*,int,int);
 
+    int setupYMFMTaps(ymfm::fm_debug_tap* taps, unsigned char* tapOsc, bool opl3);
+    size_t bindYMFMTaps(ymfm::fm_debug_tap* taps, const unsigned char* tapOsc, int tapCount, size_t batch);
+
     void acquire_nukedLLE2(short** buf, size_t len);
     void acquire_nukedLLE3(short** buf, size_t len);
     void acquire_nuked(short** buf, size_t len);
@@ -156,6 +168,9 @@ class DivPlatformOPL: public DivDispatch {
     int mapVelocity(int ch, float vel);
     unsigned char* getRegisterPool();
     int getRegisterPoolSize();
+    void* getState();
+    void setState(void* state);
+    void freeState(void* state);
     void reset();
     void forceIns();
     void tick(bool sysTick=true);
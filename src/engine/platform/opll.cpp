@@ -70,12 +70,12 @@ void DivPlatformOPLL::acquire_nuked(short** buf, size_t len) {
       unsigned char nextOut=cycleMapOPLL[fm.cycles];
       if ((nextOut>=6 && properDrums) || !isMuted[nextOut]) {
         os+=(o[0]+o[1]);
-        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->data[oscBuf[nextOut]->needle++]=(o[0]+o[1])<<6;
+        if (!skipOscWrites && (vrc7 || (fm.rm_enable&0x20))) oscBuf[nextOut]->data[oscBuf[nextOut]->needle++]=(o[0]+o[1])<<6;
       } else {
-        if (vrc7 || (fm.rm_enable&0x20)) oscBuf[nextOut]->data[oscBuf[nextOut]->needle++]=0;
+        if (!skipOscWrites && (vrc7 || (fm.rm_enable&0x20))) oscBuf[nextOut]->data[oscBuf[nextOut]->needle++]=0;
       }
     }
-    if (!(vrc7 || (fm.rm_enable&0x20))) for (int i=0; i<9; i++) {
+    if (!skipOscWrites && !(vrc7 || (fm.rm_enable&0x20))) for (int i=0; i<9; i++) {
       unsigned char ch=visMapOPLL[i];
       if ((i>=6 && properDrums) || !isMuted[ch]) {
         oscBuf[ch]->data[oscBuf[ch]->needle++]=(fm.output_ch[i])<<6;
@@ -113,7 +113,7 @@ void DivPlatformOPLL::acquire_emu(short** buf, size_t len) {
     
     buf[0][h]=os;
 
-    for (int i=0; i<11; i++) {
+    if (!skipOscWrites) for (int i=0; i<11; i++) {
       if (i>=6 && properDrums) {
         oscBuf[i]->data[oscBuf[i]->needle++]=(-fm_emu->ch_out[freakingDrumMap[i-6]])<<3;
       } else {
@@ -99,7 +99,7 @@ void DivPlatformPCE::acquire(short** buf, size_t len) {
     pce->Update(coreQuality);
     pce->ResetTS(0);
 
-    for (int i=0; i<6; i++) {
+    if (!skipOscWrites) for (int i=0; i<6; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(pce->channel[i].blip_prev_samp[0]+pce->channel[i].blip_prev_samp[1],-32768,32767);
     }
 
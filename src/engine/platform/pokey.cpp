@@ -84,7 +84,7 @@ void DivPlatformPOKEY::acquireMZ(short* buf, size_t len) {
 
     mzpokeysnd_process_16(&pokey,&buf[h],1);
 
-    if (++oscBufDelay>=14) {
+    if (!skipOscWrites && ++oscBufDelay>=14) {
       oscBufDelay=0;
       oscBuf[0]->data[oscBuf[0]->needle++]=pokey.outvol_0<<10;
       oscBuf[1]->data[oscBuf[1]->needle++]=pokey.outvol_1<<10;
@@ -102,7 +102,7 @@ void DivPlatformPOKEY::acquireASAP(short* buf, size_t len) {
   }
 
   for (size_t h=0; h<len; h++) {
-    if (++oscBufDelay>=2) {
+    if (!skipOscWrites && ++oscBufDelay>=2) {
       oscBufDelay=0;
       buf[h]=altASAP.sampleAudio(oscBuf);
     } else {
@@ -41,7 +41,7 @@ void DivPlatformPV1000::acquire(short** buf, size_t len) {
   for (size_t h=0; h<len; h++) {
     short samp=d65010g031_sound_tick(&d65010g031,1);
     buf[0][h]=samp;
-    for (int i=0; i<3; i++) {
+    if (!skipOscWrites) for (int i=0; i<3; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=MAX(d65010g031.out[i]<<2,0);
     }
   }
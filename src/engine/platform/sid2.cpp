@@ -87,7 +87,7 @@ void DivPlatformSID2::acquire(short** buf, size_t len)
     
     sid2->clock();
     buf[0][i]=sid2->output();
-    if (++writeOscBuf>=16) 
+    if (!skipOscWrites && ++writeOscBuf>=16) 
     {
       writeOscBuf=0;
 
@@ -57,10 +57,10 @@ void DivPlatformSM8521::acquire(short** buf, size_t len) {
   for (size_t h=0; h<len; h++) {
     sm8521_sound_tick(&sm8521,coreQuality);
     buf[0][h]=sm8521.out<<6;
-    for (int i=0; i<2; i++) {
+    if (!skipOscWrites) for (int i=0; i<2; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=sm8521.sg[i].base.out<<7;
     }
-    oscBuf[2]->data[oscBuf[2]->needle++]=sm8521.noise.base.out<<7;
+    if (!skipOscWrites) oscBuf[2]->data[oscBuf[2]->needle++]=sm8521.noise.base.out<<7;
   }
 }
 
@@ -99,7 +99,7 @@ void DivPlatformSMS::acquire_nuked(short** buf, size_t len) {
     if (oR>32767) oR=32767;
     buf[0][h]=oL;
     if (stereo) buf[1][h]=oR;
-    for (int i=0; i<4; i++) {
+    if (!skipOscWrites) for (int i=0; i<4; i++) {
       if (isMuted[i]) {
         oscBuf[i]->data[oscBuf[i]->needle++]=0;
       } else {
@@ -128,7 +128,7 @@ void DivPlatformSMS::acquire_mame(short** buf, size_t len) {
       stereo?(&buf[1][h]):NULL
     };
     sn->sound_stream_update(outs,1);
-    for (int i=0; i<4; i++) {
+    if (!skipOscWrites) for (int i=0; i<4; i++) {
       if (isMuted[i]) {
         oscBuf[i]->data[oscBuf[i]->needle++]=0;
       } else {
@@ -474,6 +474,34 @@ int DivPlatformSMS::getRegisterPoolSize() {
   return stereo?9:8;
 }
 
+void* DivPlatformSMS::getState() {
+  State* s=new State;
+  for (int i=0; i<4; i++) {
+    s->chan[i]=chan[i];
+  }
+  s->lastPan=lastPan;
+  s->oldValue=oldValue;
+  s->snNoiseMode=snNoiseMode;
+  s->updateSNMode=updateSNMode;
+  return s;
+}
+
+void DivPlatformSMS::setState(void* state) {
+  if (state==NULL) return;
+  State* s=(State*)state;
+  for (int i=0; i<4; i++) {
+    chan[i]=s->chan[i];
+  }
+  lastPan=s->lastPan;
+  oldValue=s->oldValue;
+  snNoiseMode=s->snNoiseMode;
+  updateSNMode=s->updateSNMode;
+}
+
+void DivPlatformSMS::freeState(void* state) {
+  delete (State*)state;
+}
+
 void DivPlatformSMS::reset() {
   memset(regPool,0,16);
   chanLatch=0;
@@ -157,6 +157,27 @@ protected:
 // forward declarations
 template<class RegisterType> class fm_engine_base;
 
+// ======================> fm_debug_tap
+
+// fm_debug_tap describes where to store the output of a channel for every
+// generated sample (Furnace extension); this allows generating many samples
+// at once while still feeding per-channel oscilloscopes
+struct fm_debug_tap
+{
+	enum source_type : uint8_t
+	{
+		OUTPUT_SUM,    // sum of all outputs
+		OUTPUT_FIRST,  // first non-zero output
+		SPECIAL1,      // debug_special1()
+		SPECIAL2       // debug_special2()
+	};
+
+	int16_t *data;     // destination buffer
+	uint8_t channel;   // channel index
+	uint8_t source;    // one of source_type
+	uint8_t shift;     // left shift before clamping to 16-bit
+};
+
 // ======================> fm_operator
 
 // fm_operator represents an FM operator (or "slot" in FM parlance), which
@@ -308,6 +329,31 @@ public:
   int32_t debug_special1() const { return m_special1; }
   int32_t debug_special2() const { return m_special2; }
 
+	// fetch the value of a debug tap source
+	int32_t debug_tap_value(uint8_t source) const
+	{
+		switch (source)
+		{
+			case fm_debug_tap::OUTPUT_SUM:
+			{
+				int32_t result = m_output[0];
+				for (uint32_t index = 1; index < RegisterType::OUTPUTS; index++)
+					result += m_output[index];
+				return result;
+			}
+			case fm_debug_tap::OUTPUT_FIRST:
+				for (uint32_t index = 0; index < RegisterType::OUTPUTS; index++)
+					if (m_output[index] != 0)
+						return m_output[index];
+				return 0;
+			case fm_debug_tap::SPECIAL1:
+				return m_special1;
+			case fm_debug_tap::SPECIAL2:
+				return m_special2;
+		}
+		return 0;
+	}
+
 private:
 	// helper to add values to the outputs based on channel enables
 	void add_to_output(uint32_t choffs, output_data &output, int32_t value) const
@@ -435,6 +481,25 @@ public:
 	fm_channel<RegisterType> *debug_channel(uint32_t index) const { return m_channel[index].get(); }
 	fm_operator<RegisterType> *debug_operator(uint32_t index) const { return m_operator[index].get(); }
 
+	// set the debug taps to be filled by generate(); pass 0 taps to disable
+	void debug_set_taps(fm_debug_tap const *taps, uint32_t count)
+	{
+		m_taps = taps;
+		m_tap_count = count;
+		m_tap_pos = 0;
+	}
+
+	// store the channel outputs of the sample just generated into the debug taps
+	void debug_tap()
+	{
+		for (uint32_t index = 0; index < m_tap_count; index++)
+		{
+			fm_debug_tap const &tap = m_taps[index];
+			tap.data[m_tap_pos] = clamp(m_channel[tap.channel]->debug_tap_value(tap.source) << tap.shift, -32768, 32767);
+		}
+		m_tap_pos++;
+	}
+
 public:
 	// timer callback; called by the interface when a timer fires
 	virtual void engine_timer_expired(uint32_t tnum) override;
@@ -464,6 +529,9 @@ protected:
 	uint32_t m_active_channels;      // mask of active channels (computed by prepare)
 	uint32_t m_modified_channels;    // mask of channels that have been modified
 	uint32_t m_prepare_count;        // counter to do periodic prepare sweeps
+	fm_debug_tap const *m_taps;      // debug taps (Furnace)
+	uint32_t m_tap_count;            // number of debug taps
+	uint32_t m_tap_pos;              // current position in debug taps
 	RegisterType m_regs;             // register accessor
 	std::unique_ptr<fm_channel<RegisterType>> m_channel[CHANNELS]; // channel pointers
 	std::unique_ptr<fm_operator<RegisterType>> m_operator[OPERATORS]; // operator pointers
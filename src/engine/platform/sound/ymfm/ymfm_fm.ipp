@@ -1202,7 +1202,10 @@ fm_engine_base<RegisterType>::fm_engine_base(ymfm_interface &intf) :
 	m_total_clocks(0),
 	m_active_channels(ALL_CHANNELS),
 	m_modified_channels(ALL_CHANNELS),
-	m_prepare_count(0)
+	m_prepare_count(0),
+	m_taps(nullptr),
+	m_tap_count(0),
+	m_tap_pos(0)
 {
 	// inform the interface of their engine
 	m_intf.m_engine = this;
@@ -778,6 +778,9 @@ void ym3526::generate(output_data *output, uint32_t numsamples)
 		// YM3526 uses an external DAC (YM3014) with mantissa/exponent format
 		// convert to 10.3 floating point value and back to simulate truncation
 		output->roundtrip_fp();
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
@@ -1017,6 +1020,9 @@ void y8950::generate(output_data *output, uint32_t numsamples)
 		// Y8950 uses an external DAC (YM3014) with mantissa/exponent format
 		// convert to 10.3 floating point value and back to simulate truncation
 		output->roundtrip_fp();
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
@@ -1158,6 +1164,9 @@ void ym3812::generate(output_data *output, uint32_t numsamples)
 		// YM3812 uses an external DAC (YM3014) with mantissa/exponent format
 		// convert to 10.3 floating point value and back to simulate truncation
 		output->roundtrip_fp();
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
@@ -1330,6 +1339,9 @@ void ymf262::generate(output_data *output, uint32_t numsamples)
 
 		// YMF262 output is 16-bit offset serial via YAC512 DAC
 		output->clamp16();
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
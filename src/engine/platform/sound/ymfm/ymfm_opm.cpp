@@ -540,6 +540,9 @@ void ym2151::generate(output_data *output, uint32_t numsamples)
 		// YM2151 uses an external DAC (YM3012) with mantissa/exponent format
 		// convert to 10.3 floating point value and back to simulate truncation
 		output->roundtrip_fp();
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
@@ -2416,6 +2416,9 @@ void ym2612::generate(output_data *output, uint32_t numsamples)
 		// adjustment above
 		output->data[0] = (output->data[0] * 128) * 64 / (6 * 65);
 		output->data[1] = (output->data[1] * 128) * 64 / (6 * 65);
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
@@ -2450,6 +2453,9 @@ void ym3438::generate(output_data *output, uint32_t numsamples)
 		// multiplexed like the YM2612
 		output->data[0] = (output->data[0] * 128) / 6;
 		output->data[1] = (output->data[1] * 128) / 6;
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
@@ -2483,6 +2489,9 @@ void ymf276::generate(output_data *output, uint32_t numsamples)
 		// YMF276 is properly mixed; it shifts down 1 bit before clamping
 		output->data[0] = clamp(output->data[0] >> 1, -32768, 32767);
 		output->data[1] = clamp(output->data[1] >> 1, -32768, 32767);
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
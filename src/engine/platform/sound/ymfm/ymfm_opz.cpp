@@ -820,6 +820,9 @@ void ym2414::generate(output_data *output, uint32_t numsamples)
 
 		// unsure about YM2414 outputs; assume it is like YM2151
 		output->roundtrip_fp();
+
+		// capture channel outputs (Furnace)
+		m_fm.debug_tap();
 	}
 }
 
@@ -48,7 +48,7 @@ void DivPlatformSoundUnit::acquire(short** buf, size_t len) {
       writes.pop();
     }
     su->NextSample(&buf[0][h],&buf[1][h]);
-    for (int i=0; i<8; i++) {
+    if (!skipOscWrites) for (int i=0; i<8; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=su->GetSample(i);
     }
   }
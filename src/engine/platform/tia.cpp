@@ -51,8 +51,10 @@ void DivPlatformTIA::acquire(short** buf, size_t len) {
     }
     if (++chanOscCounter>=114) {
       chanOscCounter=0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=tia.myChannelOut[0];
-      oscBuf[1]->data[oscBuf[1]->needle++]=tia.myChannelOut[1];
+      if (!skipOscWrites) {
+        oscBuf[0]->data[oscBuf[0]->needle++]=tia.myChannelOut[0];
+        oscBuf[1]->data[oscBuf[1]->needle++]=tia.myChannelOut[1];
+      }
     }
   }
 }
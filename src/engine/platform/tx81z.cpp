@@ -22,6 +22,9 @@
 #include <string.h>
 #include <math.h>
 
+// maximum number of samples generated by ymfm at once
+#define YMFM_BATCH_SIZE 256
+
 // actually 0x40 but the upper bit of data selects address
 #define ADDR_WS_FINE 0x100
 // actually 0xc0 but bit 5 of data selects address
@@ -59,11 +62,21 @@ const char** DivPlatformTX81Z::getRegisterSheet() {
 
 void DivPlatformTX81Z::acquire(short** buf, size_t len) {
   thread_local int os[2];
+  ymfm::ym2414::output_data out[YMFM_BATCH_SIZE];
+  ymfm::fm_debug_tap taps[8];
 
   ymfm::ym2414::fm_engine* fme=fm_ymfm->debug_engine();
 
-  for (size_t h=0; h<len; h++) {
-    os[0]=0; os[1]=0;
+  for (int i=0; i<8; i++) {
+    taps[i].channel=i;
+    taps[i].source=ymfm::fm_debug_tap::OUTPUT_SUM;
+    taps[i].shift=0;
+  }
+
+  for (size_t h=0; h<len;) {
+    // one sample at a time while there are writes.
+    // after that the rest of the buffer is generated at once.
+    size_t batch=1;
     if (!writes.empty()) {
       if (--delay<1) {
         QueuedWrite& w=writes.front();
@@ -73,24 +86,36 @@ void DivPlatformTX81Z::acquire(short** buf, size_t len) {
         writes.pop_front();
         delay=1;
       }
+    } else {
+      batch=MIN(len-h,YMFM_BATCH_SIZE);
     }
-    
-    fm_ymfm->generate(&out_ymfm);
 
-    for (int i=0; i<8; i++) {
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fme->debug_channel(i)->debug_output(0)+fme->debug_channel(i)->debug_output(1),-32768,32767);
+    // without taps ymfm doesn't track per-channel output at all
+    int tapCount=skipOscWrites?0:8;
+    for (int i=0; i<tapCount; i++) {
+      batch=MIN(batch,(size_t)(65536-oscBuf[i]->needle));
+    }
+    for (int i=0; i<tapCount; i++) {
+      taps[i].data=&oscBuf[i]->data[oscBuf[i]->needle];
+      oscBuf[i]->needle+=batch;
     }
 
-    os[0]=out_ymfm.data[0];
-    if (os[0]<-32768) os[0]=-32768;
-    if (os[0]>32767) os[0]=32767;
+    fme->debug_set_taps(taps,tapCount);
+    fm_ymfm->generate(out,batch);
+    fme->debug_set_taps(NULL,0);
+
+    for (size_t i=0; i<batch; i++, h++) {
+      os[0]=out[i].data[0];
+      if (os[0]<-32768) os[0]=-32768;
+      if (os[0]>32767) os[0]=32767;
 
-    os[1]=out_ymfm.data[1];
-    if (os[1]<-32768) os[1]=-32768;
-    if (os[1]>32767) os[1]=32767;
-  
-    buf[0][h]=os[0];
-    buf[1][h]=os[1];
+      os[1]=out[i].data[1];
+      if (os[1]<-32768) os[1]=-32768;
+      if (os[1]>32767) os[1]=32767;
+
+      buf[0][h]=os[0];
+      buf[1][h]=os[1];
+    }
   }
 }
 
@@ -48,7 +48,6 @@ class DivPlatformTX81Z: public DivPlatformOPM {
     unsigned char amDepth, pmDepth, amDepth2, pmDepth2;
 
     ymfm::ym2414* fm_ymfm;
-    ymfm::ym2414::output_data out_ymfm;
     DivTXInterface iface;
 
     bool extMode;
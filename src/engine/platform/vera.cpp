@@ -118,13 +118,13 @@ void DivPlatformVERA::acquire(short** buf, size_t len) {
       buf[1][pos]=(short)(((int)whyCallItBuf[1][i]+whyCallItBuf[3][i])/2);
       pos++;
 
-      for (int i=0; i<16; i++) {
+      if (!skipOscWrites) for (int i=0; i<16; i++) {
         oscBuf[i]->data[oscBuf[i]->needle++]=psg->channels[i].lastOut<<3;
       }
       int pcmOut=(whyCallItBuf[2][i]+whyCallItBuf[3][i])>>1;
       if (pcmOut<-32768) pcmOut=-32768;
       if (pcmOut>32767) pcmOut=32767;
-      oscBuf[16]->data[oscBuf[16]->needle++]=pcmOut;
+      if (!skipOscWrites) oscBuf[16]->data[oscBuf[16]->needle++]=pcmOut;
     }
     len-=curLen;
   }
@@ -161,7 +161,7 @@ int DivPlatformVERA::calcNoteFreq(int ch, int note) {
         off=65536.0*(s->centerRate/8363.0);
       }
     }
-    return (int)(parent->calcBaseFreq(chipClock,off,note,false));
+    return (int)(parent->calcBaseFreq(chipClock,off,note,false,false));
   }
 }
 
@@ -235,7 +235,7 @@ void DivPlatformVERA::tick(bool sysTick) {
     } else if (lastCenterRate>=1) {
       off=65536.0*(lastCenterRate/8363.0);
     }
-    chan[16].freq=parent->calcFreq(chan[16].baseFreq,chan[16].pitch,chan[16].fixedArp?chan[16].baseNoteOverride:chan[16].arpOff,chan[16].fixedArp,false,8,chan[16].pitch2,chipClock,off);
+    chan[16].freq=parent->calcFreq(chan[16].baseFreq,chan[16].pitch,chan[16].fixedArp?chan[16].baseNoteOverride:chan[16].arpOff,chan[16].fixedArp,false,8,chan[16].pitch2,chipClock,off,0,false);
     if (chan[16].freq>128) chan[16].freq=128;
     rWritePCMRate(chan[16].freq&0xff);
     chan[16].freqChanged=false;
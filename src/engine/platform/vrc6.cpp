@@ -84,7 +84,7 @@ void DivPlatformVRC6::acquire(short** buf, size_t len) {
     buf[0][i]=sample;
 
     // Oscilloscope buffer part
-    if (++writeOscBuf>=32) {
+    if (!skipOscWrites && ++writeOscBuf>=32) {
       writeOscBuf=0;
       for (int i=0; i<2; i++) {
         oscBuf[i]->data[oscBuf[i]->needle++]=vrc6.pulse_out(i)<<11;
@@ -223,7 +223,7 @@ void DivPlatformX1_010::acquire(short** buf, size_t len) {
 
     for (int i=0; i<16; i++) {
       int vo=(x1_010.voice_out(i,0)+x1_010.voice_out(i,1))<<2;
-      oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(vo,-32768,32767);
+      if (!skipOscWrites) oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(vo,-32768,32767);
     }
   }
 }
@@ -252,7 +252,7 @@ double DivPlatformX1_010::NoteX1_010(int ch, int note) {
         off=8192.0*(s->centerRate/8363.0);
       }
     }
-    return parent->calcBaseFreq(chipClock,off,note,false);
+    return parent->calcBaseFreq(chipClock,off,note,false,false);
   }
   // Wavetable note
   return NOTE_FREQUENCY(note);
@@ -478,7 +478,7 @@ void DivPlatformX1_010::tick(bool sysTick) {
           }
         }
       }
-      chan[i].freq=parent->calcFreq(chan[i].baseFreq,chan[i].pitch,chan[i].fixedArp?chan[i].baseNoteOverride:chan[i].arpOff,chan[i].fixedArp,false,2,chan[i].pitch2,chipClock,chan[i].pcm?off:CHIP_FREQBASE);
+      chan[i].freq=parent->calcFreq(chan[i].baseFreq,chan[i].pitch,chan[i].fixedArp?chan[i].baseNoteOverride:chan[i].arpOff,chan[i].fixedArp,false,2,chan[i].pitch2,chipClock,chan[i].pcm?off:CHIP_FREQBASE,0,!chan[i].pcm);
       if (chan[i].fixedFreq) chan[i].freq=chan[i].fixedFreq;
       if (chan[i].pcm) {
         if (chan[i].freq<1) chan[i].freq=1;
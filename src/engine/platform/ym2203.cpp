@@ -232,11 +232,11 @@ void DivPlatformYM2203::acquire_combo(short** buf, size_t len) {
   
     buf[0][h]=os;
     
-    for (int i=0; i<3; i++) {
+    if (!skipOscWrites) for (int i=0; i<3; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fm_nuked.ch_out[i]<<1,-32768,32767);
     }
 
-    for (int i=3; i<6; i++) {
+    if (!skipOscWrites) for (int i=3; i<6; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=fmout.data[i-2]<<1;
     }
   }
@@ -283,12 +283,12 @@ void DivPlatformYM2203::acquire_ymfm(short** buf, size_t len) {
     buf[0][h]=os;
 
     
-    for (int i=0; i<3; i++) {
+    if (!skipOscWrites) for (int i=0; i<3; i++) {
       int out=(fmChan[i]->debug_output(0)+fmChan[i]->debug_output(1))<<1;
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(out,-32768,32767);
     }
 
-    for (int i=3; i<6; i++) {
+    if (!skipOscWrites) for (int i=3; i<6; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=fmout.data[i-2]<<1;
     }
   }
@@ -422,13 +422,13 @@ void DivPlatformYM2203::acquire_lle(short** buf, size_t len) {
     
     // chan osc
     // FM
-    for (int i=0; i<3; i++) {
+    if (!skipOscWrites) for (int i=0; i<3; i++) {
       if (fmOut[i]<-32768) fmOut[i]=-32768;
       if (fmOut[i]>32767) fmOut[i]=32767;
       oscBuf[i]->data[oscBuf[i]->needle++]=fmOut[i];
     }
     // SSG
-    for (int i=0; i<3; i++) {
+    if (!skipOscWrites) for (int i=0; i<3; i++) {
       oscBuf[i+3]->data[oscBuf[i+3]->needle++]=fm_lle.o_analog_ch[i]*32767;
     }
 
@@ -1239,6 +1239,11 @@ void DivPlatformYM2203::setSkipRegisterWrites(bool value) {
   ay->setSkipRegisterWrites(value);
 }
 
+void DivPlatformYM2203::setSkipOscWrites(bool value) {
+  DivDispatch::setSkipOscWrites(value);
+  ay->setSkipOscWrites(value);
+}
+
 void DivPlatformYM2203::setFlags(const DivConfig& flags) {
   // Clock flags
   switch (flags.getInt("clockSel",0)) {
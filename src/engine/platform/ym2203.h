@@ -89,6 +89,7 @@ class DivPlatformYM2203: public DivPlatformOPN {
     void notifyInsChange(int ins);
     virtual void notifyInsDeletion(void* ins);
     void setSkipRegisterWrites(bool val);
+    void setSkipOscWrites(bool val);
     void poke(unsigned int addr, unsigned short val);
     void poke(std::vector<DivRegWrite>& wlist);
     const char** getRegisterSheet();
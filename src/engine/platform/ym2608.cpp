@@ -292,7 +292,7 @@ double DivPlatformYM2608::NOTE_OPNB(int ch, int note) {
 double DivPlatformYM2608::NOTE_ADPCMB(int note) {
   if (chan[15].sample>=0 && chan[15].sample<parent->song.sampleLen) {
     double off=65535.0*(double)(parent->getSample(chan[15].sample)->centerRate)/8363.0;
-    return parent->calcBaseFreq((double)chipClock/144,off,note,false);
+    return parent->calcBaseFreq((double)chipClock/144,off,note,false,false);
   }
   return 0;
 }
@@ -403,20 +403,20 @@ void DivPlatformYM2608::acquire_combo(short** buf, size_t len) {
     buf[1][h]=os[1];
 
     
-    for (int i=0; i<psgChanOffs; i++) {
+    if (!skipOscWrites) for (int i=0; i<psgChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fm_nuked.ch_out[i]<<1,-32768,32767);
     }
 
     ssge->get_last_out(ssgOut);
-    for (int i=psgChanOffs; i<adpcmAChanOffs; i++) {
+    if (!skipOscWrites) for (int i=psgChanOffs; i<adpcmAChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=ssgOut.data[i-psgChanOffs]<<1;
     }
 
-    for (int i=adpcmAChanOffs; i<adpcmBChanOffs; i++) {
+    if (!skipOscWrites) for (int i=adpcmAChanOffs; i<adpcmBChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=(adpcmAChan[i-adpcmAChanOffs]->get_last_out(0)+adpcmAChan[i-adpcmAChanOffs]->get_last_out(1))>>1;
     }
 
-    oscBuf[adpcmBChanOffs]->data[oscBuf[adpcmBChanOffs]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
+    if (!skipOscWrites) oscBuf[adpcmBChanOffs]->data[oscBuf[adpcmBChanOffs]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
   }
 }
 
@@ -472,21 +472,21 @@ void DivPlatformYM2608::acquire_ymfm(short** buf, size_t len) {
     buf[0][h]=os[0];
     buf[1][h]=os[1];
 
-    for (int i=0; i<6; i++) {
+    if (!skipOscWrites) for (int i=0; i<6; i++) {
       int out=(fmChan[i]->debug_output(0)+fmChan[i]->debug_output(1))<<1;
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(out,-32768,32767);
     }
 
     ssge->get_last_out(ssgOut);
-    for (int i=6; i<9; i++) {
+    if (!skipOscWrites) for (int i=6; i<9; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=ssgOut.data[i-6]<<1;
     }
 
-    for (int i=9; i<15; i++) {
+    if (!skipOscWrites) for (int i=9; i<15; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=(adpcmAChan[i-9]->get_last_out(0)+adpcmAChan[i-9]->get_last_out(1))>>1;
     }
 
-    oscBuf[15]->data[oscBuf[15]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
+    if (!skipOscWrites) oscBuf[15]->data[oscBuf[15]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
   }
 }
 
@@ -645,23 +645,23 @@ void DivPlatformYM2608::acquire_lle(short** buf, size_t len) {
 
     // chan osc
     // FM
-    for (int i=0; i<6; i++) {
+    if (!skipOscWrites) for (int i=0; i<6; i++) {
       if (fmOut[i]<-32768) fmOut[i]=-32768;
       if (fmOut[i]>32767) fmOut[i]=32767;
       oscBuf[i]->data[oscBuf[i]->needle++]=fmOut[i];
     }
     // SSG
-    for (int i=0; i<3; i++) {
+    if (!skipOscWrites) for (int i=0; i<3; i++) {
       oscBuf[i+6]->data[oscBuf[i+6]->needle++]=fm_lle.o_analog_ch[i]*32767;
     }
     // RSS
-    for (int i=0; i<6; i++) {
+    if (!skipOscWrites) for (int i=0; i<6; i++) {
       if (rssOut[i]<-32768) rssOut[i]=-32768;
       if (rssOut[i]>32767) rssOut[i]=32767;
       oscBuf[9+i]->data[oscBuf[9+i]->needle++]=rssOut[i];
     }
     // ADPCM
-    oscBuf[15]->data[oscBuf[15]->needle++]=fm_lle.ac_ad_output;
+    if (!skipOscWrites) oscBuf[15]->data[oscBuf[15]->needle++]=fm_lle.ac_ad_output;
 
     // DAC
     int accm1=(short)dacOut[1];
@@ -971,7 +971,7 @@ void DivPlatformYM2608::tick(bool sysTick) {
     if (chan[15].furnacePCM) {
       if (chan[15].sample>=0 && chan[15].sample<parent->song.sampleLen) {
         double off=65535.0*(double)(parent->getSample(chan[15].sample)->centerRate)/8363.0;
-        chan[15].freq=parent->calcFreq(chan[15].baseFreq,chan[15].pitch,chan[15].fixedArp?chan[15].baseNoteOverride:chan[15].arpOff,chan[15].fixedArp,false,4,chan[15].pitch2,(double)chipClock/144,off);
+        chan[15].freq=parent->calcFreq(chan[15].baseFreq,chan[15].pitch,chan[15].fixedArp?chan[15].baseNoteOverride:chan[15].arpOff,chan[15].fixedArp,false,4,chan[15].pitch2,(double)chipClock/144,off,0,false);
       } else {
         chan[15].freq=0;
       }
@@ -1830,6 +1830,11 @@ void DivPlatformYM2608::setSkipRegisterWrites(bool value) {
   ay->setSkipRegisterWrites(value);
 }
 
+void DivPlatformYM2608::setSkipOscWrites(bool value) {
+  DivDispatch::setSkipOscWrites(value);
+  ay->setSkipOscWrites(value);
+}
+
 const void* DivPlatformYM2608::getSampleMem(int index) {
   return index == 0 ? adpcmBMem : NULL;
 }
@@ -334,20 +334,20 @@ void DivPlatformYM2610::acquire_combo(short** buf, size_t len) {
     buf[1][h]=os[1];
 
     
-    for (int i=0; i<psgChanOffs; i++) {
+    if (!skipOscWrites) for (int i=0; i<psgChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(fm_nuked.ch_out[bchOffs[i]]<<1,-32768,32767);
     }
 
     ssge->get_last_out(ssgOut);
-    for (int i=psgChanOffs; i<adpcmAChanOffs; i++) {
+    if (!skipOscWrites) for (int i=psgChanOffs; i<adpcmAChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=ssgOut.data[i-psgChanOffs]<<1;
     }
 
-    for (int i=adpcmAChanOffs; i<adpcmBChanOffs; i++) {
+    if (!skipOscWrites) for (int i=adpcmAChanOffs; i<adpcmBChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=(adpcmAChan[i-adpcmAChanOffs]->get_last_out(0)+adpcmAChan[i-adpcmAChanOffs]->get_last_out(1))>>1;
     }
 
-    oscBuf[adpcmBChanOffs]->data[oscBuf[adpcmBChanOffs]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
+    if (!skipOscWrites) oscBuf[adpcmBChanOffs]->data[oscBuf[adpcmBChanOffs]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
   }
 }
 
@@ -405,21 +405,21 @@ void DivPlatformYM2610::acquire_ymfm(short** buf, size_t len) {
     buf[0][h]=os[0];
     buf[1][h]=os[1];
 
-    for (int i=0; i<psgChanOffs; i++) {
+    if (!skipOscWrites) for (int i=0; i<psgChanOffs; i++) {
       int out=(fmChan[i]->debug_output(0)+fmChan[i]->debug_output(1))<<1;
       oscBuf[i]->data[oscBuf[i]->needle++]=CLAMP(out,-32768,32767);
     }
 
     ssge->get_last_out(ssgOut);
-    for (int i=psgChanOffs; i<adpcmAChanOffs; i++) {
+    if (!skipOscWrites) for (int i=psgChanOffs; i<adpcmAChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=ssgOut.data[i-psgChanOffs]<<1;
     }
 
-    for (int i=adpcmAChanOffs; i<adpcmBChanOffs; i++) {
+    if (!skipOscWrites) for (int i=adpcmAChanOffs; i<adpcmBChanOffs; i++) {
       oscBuf[i]->data[oscBuf[i]->needle++]=(adpcmAChan[i-adpcmAChanOffs]->get_last_out(0)+adpcmAChan[i-adpcmAChanOffs]->get_last_out(1))>>1;
     }
 
-    oscBuf[adpcmBChanOffs]->data[oscBuf[adpcmBChanOffs]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
+    if (!skipOscWrites) oscBuf[adpcmBChanOffs]->data[oscBuf[adpcmBChanOffs]->needle++]=(abe->get_last_out(0)+abe->get_last_out(1))>>1;
   }
 }
 
@@ -576,23 +576,23 @@ void DivPlatformYM2610::acquire_lle(short** buf, size_t len) {
 
     // chan osc
     // FM
-    for (int i=0; i<4; i++) {
+    if (!skipOscWrites) for (int i=0; i<4; i++) {
       if (fmOut[i]<-32768) fmOut[i]=-32768;
       if (fmOut[i]>32767) fmOut[i]=32767;
       oscBuf[i]->data[oscBuf[i]->needle++]=fmOut[i];
     }
     // SSG
-    for (int i=0; i<3; i++) {
+    if (!skipOscWrites) for (int i=0; i<3; i++) {
       oscBuf[i+4]->data[oscBuf[i+4]->needle++]=fm_lle.o_analog_ch[i]*32767;
     }
     // RSS
-    for (int i=0; i<6; i++) {
+    if (!skipOscWrites) for (int i=0; i<6; i++) {
       if (rssOut[i]<-32768) rssOut[i]=-32768;
       if (rssOut[i]>32767) rssOut[i]=32767;
       oscBuf[7+i]->data[oscBuf[7+i]->needle++]=rssOut[i];
     }
     // ADPCM
-    oscBuf[13]->data[oscBuf[13]->needle++]=fm_lle.ac_ad_output;
+    if (!skipOscWrites) oscBuf[13]->data[oscBuf[13]->needle++]=fm_lle.ac_ad_output;
 
     // DAC
     int accm1=(short)dacOut[1];
@@ -904,7 +904,7 @@ void DivPlatformYM2610::tick(bool sysTick) {
     if (chan[adpcmBChanOffs].furnacePCM) {
       if (chan[adpcmBChanOffs].sample>=0 && chan[adpcmBChanOffs].sample<parent->song.sampleLen) {
         double off=65535.0*(double)(parent->getSample(chan[adpcmBChanOffs].sample)->centerRate)/8363.0;
-        chan[adpcmBChanOffs].freq=parent->calcFreq(chan[adpcmBChanOffs].baseFreq,chan[adpcmBChanOffs].pitch,chan[adpcmBChanOffs].fixedArp?chan[adpcmBChanOffs].baseNoteOverride:chan[adpcmBChanOffs].arpOff,chan[adpcmBChanOffs].fixedArp,false,4,chan[adpcmBChanOffs].pitch2,(double)chipClock/144,off);
+        chan[adpcmBChanOffs].freq=parent->calcFreq(chan[adpcmBChanOffs].baseFreq,chan[adpcmBChanOffs].pitch,chan[adpcmBChanOffs].fixedArp?chan[adpcmBChanOffs].baseNoteOverride:chan[adpcmBChanOffs].arpOff,chan[adpcmBChanOffs].fixedArp,false,4,chan[adpcmBChanOffs].pitch2,(double)chipClock/144,off,0,false);
       } else {
         chan[adpcmBChanOffs].freq=0;
       }
@@ -1722,6 +1722,11 @@ void DivPlatformYM2610::setSkipRegisterWrites(bool value) {
   ay->setSkipRegisterWrites(value);
 }
 
+void DivPlatformYM2610::setSkipOscWrites(bool value) {
+  DivDispatch::setSkipOscWrites(value);
+  ay->setSkipOscWrites(value);
+}
+
 int DivPlatformYM2610::init(DivEngine* p, int channels, int sugRate, const DivConfig& flags) {
   DivPlatformYM2610Base::init(p, channels, sugRate, flags);
   reset();
@@ -62,6 +62,7 @@ class DivPlatformYM2610: public DivPlatformYM2610Base {
     void notifyInsChange(int ins);
     virtual void notifyInsDeletion(void* ins);
     void setSkipRegisterWrites(bool val);
+    void setSkipOscWrites(bool val);
     void poke(unsigned int addr, unsigned short val);
     void poke(std::vector<DivRegWrite>& wlist);
     const char** getRegisterSheet();
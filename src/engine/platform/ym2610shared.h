@@ -22,6 +22,7 @@
 
 #include "fmshared_OPN.h"
 #include "../engine.h"
+#include "../memoryPacker.h"
 #include "../../ta-log.h"
 #include "ay.h"
 #include "sound/ymfm/ymfm.h"
@@ -102,7 +103,7 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
     double NOTE_ADPCMB(int note) {
       if (chan[adpcmBChanOffs].sample>=0 && chan[adpcmBChanOffs].sample<parent->song.sampleLen) {
         double off=65535.0*(double)(parent->getSample(chan[adpcmBChanOffs].sample)->centerRate)/8363.0;
-        return parent->calcBaseFreq((double)chipClock/144,off,note,false);
+        return parent->calcBaseFreq((double)chipClock/144,off,note,false,false);
       }
       return 0;
     }
@@ -232,68 +233,52 @@ class DivPlatformYM2610Base: public DivPlatformOPN {
       memCompoB=DivMemoryComposition();
       memCompoB.name="ADPCM-B";
 
-      size_t memPos=0;
+      // samples may not cross a 1MB bank
+      DivMemoryPacker packer;
+      packer.init(0,getSampleMemCapacity(0),256,0x100000);
       for (int i=0; i<parent->song.sampleLen; i++) {
         DivSample* s=parent->song.sample[i];
-        if (!s->renderOn[0][sysID]) {
-          sampleOffA[i]=0;
+        if (!s->renderOn[0][sysID]) continue;
+        packer.add(i,(const unsigned char*)s->dataA,(s->lengthA+255)&(~0xff));
+      }
+      packer.pack();
+      for (size_t i=0; i<packer.getItemCount(); i++) {
+        const DivMemoryPackerItem& item=packer.get(i);
+        if (!item.placed) {
+          logW("out of ADPCM-A memory for sample %d!",item.asset);
           continue;
         }
-
-        int paddedLen=(s->lengthA+255)&(~0xff);
-        if ((memPos&0xf00000)!=((memPos+paddedLen)&0xf00000)) {
-          memPos=(memPos+0xfffff)&0xf00000;
-        }
-        if (memPos>=getSampleMemCapacity(0)) {
-          logW("out of ADPCM-A memory for sample %d!",i);
-          break;
-        }
-        if (memPos+paddedLen>=getSampleMemCapacity(0)) {
-          memcpy(adpcmAMem+memPos,s->dataA,getSampleMemCapacity(0)-memPos);
-          logW("out of ADPCM-A memory for sample %d!",i);
-        } else {
-          memcpy(adpcmAMem+memPos,s->dataA,paddedLen);
-          sampleLoaded[0][i]=true;
-        }
-        sampleOffA[i]=memPos;
-        memCompoA.entries.push_back(DivMemoryEntry(DIV_MEMORY_SAMPLE,"Sample",i,memPos,memPos+paddedLen));
-        memPos+=paddedLen;
+        if (item.dupOf<0) memcpy(adpcmAMem+item.pos,item.data,item.len);
+        sampleOffA[item.asset]=item.pos;
+        sampleLoaded[0][item.asset]=true;
       }
-      adpcmAMemLen=memPos+256;
+      packer.fillCompo(memCompoA);
+      adpcmAMemLen=packer.getUsed()+256;
 
       memCompoA.used=adpcmAMemLen;
       memCompoA.capacity=getSampleMemCapacity(0);
 
       memset(adpcmBMem,0,getSampleMemCapacity(1));
 
-      memPos=0;
+      packer.init(0,getSampleMemCapacity(1),256,0x100000);
       for (int i=0; i<parent->song.sampleLen; i++) {
         DivSample* s=parent->song.sample[i];
-        if (!s->renderOn[1][sysID]) {
-          sampleOffB[i]=0;
+        if (!s->renderOn[1][sysID]) continue;
+        packer.add(i,(const unsigned char*)s->dataB,(s->lengthB+255)&(~0xff));
+      }
+      packer.pack();
+      for (size_t i=0; i<packer.getItemCount(); i++) {
+        const DivMemoryPackerItem& item=packer.get(i);
+        if (!item.placed) {
+          logW("out of ADPCM-B memory for sample %d!",item.asset);
           continue;
         }
-
-        int paddedLen=(s->lengthB+255)&(~0xff);
-        if ((memPos&0xf00000)!=((memPos+paddedLen)&0xf00000)) {
-          memPos=(memPos+0xfffff)&0xf00000;
-        }
-        if (memPos>=getSampleMemCapacity(1)) {
-          logW("out of ADPCM-B memory for sample %d!",i);
-          break;
-        }
-        if (memPos+paddedLen>=getSampleMemCapacity(1)) {
-          memcpy(adpcmBMem+memPos,s->dataB,getSampleMemCapacity(1)-memPos);
-          logW("out of ADPCM-B memory for sample %d!",i);
-        } else {
-          memcpy(adpcmBMem+memPos,s->dataB,paddedLen);
-          sampleLoaded[1][i]=true;
-        }
-        sampleOffB[i]=memPos;
-        memCompoB.entries.push_back(DivMemoryEntry(DIV_MEMORY_SAMPLE,"Sample",i,memPos,memPos+paddedLen));
-        memPos+=paddedLen;
+        if (item.dupOf<0) memcpy(adpcmBMem+item.pos,item.data,item.len);
+        sampleOffB[item.asset]=item.pos;
+        sampleLoaded[1][item.asset]=true;
       }
-      adpcmBMemLen=memPos+256;
+      packer.fillCompo(memCompoB);
+      adpcmBMemLen=packer.getUsed()+256;
 
       memCompoB.used=adpcmBMemLen;
       memCompoB.capacity=getSampleMemCapacity(1);
@@ -47,7 +47,7 @@ void DivPlatformZXBeeper::acquire(short** buf, size_t len) {
       }
       o=sampleOut;
       buf[0][h]=o?16384:0;
-      oscBuf[0]->data[oscBuf[0]->needle++]=o?16384:-16384;
+      if (!skipOscWrites) oscBuf[0]->data[oscBuf[0]->needle++]=o?16384:-16384;
       continue;
     }
 
@@ -65,7 +65,7 @@ void DivPlatformZXBeeper::acquire(short** buf, size_t len) {
     if (++curChan>=6) curChan=0;
     
     buf[0][h]=o?16384:0;
-    oscBuf[0]->data[oscBuf[0]->needle++]=o?16384:-16384;
+    if (!skipOscWrites) oscBuf[0]->data[oscBuf[0]->needle++]=o?16384:-16384;
   }
 }
 
@@ -51,12 +51,14 @@ void DivPlatformZXBeeperQuadTone::acquire(short** buf, size_t len) {
     if (sampleActive) {
       buf[0][h]=chan[4].out?32767:0;
       if (outputClock==0) {
-        oscBuf[0]->data[oscBuf[0]->needle++]=0;
-        oscBuf[1]->data[oscBuf[1]->needle++]=0;
-        oscBuf[2]->data[oscBuf[2]->needle++]=0;
-        oscBuf[3]->data[oscBuf[3]->needle++]=0;
+        if (!skipOscWrites) {
+          oscBuf[0]->data[oscBuf[0]->needle++]=0;
+          oscBuf[1]->data[oscBuf[1]->needle++]=0;
+          oscBuf[2]->data[oscBuf[2]->needle++]=0;
+          oscBuf[3]->data[oscBuf[3]->needle++]=0;
+        }
       }
-      oscBuf[4]->data[oscBuf[4]->needle++]=buf[0][h];
+      if (!skipOscWrites) oscBuf[4]->data[oscBuf[4]->needle++]=buf[0][h];
     } else {
       int ch=outputClock/2;
       int b=ch*4;
@@ -72,7 +74,7 @@ void DivPlatformZXBeeperQuadTone::acquire(short** buf, size_t len) {
         } else {
           oscOut=16383;
         }
-        oscBuf[ch]->data[oscBuf[ch]->needle++]=oscOut;
+        if (!skipOscWrites) oscBuf[ch]->data[oscBuf[ch]->needle++]=oscOut;
       }
       if (!isMuted[ch]) o=chan[ch].out&0x10;
       if (noHiss) {
@@ -85,7 +87,7 @@ void DivPlatformZXBeeperQuadTone::acquire(short** buf, size_t len) {
         buf[0][h]=o?32767:0;
       }
       chan[ch].out<<=1;
-      oscBuf[4]->data[oscBuf[4]->needle++]=0;
+      if (!skipOscWrites) oscBuf[4]->data[oscBuf[4]->needle++]=0;
     }
     outputClock=(outputClock+1)&7;
   }
@@ -156,7 +158,7 @@ void DivPlatformZXBeeperQuadTone::tick(bool sysTick) {
         DivSample* s=parent->getSample(curSample);
         off=(s->centerRate>=1)?(CHIP_DIVIDER*(double)s->centerRate/8363.0):CHIP_DIVIDER;
       }
-      chan[4].freq=parent->calcFreq(chan[4].baseFreq,chan[4].pitch,chan[4].fixedArp?chan[4].baseNoteOverride:chan[4].arpOff,chan[4].fixedArp,true,2,chan[4].pitch2,chipClock,off);
+      chan[4].freq=parent->calcFreq(chan[4].baseFreq,chan[4].pitch,chan[4].fixedArp?chan[4].baseNoteOverride:chan[4].arpOff,chan[4].fixedArp,true,2,chan[4].pitch2,chipClock,off,0,false);
       if (chan[4].freq>258) chan[4].freq=258;
       if (chan[4].freq<3) chan[4].freq=3;
       rWrite(16,(chan[4].freq-2)&255);
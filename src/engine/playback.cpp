@@ -318,31 +318,31 @@ int DivEngine::dispatchCmd(DivCommand c) {
           case DIV_CMD_NOTE_ON:
           case DIV_CMD_LEGATO:
             if (chan[c.chan].curMidiNote>=0) {
-              output->midiOut->send(TAMidiMessage(0x80|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
+              sendMidiOut(TAMidiMessage(0x80|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
             }
             if (c.value!=DIV_NOTE_NULL) {
               chan[c.chan].curMidiNote=c.value+12;
               if (chan[c.chan].curMidiNote<0) chan[c.chan].curMidiNote=0;
               if (chan[c.chan].curMidiNote>127) chan[c.chan].curMidiNote=127;
             }
-            output->midiOut->send(TAMidiMessage(0x90|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
+            sendMidiOut(TAMidiMessage(0x90|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
             break;
           case DIV_CMD_NOTE_OFF:
           case DIV_CMD_NOTE_OFF_ENV:
             if (chan[c.chan].curMidiNote>=0) {
-              output->midiOut->send(TAMidiMessage(0x80|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
+              sendMidiOut(TAMidiMessage(0x80|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
             }
             chan[c.chan].curMidiNote=-1;
             break;
           case DIV_CMD_INSTRUMENT:
             if (chan[c.chan].lastIns!=c.value && midiOutProgramChange) {
-              output->midiOut->send(TAMidiMessage(0xc0|(c.chan&15),c.value,0));
+              sendMidiOut(TAMidiMessage(0xc0|(c.chan&15),c.value,0));
             }
             break;
           case DIV_CMD_VOLUME:
             if (chan[c.chan].curMidiNote>=0 && chan[c.chan].midiAftertouch) {
               chan[c.chan].midiAftertouch=false;
-              output->midiOut->send(TAMidiMessage(0xa0|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
+              sendMidiOut(TAMidiMessage(0xa0|(c.chan&15),chan[c.chan].curMidiNote,scaledVol));
             }
             break;
           case DIV_CMD_PITCH: {
@@ -351,13 +351,13 @@ int DivEngine::dispatchCmd(DivCommand c) {
             if (pitchBend>16383) pitchBend=16383;
             if (pitchBend!=chan[c.chan].midiPitch) {
               chan[c.chan].midiPitch=pitchBend;
-              output->midiOut->send(TAMidiMessage(0xe0|(c.chan&15),pitchBend&0x7f,pitchBend>>7));
+              sendMidiOut(TAMidiMessage(0xe0|(c.chan&15),pitchBend&0x7f,pitchBend>>7));
             }
             break;
           }
           case DIV_CMD_PANNING: {
             int pan=convertPanSplitToLinearLR(c.value,c.value2,127);
-            output->midiOut->send(TAMidiMessage(0xb0|(c.chan&15),0x0a,pan));
+            sendMidiOut(TAMidiMessage(0xb0|(c.chan&15),0x0a,pan));
             break;
           }
           case DIV_CMD_HINT_PORTA: {
@@ -369,14 +369,14 @@ int DivEngine::dispatchCmd(DivCommand c) {
               if (target>127) target=127;
               
               if (chan[c.chan].curMidiNote>=0) {
-                output->midiOut->send(TAMidiMessage(0xb0|(c.chan&15),0x54,chan[c.chan].curMidiNote));
+                sendMidiOut(TAMidiMessage(0xb0|(c.chan&15),0x54,chan[c.chan].curMidiNote));
               }
-              output->midiOut->send(TAMidiMessage(0xb0|(c.chan&15),0x05,1/*MIN(0x7f,c.value2/4)*/));
-              output->midiOut->send(TAMidiMessage(0xb0|(c.chan&15),0x41,0x7f));
+              sendMidiOut(TAMidiMessage(0xb0|(c.chan&15),0x05,1/*MIN(0x7f,c.value2/4)*/));
+              sendMidiOut(TAMidiMessage(0xb0|(c.chan&15),0x41,0x7f));
               
-              output->midiOut->send(TAMidiMessage(0x90|(c.chan&15),target,scaledVol));
+              sendMidiOut(TAMidiMessage(0x90|(c.chan&15),target,scaledVol));
             } else {
-              output->midiOut->send(TAMidiMessage(0xb0|(c.chan&15),0x41,0));
+              sendMidiOut(TAMidiMessage(0xb0|(c.chan&15),0x41,0));
             }
             break;
           }
@@ -449,7 +449,7 @@ bool DivEngine::perSystemPreEffect(int ch, unsigned char effect, unsigned char e
 void DivEngine::processRowPre(int i) {
   int whatOrder=curOrder;
   int whatRow=curRow;
-  DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][whatOrder],false);
+  const DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][whatOrder],false);
   for (int j=0; j<curPat[i].effectCols; j++) {
     short effect=pat->data[whatRow][4+(j<<1)];
     short effectVal=pat->data[whatRow][5+(j<<1)];
@@ -463,7 +463,7 @@ void DivEngine::processRowPre(int i) {
 void DivEngine::processRow(int i, bool afterDelay) {
   int whatOrder=afterDelay?chan[i].delayOrder:curOrder;
   int whatRow=afterDelay?chan[i].delayRow:curRow;
-  DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][whatOrder],false);
+  const DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][whatOrder],false);
   // pre effects
   if (!afterDelay) {
     bool returnAfterPre=false;
@@ -1212,7 +1212,7 @@ void DivEngine::nextRow() {
       snprintf(pb,4095," %.2x",curOrders->ord[i][curOrder]);
       strcat(pb1,pb);
       
-      DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][curOrder],false);
+      const DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][curOrder],false);
       snprintf(pb2,4095,"\x1b[37m %s",
               formatNote(pat->data[curRow][0],pat->data[curRow][1]));
       strcat(pb3,pb2);
@@ -1341,7 +1341,7 @@ void DivEngine::nextRow() {
 
   // post row details
   for (int i=0; i<chans; i++) {
-    DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][curOrder],false);
+    const DivPattern* pat=curPat[i].getPattern(curOrders->ord[i][curOrder],false);
     if (!(pat->data[curRow][0]==0 && pat->data[curRow][1]==0)) {
       if (pat->data[curRow][0]!=100 && pat->data[curRow][0]!=101 && pat->data[curRow][0]!=102) {
         if (!chan[i].legato) {
@@ -1438,62 +1438,7 @@ bool DivEngine::nextTick(bool noAccum, bool inhibitLowLat) {
     cycles++;
   }
 
-  if (!pendingNotes.empty()) {
-    bool isOn[DIV_MAX_CHANS];
-    memset(isOn,0,DIV_MAX_CHANS*sizeof(bool));
-    
-    for (int i=pendingNotes.size()-1; i>=0; i--) {
-      if (pendingNotes[i].channel<0 || pendingNotes[i].channel>=chans) continue;
-      if (pendingNotes[i].on) {
-        isOn[pendingNotes[i].channel]=true;
-      } else {
-        if (isOn[pendingNotes[i].channel]) {
-          //logV("erasing off -> on sequence in %d",pendingNotes[i].channel);
-          pendingNotes[i].nop=true;
-        }
-      }
-    }
-  }
-
-  while (!pendingNotes.empty()) {
-    DivNoteEvent& note=pendingNotes.front();
-    if (note.nop || note.channel<0 || note.channel>=chans) {
-      pendingNotes.pop_front();
-      continue;
-    }
-    if (note.insChange) {
-      dispatchCmd(DivCommand(DIV_CMD_INSTRUMENT,note.channel,note.ins,0));
-      pendingNotes.pop_front();
-      continue;
-    }
-    if (note.on) {
-      if (!(midiIsDirect && midiIsDirectProgram && note.fromMIDI)) {
-        dispatchCmd(DivCommand(DIV_CMD_INSTRUMENT,note.channel,note.ins,1));
-      }
-      if (note.volume>=0 && !disCont[dispatchOfChan[note.channel]].dispatch->isVolGlobal()) {
-        float curvedVol=pow((float)note.volume/127.0f,midiVolExp);
-        int mappedVol=disCont[dispatchOfChan[note.channel]].dispatch->mapVelocity(dispatchChanOfChan[note.channel],curvedVol);
-        dispatchCmd(DivCommand(DIV_CMD_VOLUME,note.channel,mappedVol));
-      }
-      dispatchCmd(DivCommand(DIV_CMD_NOTE_ON,note.channel,note.note));
-      keyHit[note.channel]=true;
-      chan[note.channel].releasing=false;
-      chan[note.channel].noteOnInhibit=true;
-      chan[note.channel].lastIns=note.ins;
-    } else {
-      DivMacroInt* macroInt=disCont[dispatchOfChan[note.channel]].dispatch->getChanMacroInt(dispatchChanOfChan[note.channel]);
-      if (macroInt!=NULL) {
-        if (macroInt->hasRelease && !disCont[dispatchOfChan[note.channel]].dispatch->isVolGlobal()) {
-          dispatchCmd(DivCommand(DIV_CMD_NOTE_OFF_ENV,note.channel));
-        } else {
-          dispatchCmd(DivCommand(DIV_CMD_NOTE_OFF,note.channel));
-        }
-      } else {
-        dispatchCmd(DivCommand(DIV_CMD_NOTE_OFF,note.channel));
-      }
-    }
-    pendingNotes.pop_front();
-  }
+  processPendingNotes();
 
   if (!freelance) {
     if (--subticks<=0) {
@@ -1747,13 +1692,21 @@ int DivEngine::getBufferPos() {
   return bufferPos>>MASTER_CLOCK_PREC;
 }
 
+void DivEngine::sendMidiOut(TAMidiMessage msg, int offset) {
+  if (midiOutBufTime>0.0) {
+    msg.time=midiOutBufTime+(((double)bufferPos+(double)offset)/(double)(1<<MASTER_CLOCK_PREC))/got.rate;
+  }
+  output->midiOut->send(msg);
+}
+
 void DivEngine::runMidiClock(int totalCycles) {
   if (freelance) return;
   midiClockCycles-=totalCycles;
   while (midiClockCycles<=0) {
     curMidiClock++;
     if (output) if (!skipping && output->midiOut!=NULL && midiOutClock) {
-      output->midiOut->send(TAMidiMessage(TA_MIDI_CLOCK,0,0));
+      // the clock is due midiClockCycles after the end of this run
+      sendMidiOut(TAMidiMessage(TA_MIDI_CLOCK,0,0),totalCycles+midiClockCycles);
     }
 
     double hl=curSubSong->hilightA;
@@ -1877,7 +1830,7 @@ void DivEngine::runMidiTime(int totalCycles) {
           break;
       }
       val|=curMidiTimePiece<<4;
-      output->midiOut->send(TAMidiMessage(TA_MIDI_MTC_FRAME,val,0));
+      sendMidiOut(TAMidiMessage(TA_MIDI_MTC_FRAME,val,0),totalCycles+midiTimeCycles);
     }
     curMidiTimePiece=(curMidiTimePiece+1)&7;
 
@@ -1890,6 +1843,139 @@ void DivEngine::runMidiTime(int totalCycles) {
   }
 }
 
+void DivEngine::processMidiIn(TAMidiMessage& msg) {
+  int ins=-1;
+  if ((ins=midiCallback(msg))!=-2) {
+    int chan=msg.type&15;
+    switch (msg.type&0xf0) {
+      case TA_MIDI_NOTE_OFF: {
+        if (midiIsDirect) {
+          if (chan<0 || chan>=chans) break;
+          pendingNotes.push_back(DivNoteEvent(chan,-1,-1,-1,false,false,true));
+        } else {
+          autoNoteOff(msg.type&15,msg.data[0]-12,msg.data[1]);
+        }
+        if (!playing) {
+          reset();
+          freelance=true;
+          playing=true;
+        }
+        break;
+      }
+      case TA_MIDI_NOTE_ON: {
+        if (msg.data[1]==0) {
+          if (midiIsDirect) {
+            if (chan<0 || chan>=chans) break;
+            pendingNotes.push_back(DivNoteEvent(chan,-1,-1,-1,false,false,true));
+          } else {
+            autoNoteOff(msg.type&15,msg.data[0]-12,msg.data[1]);
+          }
+        } else {
+          if (midiIsDirect) {
+            if (chan<0 || chan>=chans) break;
+            pendingNotes.push_back(DivNoteEvent(chan,ins,msg.data[0]-12,msg.data[1],true,false,true));
+          } else {
+            autoNoteOn(msg.type&15,ins,msg.data[0]-12,msg.data[1]);
+          }
+        }
+        break;
+      }
+      case TA_MIDI_PROGRAM: {
+        if (midiIsDirect && midiIsDirectProgram) {
+          pendingNotes.push_back(DivNoteEvent(chan,msg.data[0],0,0,false,true,true));
+        }
+        break;
+      }
+    }
+  } else if (midiDebug) {
+    logD("callback wants ignore");
+  }
+}
+
+void DivEngine::processPendingNotes() {
+  if (!pendingNotes.empty()) {
+    bool isOn[DIV_MAX_CHANS];
+    memset(isOn,0,DIV_MAX_CHANS*sizeof(bool));
+    
+    for (int i=pendingNotes.size()-1; i>=0; i--) {
+      if (pendingNotes[i].channel<0 || pendingNotes[i].channel>=chans) continue;
+      if (pendingNotes[i].on) {
+        isOn[pendingNotes[i].channel]=true;
+      } else {
+        if (isOn[pendingNotes[i].channel]) {
+          //logV("erasing off -> on sequence in %d",pendingNotes[i].channel);
+          pendingNotes[i].nop=true;
+        }
+      }
+    }
+  }
+
+  while (!pendingNotes.empty()) {
+    DivNoteEvent& note=pendingNotes.front();
+    if (note.nop || note.channel<0 || note.channel>=chans) {
+      pendingNotes.pop_front();
+      continue;
+    }
+    if (note.insChange) {
+      dispatchCmd(DivCommand(DIV_CMD_INSTRUMENT,note.channel,note.ins,0));
+      pendingNotes.pop_front();
+      continue;
+    }
+    if (note.on) {
+      if (!(midiIsDirect && midiIsDirectProgram && note.fromMIDI)) {
+        dispatchCmd(DivCommand(DIV_CMD_INSTRUMENT,note.channel,note.ins,1));
+      }
+      if (note.volume>=0 && !disCont[dispatchOfChan[note.channel]].dispatch->isVolGlobal()) {
+        float curvedVol=pow((float)note.volume/127.0f,midiVolExp);
+        int mappedVol=disCont[dispatchOfChan[note.channel]].dispatch->mapVelocity(dispatchChanOfChan[note.channel],curvedVol);
+        dispatchCmd(DivCommand(DIV_CMD_VOLUME,note.channel,mappedVol));
+      }
+      dispatchCmd(DivCommand(DIV_CMD_NOTE_ON,note.channel,note.note));
+      keyHit[note.channel]=true;
+      chan[note.channel].releasing=false;
+      chan[note.channel].noteOnInhibit=true;
+      chan[note.channel].lastIns=note.ins;
+    } else {
+      DivMacroInt* macroInt=disCont[dispatchOfChan[note.channel]].dispatch->getChanMacroInt(dispatchChanOfChan[note.channel]);
+      if (macroInt!=NULL) {
+        if (macroInt->hasRelease && !disCont[dispatchOfChan[note.channel]].dispatch->isVolGlobal()) {
+          dispatchCmd(DivCommand(DIV_CMD_NOTE_OFF_ENV,note.channel));
+        } else {
+          dispatchCmd(DivCommand(DIV_CMD_NOTE_OFF,note.channel));
+        }
+      } else {
+        dispatchCmd(DivCommand(DIV_CMD_NOTE_OFF,note.channel));
+      }
+    }
+    pendingNotes.pop_front();
+  }
+}
+
+void DivEngine::runMidiIn(unsigned int pos, bool betweenTicks) {
+  while (!midiInEvents.empty()) {
+    DivMidiInEvent& ev=midiInEvents.front();
+    if (ev.pos>pos) break;
+    processMidiIn(ev.msg);
+    midiInEvents.pop_front();
+  }
+  if (!betweenTicks || pendingNotes.empty()) return;
+
+  // start the notes now instead of waiting for the next tick.
+  // only the chips that got notes are ticked.
+  bool mustTick[DIV_MAX_CHIPS];
+  memset(mustTick,0,DIV_MAX_CHIPS*sizeof(bool));
+  for (size_t i=0; i<pendingNotes.size(); i++) {
+    if (pendingNotes[i].channel<0 || pendingNotes[i].channel>=chans) continue;
+    mustTick[dispatchOfChan[pendingNotes[i].channel]]=true;
+  }
+  processPendingNotes();
+  midiSubTick=true;
+  for (int i=0; i<song.systemLen; i++) {
+    if (mustTick[i]) disCont[i].dispatch->tick(false);
+  }
+  midiSubTick=false;
+}
+
 void _runDispatch1(void* d) {
 }
 
@@ -1897,6 +1983,36 @@ void _runDispatch2(void* d) {
 
 }
 
+static inline unsigned int profTime(const std::chrono::steady_clock::time_point& begin, const std::chrono::steady_clock::time_point& end) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end-begin).count();
+}
+
+void DivEngine::flushDeferredRender(bool force) {
+  if (!force) {
+    for (int i=0; i<song.systemLen; i++) {
+      if (disCont[i].renderDeferred && disCont[i].dispatch->getRenderFlushNeeded()) {
+        force=true;
+        break;
+      }
+    }
+    if (!force) return;
+  }
+  bool pushed=false;
+  for (int i=0; i<song.systemLen; i++) {
+    if (!disCont[i].renderDeferred) continue;
+    if (disCont[i].runPos<=disCont[i].renderedPos) continue;
+    renderPool->push([](void* d) {
+      DivDispatchContainer* dc=(DivDispatchContainer*)d;
+      std::chrono::steady_clock::time_point ts_begin;
+      if (dc->profiling) ts_begin=std::chrono::steady_clock::now();
+      dc->acquireDeferred();
+      if (dc->profiling) dc->acquireTime+=profTime(ts_begin,std::chrono::steady_clock::now());
+    },&disCont[i]);
+    pushed=true;
+  }
+  if (pushed) renderPool->wait();
+}
+
 void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsigned int size) {
   lastNBIns=inChans;
   lastNBOuts=outChans;
@@ -1925,15 +2041,29 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
   got.bufsize=size;
 
   std::chrono::steady_clock::time_point ts_processBegin=std::chrono::steady_clock::now();
+  DivProfileFrame prof;
+  memset(&prof,0,sizeof(DivProfileFrame));
+  prof.size=size;
+  prof.chips=song.systemLen;
+  // only take per-chip/per-tick timestamps when someone is looking
+  bool profiling=profiler.isEnabled();
 
   if (renderPool==NULL) {
     unsigned int howManyThreads=song.systemLen;
     if (howManyThreads<2) howManyThreads=0;
     if (howManyThreads>renderPoolThreads) howManyThreads=renderPoolThreads;
-    renderPool=new DivWorkPool(howManyThreads);
+    if (renderPoolLockFree) {
+      renderPool=new DivLockFreeWorkPool(howManyThreads);
+    } else {
+      renderPool=new DivWorkPool(howManyThreads);
+    }
   }
 
   // process MIDI events (TODO: everything)
+  // while playing, messages are placed in this buffer at their offset from the start of the
+  // previous one, and processed at that position. this adds one buffer of latency, but no jitter.
+  double bufTime=std::chrono::duration<double>(ts_processBegin.time_since_epoch()).count();
+  unsigned int lastMidiInPos=0;
   if (output) if (output->midiIn) while (!output->midiIn->queue.empty()) {
     TAMidiMessage& msg=output->midiIn->queue.front();
     if (midiDebug) {
@@ -1943,55 +2073,26 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
         logD("MIDI debug: %.2X %.2X %.2X",msg.type,msg.data[0],msg.data[1]);
       }
     }
-    int ins=-1;
-    if ((ins=midiCallback(msg))!=-2) {
-      int chan=msg.type&15;
-      switch (msg.type&0xf0) {
-        case TA_MIDI_NOTE_OFF: {
-          if (midiIsDirect) {
-            if (chan<0 || chan>=chans) break;
-            pendingNotes.push_back(DivNoteEvent(chan,-1,-1,-1,false,false,true));
-          } else {
-            autoNoteOff(msg.type&15,msg.data[0]-12,msg.data[1]);
-          }
-          if (!playing) {
-            reset();
-            freelance=true;
-            playing=true;
-          }
-          break;
-        }
-        case TA_MIDI_NOTE_ON: {
-          if (msg.data[1]==0) {
-            if (midiIsDirect) {
-              if (chan<0 || chan>=chans) break;
-              pendingNotes.push_back(DivNoteEvent(chan,-1,-1,-1,false,false,true));
-            } else {
-              autoNoteOff(msg.type&15,msg.data[0]-12,msg.data[1]);
-            }
-          } else {
-            if (midiIsDirect) {
-              if (chan<0 || chan>=chans) break;
-              pendingNotes.push_back(DivNoteEvent(chan,ins,msg.data[0]-12,msg.data[1],true,false,true));
-            } else {
-              autoNoteOn(msg.type&15,ins,msg.data[0]-12,msg.data[1]);
-            }
-          }
-          break;
-        }
-        case TA_MIDI_PROGRAM: {
-          if (midiIsDirect && midiIsDirectProgram) {
-            pendingNotes.push_back(DivNoteEvent(chan,msg.data[0],0,0,false,true,true));
-          }
-          break;
-        }
+    if (playing && !halted) {
+      unsigned int pos=0;
+      if (msg.time>0.0 && midiInLastBuf>0.0 && msg.time>midiInLastBuf) {
+        double offset=(msg.time-midiInLastBuf)*got.rate;
+        pos=(offset>=size)?(size-1):(unsigned int)offset;
       }
-    } else if (midiDebug) {
-      logD("callback wants ignore");
+      if (pos<lastMidiInPos) pos=lastMidiInPos;
+      lastMidiInPos=pos;
+      midiInEvents.push_back(DivMidiInEvent(pos,msg));
+    } else {
+      processMidiIn(msg);
     }
     //logD("%.2x",msg.type);
     output->midiIn->queue.pop();
   }
+  midiInLastBuf=bufTime;
+  // MIDI output is sent one buffer late, which is roughly when this buffer will be heard
+  midiOutBufTime=bufTime+(double)size/got.rate;
+  std::chrono::steady_clock::time_point ts_midiEnd=std::chrono::steady_clock::now();
+  prof.stage[DIV_PROFILE_MIDI_IN]=profTime(ts_processBegin,ts_midiEnd);
   
   // process sample/wave preview
   if ((sPreview.sample>=0 && sPreview.sample<(int)song.sample.size()) || (sPreview.wave>=0 && sPreview.wave<(int)song.wave.size())) {
@@ -2139,12 +2240,17 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
   } else {
     memset(samp_bbOut,0,size*sizeof(short));
   }
+  std::chrono::steady_clock::time_point ts_previewEnd=std::chrono::steady_clock::now();
+  prof.stage[DIV_PROFILE_SAMPLE_PREVIEW]=profTime(ts_midiEnd,ts_previewEnd);
 
   // process audio
   bool mustPlay=playing && !halted;
   if (mustPlay) {
     // logic starts here
     for (int i=0; i<song.systemLen; i++) {
+      disCont[i].acquireTime=0;
+      disCont[i].fillBufTime=0;
+      disCont[i].profiling=profiling;
       // TODO: we may have a problem here
       disCont[i].lastAvail=blip_samples_avail(disCont[i].bb[0]);
       if (disCont[i].lastAvail>0) {
@@ -2161,6 +2267,10 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       }
       disCont[i].runLeft=disCont[i].runtotal;
       disCont[i].runPos=0;
+      // chips which support it are rendered once all ticks in this buffer are done
+      disCont[i].renderDeferred=renderPerBuffer && disCont[i].dispatch->getRenderPerBuffer();
+      disCont[i].renderedPos=0;
+      disCont[i].dispatch->setRenderPos(disCont[i].renderDeferred?0:-1);
     }
 
     if (metroTickLen<size) {
@@ -2182,10 +2292,21 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       // 1. check whether we are done with all buffers
       if (runLeftG<=0) break;
 
+      // 1.5. process MIDI input events which are due
+      if (!midiInEvents.empty()) {
+        runMidiIn(bufferPos>>MASTER_CLOCK_PREC,cycles>0);
+        if (renderPerBuffer) flushDeferredRender(false);
+      }
+
       // 2. check whether we gonna tick
       if (cycles<=0) {
         // we have to tick
-        if (nextTick()) {
+        std::chrono::steady_clock::time_point ts_tickBegin;
+        if (profiling) ts_tickBegin=std::chrono::steady_clock::now();
+        bool looped=nextTick();
+        if (profiling) prof.stage[DIV_PROFILE_TICK]+=profTime(ts_tickBegin,std::chrono::steady_clock::now());
+        if (renderPerBuffer) flushDeferredRender(false);
+        if (looped) {
           /*totalTicks=0;
           totalSeconds=0;*/
           lastLoopPos=size-(runLeftG>>MASTER_CLOCK_PREC);
@@ -2210,37 +2331,63 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
           pendingMetroTick=0;
         }
       } else {
+        // stop at the next MIDI input event
+        int runCycles=cycles;
+        if (!midiInEvents.empty()) {
+          int untilEvent=(int)(midiInEvents.front().pos<<MASTER_CLOCK_PREC)-(int)bufferPos;
+          if (untilEvent>0 && untilEvent<runCycles) runCycles=untilEvent;
+        }
+
         // 3. run MIDI clock
-        int midiTotal=MIN(cycles,runLeftG);
+        int midiTotal=MIN(runCycles,runLeftG);
         runMidiClock(midiTotal);
 
         // 4. run MIDI timecode
         runMidiTime(midiTotal);
 
         // 5. tick the clock and fill buffers as needed
-        if (cycles<runLeftG) {
+        if (runCycles<runLeftG) {
           for (int i=0; i<song.systemLen; i++) {
-            disCont[i].cycles=cycles;
+            if (disCont[i].renderDeferred) {
+              // just move forward. writes from now on belong to the new position
+              int total=(runCycles*disCont[i].runtotal)/(size<<MASTER_CLOCK_PREC);
+              disCont[i].runLeft-=total;
+              disCont[i].runPos+=total;
+              disCont[i].dispatch->setRenderPos(disCont[i].runPos);
+              continue;
+            }
+            disCont[i].cycles=runCycles;
             disCont[i].size=size;
             renderPool->push([](void* d) {
               DivDispatchContainer* dc=(DivDispatchContainer*)d;
+              std::chrono::steady_clock::time_point ts_begin;
+              if (dc->profiling) ts_begin=std::chrono::steady_clock::now();
               int total=(dc->cycles*dc->runtotal)/(dc->size<<MASTER_CLOCK_PREC);
               dc->acquire(dc->runPos,total);
               dc->runLeft-=total;
               dc->runPos+=total;
+              if (dc->profiling) dc->acquireTime+=profTime(ts_begin,std::chrono::steady_clock::now());
             },&disCont[i]);
           }
           renderPool->wait();
-          runLeftG-=cycles;
-          cycles=0;
+          runLeftG-=runCycles;
+          cycles-=runCycles;
         } else {
           cycles-=runLeftG;
           runLeftG=0;
           for (int i=0; i<song.systemLen; i++) {
             renderPool->push([](void* d) {
               DivDispatchContainer* dc=(DivDispatchContainer*)d;
-              dc->acquire(dc->runPos,dc->runLeft);
+              std::chrono::steady_clock::time_point ts_begin;
+              if (dc->profiling) ts_begin=std::chrono::steady_clock::now();
+              if (dc->renderDeferred) {
+                dc->runPos+=dc->runLeft;
+                dc->acquireDeferred();
+              } else {
+                dc->acquire(dc->runPos,dc->runLeft);
+              }
               dc->runLeft=0;
+              if (dc->profiling) dc->acquireTime+=profTime(ts_begin,std::chrono::steady_clock::now());
             },&disCont[i]);
           }
           renderPool->wait();
@@ -2248,6 +2395,16 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       }
     }
 
+    // in case we stopped early
+    if (!midiInEvents.empty()) runMidiIn(size,false);
+    if (renderPerBuffer) {
+      flushDeferredRender(true);
+      // writes outside of nextBuf happen immediately
+      for (int i=0; i<song.systemLen; i++) {
+        if (disCont[i].renderDeferred) disCont[i].dispatch->setRenderPos(-1);
+      }
+    }
+
     //logD("attempts: %d",attempts);
     if (attempts>=(int)(size+10)) {
       logE("hang detected! stopping! at %d seconds %d micro (%d>=%d)",totalSeconds,totalTicks,attempts,(int)size);
@@ -2257,6 +2414,10 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     }
     totalProcessed=size-(runLeftG>>MASTER_CLOCK_PREC);
 
+    std::chrono::steady_clock::time_point ts_acquireEnd=std::chrono::steady_clock::now();
+    unsigned int acquireTotal=profTime(ts_previewEnd,ts_acquireEnd);
+    prof.stage[DIV_PROFILE_ACQUIRE]=(acquireTotal>prof.stage[DIV_PROFILE_TICK])?(acquireTotal-prof.stage[DIV_PROFILE_TICK]):0;
+
     for (int i=0; i<song.systemLen; i++) {
       if (size<disCont[i].lastAvail) {
         logW("%d: size<lastAvail! %d<%d",i,size,disCont[i].lastAvail);
@@ -2265,11 +2426,21 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       disCont[i].size=size;
       renderPool->push([](void* d) {
         DivDispatchContainer* dc=(DivDispatchContainer*)d;
+        std::chrono::steady_clock::time_point ts_begin;
+        if (dc->profiling) ts_begin=std::chrono::steady_clock::now();
         dc->fillBuf(dc->runtotal,dc->lastAvail,dc->size-dc->lastAvail);
+        if (dc->profiling) dc->fillBufTime=profTime(ts_begin,std::chrono::steady_clock::now());
       },&disCont[i]);
     }
     renderPool->wait();
+
+    prof.stage[DIV_PROFILE_FILL_BUF]=profTime(ts_acquireEnd,std::chrono::steady_clock::now());
+    for (int i=0; i<song.systemLen; i++) {
+      prof.chipAcquire[i]=disCont[i].acquireTime;
+      prof.chipFillBuf[i]=disCont[i].fillBufTime;
+    }
   }
+  std::chrono::steady_clock::time_point ts_mixBegin=std::chrono::steady_clock::now();
 
   // process metronome
   if (metroBufLen<size || metroBuf==NULL) {
@@ -2362,6 +2533,9 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     // nothing/invalid
   }
 
+  std::chrono::steady_clock::time_point ts_mixEnd=std::chrono::steady_clock::now();
+  prof.stage[DIV_PROFILE_MIX]=profTime(ts_mixBegin,ts_mixEnd);
+
   // dump to oscillator buffer
   for (unsigned int i=0; i<size; i++) {
     for (int j=0; j<outChans; j++) {
@@ -2371,6 +2545,7 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
     if (++oscWritePos>=32768) oscWritePos=0;
   }
   oscSize=size;
+  prof.stage[DIV_PROFILE_OSC]=profTime(ts_mixEnd,std::chrono::steady_clock::now());
 
   // force mono audio (if enabled)
   if (forceMono && outChans>1) {
@@ -2395,9 +2570,15 @@ void DivEngine::nextBuf(float** in, float** out, int inChans, int outChans, unsi
       }
     }
   }
+  midiOutBufTime=0.0;
   isBusy.unlock();
 
   std::chrono::steady_clock::time_point ts_processEnd=std::chrono::steady_clock::now();
 
   processTime=std::chrono::duration_cast<std::chrono::nanoseconds>(ts_processEnd-ts_processBegin).count();
+
+  if (profiling) {
+    prof.stage[DIV_PROFILE_TOTAL]=processTime;
+    profiler.push(prof);
+  }
 }
@@ -0,0 +1,145 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "profiler.h"
+#include "../ta-utils.h"
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+static const char* stageNames[DIV_PROFILE_STAGE_MAX]={
+  _N("Total"),
+  _N("MIDI input"),
+  _N("Sample preview"),
+  _N("Playback logic"),
+  _N("Chip emulation"),
+  _N("Buffer fill"),
+  _N("Mix"),
+  _N("Oscilloscope")
+};
+
+const char* DivProfiler::stageName(int stage) {
+  if (stage<0 || stage>=DIV_PROFILE_STAGE_MAX) return "???";
+  return stageNames[stage];
+}
+
+void DivProfiler::enable(bool enable) {
+  enabled=enable;
+}
+
+bool DivProfiler::isEnabled() {
+  return enabled;
+}
+
+void DivProfiler::push(const DivProfileFrame& frame) {
+  size_t pos=writePos.load(std::memory_order_relaxed);
+  memcpy(&frames[pos%DIV_PROFILER_FRAMES],&frame,sizeof(DivProfileFrame));
+  writePos.store(pos+1,std::memory_order_release);
+}
+
+size_t DivProfiler::count() {
+  return writePos.load(std::memory_order_acquire);
+}
+
+void DivProfiler::clear() {
+  writePos=0;
+}
+
+size_t DivProfiler::read(DivProfileFrame* out, size_t count) {
+  size_t pos=writePos.load(std::memory_order_acquire);
+  if (count>DIV_PROFILER_READ_MAX) count=DIV_PROFILER_READ_MAX;
+  if (count>pos) count=pos;
+  for (size_t i=0; i<count; i++) {
+    memcpy(&out[i],&frames[(pos-count+i)%DIV_PROFILER_FRAMES],sizeof(DivProfileFrame));
+  }
+  return count;
+}
+
+static DivProfileStats calcStats(std::vector<unsigned int>& values) {
+  DivProfileStats ret;
+  if (values.empty()) return ret;
+  std::sort(values.begin(),values.end());
+  double sum=0;
+  for (unsigned int i: values) sum+=i;
+  size_t last=values.size()-1;
+  ret.min=values[0];
+  ret.max=values[last];
+  ret.avg=sum/(double)values.size();
+  ret.p50=values[(last*50)/100];
+  ret.p95=values[(last*95)/100];
+  ret.p99=values[(last*99)/100];
+  return ret;
+}
+
+DivProfileSummary DivProfiler::summarize(size_t count) {
+  DivProfileSummary ret;
+  std::vector<DivProfileFrame> f(MIN(count,(size_t)DIV_PROFILER_READ_MAX));
+  if (f.empty()) return ret;
+  size_t total=read(f.data(),f.size());
+  if (total==0) return ret;
+
+  std::vector<unsigned int> values;
+  values.reserve(total);
+  ret.frames=total;
+  ret.chips=f[total-1].chips;
+
+  for (size_t i=0; i<total; i++) {
+    ret.size+=f[i].size;
+  }
+  ret.size/=(double)total;
+
+  for (int i=0; i<DIV_PROFILE_STAGE_MAX; i++) {
+    values.clear();
+    for (size_t j=0; j<total; j++) {
+      values.push_back(f[j].stage[i]);
+    }
+    ret.stage[i]=calcStats(values);
+  }
+
+  // the chip setup may change while playing, so only frames with the chip count of the latest one are used
+  for (int i=0; i<ret.chips; i++) {
+    values.clear();
+    for (size_t j=0; j<total; j++) {
+      if (f[j].chips!=ret.chips) continue;
+      values.push_back(f[j].chipAcquire[i]);
+    }
+    ret.chipAcquire[i]=calcStats(values);
+
+    values.clear();
+    for (size_t j=0; j<total; j++) {
+      if (f[j].chips!=ret.chips) continue;
+      values.push_back(f[j].chipFillBuf[i]);
+    }
+    ret.chipFillBuf[i]=calcStats(values);
+  }
+
+  return ret;
+}
+
+DivProfiler::DivProfiler():
+  frames(NULL) {
+  frames=new DivProfileFrame[DIV_PROFILER_FRAMES];
+  memset(frames,0,DIV_PROFILER_FRAMES*sizeof(DivProfileFrame));
+  writePos=0;
+  enabled=false;
+}
+
+DivProfiler::~DivProfiler() {
+  delete[] frames;
+}
@@ -0,0 +1,103 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include <stddef.h>
+#include <atomic>
+#include "defines.h"
+
+#define DIV_PROFILER_FRAMES 4096
+#define DIV_PROFILER_READ_MAX (DIV_PROFILER_FRAMES/2)
+
+enum DivProfileStage {
+  DIV_PROFILE_TOTAL=0,
+  DIV_PROFILE_MIDI_IN,
+  DIV_PROFILE_SAMPLE_PREVIEW,
+  DIV_PROFILE_TICK,
+  DIV_PROFILE_ACQUIRE,
+  DIV_PROFILE_FILL_BUF,
+  DIV_PROFILE_MIX,
+  DIV_PROFILE_OSC,
+
+  DIV_PROFILE_STAGE_MAX
+};
+
+// timings of one nextBuf() call, in nanoseconds
+struct DivProfileFrame {
+  unsigned int size;
+  int chips;
+  unsigned int stage[DIV_PROFILE_STAGE_MAX];
+  unsigned int chipAcquire[DIV_MAX_CHIPS];
+  unsigned int chipFillBuf[DIV_MAX_CHIPS];
+};
+
+// statistics of a timing over a range of frames, in nanoseconds
+struct DivProfileStats {
+  double min, avg, max;
+  double p50, p95, p99;
+  DivProfileStats():
+    min(0), avg(0), max(0),
+    p50(0), p95(0), p99(0) {}
+};
+
+struct DivProfileSummary {
+  size_t frames;
+  int chips;
+  // average buffer size
+  double size;
+  DivProfileStats stage[DIV_PROFILE_STAGE_MAX];
+  DivProfileStats chipAcquire[DIV_MAX_CHIPS];
+  DivProfileStats chipFillBuf[DIV_MAX_CHIPS];
+  DivProfileSummary():
+    frames(0),
+    chips(0),
+    size(0) {}
+};
+
+// ring of profile frames.
+// written by the audio thread and read by anyone without locking.
+// only the most recent half of the ring may be read, so that the frames
+// being read are not overwritten in the meantime.
+class DivProfiler {
+  DivProfileFrame* frames;
+  std::atomic<size_t> writePos;
+  std::atomic<bool> enabled;
+
+  public:
+    static const char* stageName(int stage);
+
+    void enable(bool enable);
+    bool isEnabled();
+    // called by the audio thread
+    void push(const DivProfileFrame& frame);
+    // number of frames pushed since creation or the last clear()
+    size_t count();
+    void clear();
+    // copy up to count of the most recent frames to out. returns number of frames copied.
+    size_t read(DivProfileFrame* out, size_t count);
+    // compute statistics over up to count of the most recent frames.
+    DivProfileSummary summarize(size_t count=DIV_PROFILER_READ_MAX);
+
+    DivProfiler();
+    ~DivProfiler();
+};
+
+#endif
@@ -22,24 +22,125 @@
 
 //#define READ_DEBUG
 
+unsigned char* SafeReaderStream::addBlock() {
+  unsigned char* block=new unsigned char[SAFEREADER_BLOCK_SIZE];
+  std::lock_guard<std::mutex> guard(lock);
+  blocks.push_back(block);
+  return block;
+}
+
+unsigned char* SafeReaderStream::getBlock(size_t index) {
+  std::lock_guard<std::mutex> guard(lock);
+  return blocks[index];
+}
+
+void SafeReaderStream::publish(size_t amount) {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    filled=amount;
+  }
+  notify.notify_all();
+}
+
+void SafeReaderStream::finish(bool error) {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    finished=true;
+    failed=error;
+  }
+  notify.notify_all();
+}
+
+size_t SafeReaderStream::waitFor(size_t amount, bool& done) {
+  std::unique_lock<std::mutex> guard(lock);
+  notify.wait(guard,[this,amount]() {
+    return filled>=amount || finished;
+  });
+  done=finished;
+  return filled;
+}
+
+bool SafeReaderStream::hasFailed() {
+  std::lock_guard<std::mutex> guard(lock);
+  return failed;
+}
+
+unsigned char* SafeReaderStream::flatten() {
+  unsigned char* ret=new unsigned char[filled];
+  size_t pos=0;
+  for (unsigned char*& i: blocks) {
+    size_t amount=MIN(filled-pos,(size_t)SAFEREADER_BLOCK_SIZE);
+    memcpy(ret+pos,i,amount);
+    pos+=amount;
+    delete[] i;
+    i=NULL;
+  }
+  blocks.clear();
+  return ret;
+}
+
+SafeReaderStream::~SafeReaderStream() {
+  for (unsigned char* i: blocks) {
+    delete[] i;
+  }
+}
+
+bool SafeReader::waitFor(size_t amount) {
+  if (amount<=avail) return true;
+  if (stream==NULL || amount>len) return false;
+  bool done=false;
+  avail=stream->waitFor(amount,done);
+  if (done) len=avail;
+  return amount<=avail;
+}
+
+void SafeReader::get(void* where, size_t count) {
+  if (curSeek+count>avail) {
+    if (!waitFor(curSeek+count)) throw EndOfFileException(this,len);
+  }
+  if (stream==NULL) {
+    memcpy(where,&buf[curSeek],count);
+    return;
+  }
+  // the data may span several blocks
+  unsigned char* out=(unsigned char*)where;
+  size_t pos=curSeek;
+  while (count>0) {
+    size_t index=pos>>SAFEREADER_BLOCK_BITS;
+    size_t offset=pos&(SAFEREADER_BLOCK_SIZE-1);
+    if (index!=blockIndex) {
+      block=stream->getBlock(index);
+      blockIndex=index;
+    }
+    size_t amount=MIN(count,SAFEREADER_BLOCK_SIZE-offset);
+    memcpy(out,block+offset,amount);
+    out+=amount;
+    pos+=amount;
+    count-=amount;
+  }
+}
+
 bool SafeReader::seek(ssize_t where, int whence) {
   switch (whence) {
     case SEEK_SET:
       if (where<0) return false;
-      if (where>(ssize_t)len) return false;
+      if ((size_t)where>avail) waitFor(where);
+      if ((size_t)where>len) return false;
       curSeek=where;
       break;
     case SEEK_CUR: {
       ssize_t finalSeek=curSeek+where;
       if (finalSeek<0) return false;
-      if (finalSeek>(ssize_t)len) return false;
+      if ((size_t)finalSeek>avail) waitFor(finalSeek);
+      if ((size_t)finalSeek>len) return false;
       curSeek=finalSeek;
       break;
     }
     case SEEK_END: {
+      size();
       ssize_t finalSeek=len-where;
       if (finalSeek<0) return false;
-      if (finalSeek>(ssize_t)len) return false;
+      if ((size_t)finalSeek>len) return false;
       curSeek=finalSeek;
       break;
     }
@@ -47,11 +148,18 @@ bool SafeReader::seek(ssize_t where, int whence) {
   return true;
 }
 
+bool SafeReader::isEOF() {
+  if (curSeek<avail) return false;
+  return !waitFor(curSeek+1);
+}
+
 size_t SafeReader::tell() {
   return curSeek;
 }
 
 size_t SafeReader::size() {
+  // the size of a stream is only known once it is complete
+  if (stream!=NULL) waitFor(SIZE_MAX);
   return len;
 }
 
@@ -60,8 +168,7 @@ int SafeReader::read(void* where, size_t count) {
   logD("SR: reading %d bytes at %x",count,curSeek);
 #endif
   if (count==0) return 0;
-  if (curSeek+count>len) throw EndOfFileException(this,len);
-  memcpy(where,&buf[curSeek],count);
+  get(where,count);
   curSeek+=count;
   return count;
 }
@@ -70,11 +177,13 @@ signed char SafeReader::readC() {
 #ifdef READ_DEBUG
   logD("SR: reading char %x:",curSeek);
 #endif
-  if (curSeek+1>len) throw EndOfFileException(this,len);
+  signed char ret;
+  get(&ret,1);
 #ifdef READ_DEBUG
-  logD("SR: %.2x",buf[curSeek]);
+  logD("SR: %.2x",(unsigned char)ret);
 #endif
-  return (signed char)buf[curSeek++];
+  curSeek++;
+  return ret;
 }
 
 #ifdef TA_BIG_ENDIAN
@@ -82,9 +191,8 @@ short SafeReader::readS_BE() {
 #ifdef READ_DEBUG
   logD("SR: reading short %x:",curSeek);
 #endif
-  if (curSeek+2>len) throw EndOfFileException(this,len);
   short ret;
-  memcpy(&ret,&buf[curSeek],2);
+  get(&ret,2);
 #ifdef READ_DEBUG
   logD("SR: %.4x",ret);
 #endif
@@ -93,9 +201,8 @@ short SafeReader::readS_BE() {
 }
 
 short SafeReader::readS() {
-  if (curSeek+2>len) throw EndOfFileException(this,len);
   short ret;
-  memcpy(&ret,&buf[curSeek],2);
+  get(&ret,2);
   curSeek+=2;
   return ((ret>>8)&0xff)|(ret<<8);
 }
@@ -104,9 +211,8 @@ int SafeReader::readI_BE() {
 #ifdef READ_DEBUG
   logD("SR: reading int %x:",curSeek);
 #endif
-  if (curSeek+4>len) throw EndOfFileException(this,len);
   int ret;
-  memcpy(&ret,&buf[curSeek],4);
+  get(&ret,4);
   curSeek+=4;
 #ifdef READ_DEBUG
   logD("SR: %.8x",ret);
@@ -115,25 +221,22 @@ int SafeReader::readI_BE() {
 }
 
 int SafeReader::readI() {
-  if (curSeek+4>len) throw EndOfFileException(this,len);
   unsigned int ret;
-  memcpy(&ret,&buf[curSeek],4);
+  get(&ret,4);
   curSeek+=4;
   return (int)((ret>>24)|((ret&0xff0000)>>8)|((ret&0xff00)<<8)|((ret&0xff)<<24));
 }
 
 int64_t SafeReader::readL() {
-  if (curSeek+8>len) throw EndOfFileException(this,len);
   unsigned char ret[8];
-  memcpy(ret,&buf[curSeek],8);
+  get(ret,8);
   curSeek+=8;
   return (int64_t)(ret[0]|(ret[1]<<8)|(ret[2]<<16)|(ret[3]<<24)|((uint64_t)ret[4]<<32)|((uint64_t)ret[5]<<40)|((uint64_t)ret[6]<<48)|((uint64_t)ret[7]<<56));
 }
 
 float SafeReader::readF() {
-  if (curSeek+4>len) throw EndOfFileException(this,len);
   unsigned int ret;
-  memcpy(&ret,&buf[curSeek],4);
+  get(&ret,4);
   curSeek+=4;
   ret=((ret>>24)|((ret&0xff0000)>>8)|((ret&0xff00)<<8)|((ret&0xff)<<24));
   float realRet;
@@ -142,10 +245,9 @@ float SafeReader::readF() {
 }
 
 double SafeReader::readD() {
-  if (curSeek+8>len) throw EndOfFileException(this,len);
   unsigned char ret[8];
   unsigned char retB[8];
-  memcpy(ret,&buf[curSeek],8);
+  get(ret,8);
   curSeek+=8;
   retB[0]=ret[7];
   retB[1]=ret[6];
@@ -164,9 +266,8 @@ short SafeReader::readS() {
 #ifdef READ_DEBUG
   logD("SR: reading short %x:",curSeek);
 #endif
-  if (curSeek+2>len) throw EndOfFileException(this,len);
   short ret;
-  memcpy(&ret,&buf[curSeek],2);
+  get(&ret,2);
 #ifdef READ_DEBUG
   logD("SR: %.4x",ret);
 #endif
@@ -175,9 +276,8 @@ short SafeReader::readS() {
 }
 
 short SafeReader::readS_BE() {
-  if (curSeek+2>len) throw EndOfFileException(this,len);
   short ret;
-  memcpy(&ret,&buf[curSeek],2);
+  get(&ret,2);
   curSeek+=2;
   return ((ret>>8)&0xff)|(ret<<8);
 }
@@ -186,9 +286,8 @@ int SafeReader::readI() {
 #ifdef READ_DEBUG
   logD("SR: reading int %x:",curSeek);
 #endif
-  if (curSeek+4>len) throw EndOfFileException(this,len);
   int ret;
-  memcpy(&ret,&buf[curSeek],4);
+  get(&ret,4);
   curSeek+=4;
 #ifdef READ_DEBUG
   logD("SR: %.8x",ret);
@@ -197,33 +296,29 @@ int SafeReader::readI() {
 }
 
 int SafeReader::readI_BE() {
-  if (curSeek+4>len) throw EndOfFileException(this,len);
   unsigned int ret;
-  memcpy(&ret,&buf[curSeek],4);
+  get(&ret,4);
   curSeek+=4;
   return (int)((ret>>24)|((ret&0xff0000)>>8)|((ret&0xff00)<<8)|((ret&0xff)<<24));
 }
 
 int64_t SafeReader::readL() {
-  if (curSeek+8>len) throw EndOfFileException(this,len);
   int64_t ret;
-  memcpy(&ret,&buf[curSeek],8);
+  get(&ret,8);
   curSeek+=8;
   return ret;
 }
 
 float SafeReader::readF() {
-  if (curSeek+4>len) throw EndOfFileException(this,len);
   float ret;
-  memcpy(&ret,&buf[curSeek],4);
+  get(&ret,4);
   curSeek+=4;
   return ret;
 }
 
 double SafeReader::readD() {
-  if (curSeek+8>len) throw EndOfFileException(this,len);
   double ret;
-  memcpy(&ret,&buf[curSeek],8);
+  get(&ret,8);
   curSeek+=8;
   return ret;
 }
@@ -22,8 +22,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
 #include "../ta-utils.h"
 
+#define SAFEREADER_BLOCK_BITS 17
+#define SAFEREADER_BLOCK_SIZE (1<<SAFEREADER_BLOCK_BITS)
+
 enum Endianness {
   LittleEndian=0,
   BigEndian
@@ -39,12 +45,62 @@ struct EndOfFileException {
     finalSize(fs) {}
 };
 
+/**
+ * data which is being written by another thread (e.g. while decompressing), in blocks of
+ * SAFEREADER_BLOCK_SIZE bytes. the total size is not known until it is finished.
+ * a SafeReader reading from it waits for data to arrive.
+ */
+class SafeReaderStream {
+  std::vector<unsigned char*> blocks;
+  // amount of data which is ready
+  size_t filled;
+  // no more data will arrive
+  bool finished;
+  bool failed;
+  std::mutex lock;
+  std::condition_variable notify;
+
+  public:
+    // called by the writer. blocks are filled in order.
+    unsigned char* addBlock();
+    // make the first amount bytes available to readers.
+    void publish(size_t amount);
+    // no more data will arrive.
+    void finish(bool error=false);
+
+    // wait until amount bytes are ready or the stream is finished.
+    // returns the amount of data which is ready, and sets done if it's final.
+    size_t waitFor(size_t amount, bool& done);
+    unsigned char* getBlock(size_t index);
+    bool hasFailed();
+    // move the data into a single buffer, freeing blocks along the way.
+    // only call this once the writer is done. the stream becomes empty.
+    unsigned char* flatten();
+
+    SafeReaderStream():
+      filled(0),
+      finished(false),
+      failed(false) {}
+    ~SafeReaderStream();
+};
+
 class SafeReader {
   const unsigned char* buf;
   size_t len;
+  // data up to this point can be read without waiting
+  size_t avail;
+  SafeReaderStream* stream;
+  // last block used when reading from a stream
+  const unsigned char* block;
+  size_t blockIndex;
 
   size_t curSeek;
 
+  // wait for data up to amount. returns false if it will never arrive.
+  bool waitFor(size_t amount);
+  // copy count bytes at curSeek to where. throws EndOfFileException if not available.
+  void get(void* where, size_t count);
+
   public:
     bool seek(ssize_t where, int whence);
     size_t tell();
@@ -69,11 +125,24 @@ class SafeReader {
     String readStringLine();
     String readStringToken(unsigned char delim, bool stripContiguous);
     String readStringToken();
-    inline bool isEOF() { return curSeek >= len; };
+    bool isEOF();
 
     SafeReader(const void* b, size_t l):
       buf((const unsigned char*)b),
       len(l),
+      avail(l),
+      stream(NULL),
+      block(NULL),
+      blockIndex(SIZE_MAX),
+      curSeek(0) {}
+
+    SafeReader(SafeReaderStream* s):
+      buf(NULL),
+      len(SIZE_MAX),
+      avail(0),
+      stream(s),
+      block(NULL),
+      blockIndex(SIZE_MAX),
       curSeek(0) {}
 };
 
@@ -523,6 +523,12 @@ bool DivSample::saveRaw(const char* path) {
 // 16-bit memory is padded to 512, to make things easier for ADPCM-A/B.
 bool DivSample::initInternal(DivSampleDepth d, int count) {
   logV("initInternal(%d,%d)",(int)d,count);
+  // rendered data is about to change
+  renderHash=0;
+  // data16 is drawn when the sample isn't 8/16-bit, and it's being replaced
+  if (d==DIV_SAMPLE_DEPTH_16BIT && depth!=DIV_SAMPLE_DEPTH_16BIT && depth!=DIV_SAMPLE_DEPTH_8BIT) {
+    invalidateMipmap();
+  }
   switch (d) {
     case DIV_SAMPLE_DEPTH_1BIT: // 1-bit
       if (data1!=NULL) delete[] data1;
@@ -619,6 +625,7 @@ bool DivSample::initInternal(DivSampleDepth d, int count) {
 bool DivSample::init(unsigned int count) {
   if (!initInternal(depth,count)) return false;
   setSampleCount(count);
+  invalidateMipmap();
   return true;
 }
 
@@ -633,6 +640,7 @@ bool DivSample::resize(unsigned int count) {
     } else {
       initInternal(DIV_SAMPLE_DEPTH_8BIT,count);
     }
+    invalidateMipmap(MIN(count,samples));
     setSampleCount(count);
     return true;
   } else if (depth==DIV_SAMPLE_DEPTH_16BIT) {
@@ -645,6 +653,7 @@ bool DivSample::resize(unsigned int count) {
     } else {
       initInternal(DIV_SAMPLE_DEPTH_16BIT,count);
     }
+    invalidateMipmap(MIN(count,samples));
     setSampleCount(count);
     return true;
   }
@@ -699,6 +708,7 @@ bool DivSample::strip(unsigned int begin, unsigned int end) {
       // do nothing
       return true;
     }
+    invalidateMipmap(begin);
     setSampleCount(count);
     return true;
   } else if (depth==DIV_SAMPLE_DEPTH_16BIT) {
@@ -717,6 +727,7 @@ bool DivSample::strip(unsigned int begin, unsigned int end) {
       // do nothing
       return true;
     }
+    invalidateMipmap(begin);
     setSampleCount(count);
     return true;
   }
@@ -748,6 +759,7 @@ bool DivSample::trim(unsigned int begin, unsigned int end) {
       // do nothing
       return true;
     }
+    if (begin>0) invalidateMipmap();
     setSampleCount(count);
     return true;
   } else if (depth==DIV_SAMPLE_DEPTH_16BIT) {
@@ -761,6 +773,7 @@ bool DivSample::trim(unsigned int begin, unsigned int end) {
       // do nothing
       return true;
     }
+    if (begin>0) invalidateMipmap();
     setSampleCount(count);
     return true;
   }
@@ -784,6 +797,7 @@ bool DivSample::insert(unsigned int pos, unsigned int length) {
     } else {
       initInternal(DIV_SAMPLE_DEPTH_8BIT,count);
     }
+    invalidateMipmap(pos);
     setSampleCount(count);
     return true;
   } else if (depth==DIV_SAMPLE_DEPTH_16BIT) {
@@ -801,6 +815,7 @@ bool DivSample::insert(unsigned int pos, unsigned int length) {
     } else {
       initInternal(DIV_SAMPLE_DEPTH_16BIT,count);
     }
+    invalidateMipmap(pos);
     setSampleCount(count);
     return true;
   }
@@ -810,6 +825,7 @@ bool DivSample::insert(unsigned int pos, unsigned int length) {
 void DivSample::convert(DivSampleDepth newDepth, unsigned int formatMask) {
   render(formatMask|(1U<<newDepth));
   depth=newDepth;
+  invalidateMipmap();
   switch (depth) {
     case DIV_SAMPLE_DEPTH_1BIT:
       setSampleCount((samples+7)&(~7));
@@ -873,6 +889,7 @@ void DivSample::convert(DivSampleDepth newDepth, unsigned int formatMask) {
   centerRate=(int)((double)centerRate*(tRate/sRate)); \
   rate=(int)((double)rate*(tRate/sRate)); \
   samples=finalCount; \
+  invalidateMipmap(); \
   if (depth==DIV_SAMPLE_DEPTH_16BIT) { \
     delete[] oldData16; \
   } else if (depth==DIV_SAMPLE_DEPTH_8BIT) { \
@@ -1554,6 +1571,251 @@ unsigned int DivSample::getCurBufLen() {
   return 0;
 }
 
+unsigned long long DivSample::getRenderHash(unsigned int formatMask) {
+  unsigned long long h=0xcbf29ce484222325ULL;
+#define RENDER_HASH(x) \
+  h=(h^(unsigned long long)(x))*0x9e3779b97f4a7c15ULL; \
+  h^=h>>29;
+
+  RENDER_HASH(depth);
+  RENDER_HASH(samples);
+  RENDER_HASH(formatMask);
+  RENDER_HASH(loop);
+  RENDER_HASH((unsigned int)loopStart);
+  RENDER_HASH((unsigned int)loopEnd);
+  RENDER_HASH(brrEmphasis);
+  RENDER_HASH(dither);
+
+  const unsigned char* buf=(const unsigned char*)getCurBuf();
+  unsigned int len=getCurBufLen();
+  RENDER_HASH(len);
+  if (buf!=NULL) {
+    unsigned int i=0;
+    for (; i+8<=len; i+=8) {
+      unsigned long long next;
+      memcpy(&next,&buf[i],8);
+      RENDER_HASH(next);
+    }
+    for (; i<len; i++) {
+      RENDER_HASH(buf[i]);
+    }
+  }
+#undef RENDER_HASH
+
+  // 0 means "not rendered"
+  return h?h:1;
+}
+
+void* DivSample::getBuf(DivSampleDepth d, unsigned int* allocLen) {
+  // these must match the allocations in initInternal()
+  void* ret=NULL;
+  unsigned int len=0;
+  switch (d) {
+    case DIV_SAMPLE_DEPTH_1BIT:
+      ret=data1;
+      len=length1;
+      break;
+    case DIV_SAMPLE_DEPTH_1BIT_DPCM:
+      ret=dataDPCM;
+      len=lengthDPCM;
+      break;
+    case DIV_SAMPLE_DEPTH_YMZ_ADPCM:
+      ret=dataZ;
+      len=(lengthZ+3)&(~0x03);
+      break;
+    case DIV_SAMPLE_DEPTH_QSOUND_ADPCM:
+      ret=dataQSoundA;
+      len=lengthQSoundA;
+      break;
+    case DIV_SAMPLE_DEPTH_ADPCM_A:
+      ret=dataA;
+      len=(lengthA+255)&(~0xff);
+      break;
+    case DIV_SAMPLE_DEPTH_ADPCM_B:
+      ret=dataB;
+      len=(lengthB+255)&(~0xff);
+      break;
+    case DIV_SAMPLE_DEPTH_ADPCM_K:
+      ret=dataK;
+      len=(lengthK+255)&(~0xff);
+      break;
+    case DIV_SAMPLE_DEPTH_8BIT:
+      ret=data8;
+      len=(length8+4095)&(~0xfff);
+      break;
+    case DIV_SAMPLE_DEPTH_BRR:
+      ret=dataBRR;
+      len=lengthBRR+9;
+      break;
+    case DIV_SAMPLE_DEPTH_VOX:
+      ret=dataVOX;
+      len=lengthVOX;
+      break;
+    case DIV_SAMPLE_DEPTH_MULAW:
+      ret=dataMuLaw;
+      len=(lengthMuLaw+4095)&(~0xfff);
+      break;
+    case DIV_SAMPLE_DEPTH_C219:
+      ret=dataC219;
+      len=(lengthC219+4095)&(~0xfff);
+      break;
+    case DIV_SAMPLE_DEPTH_IMA_ADPCM:
+      ret=dataIMA;
+      len=lengthIMA;
+      break;
+    case DIV_SAMPLE_DEPTH_16BIT:
+      ret=data16;
+      len=((length16/2+511)&(~0x1ff))*sizeof(short);
+      break;
+    default:
+      break;
+  }
+  if (allocLen!=NULL) *allocLen=(ret==NULL)?0:len;
+  return ret;
+}
+
+void DivSample::invalidateMipmap(unsigned int begin, unsigned int end) {
+  if (begin>=end) return;
+  if (mipmapDirtyStart>=mipmapDirtyEnd) {
+    mipmapDirtyStart=begin;
+    mipmapDirtyEnd=end;
+  } else {
+    if (begin<mipmapDirtyStart) mipmapDirtyStart=begin;
+    if (end>mipmapDirtyEnd) mipmapDirtyEnd=end;
+  }
+}
+
+void DivSample::updateMipmap() {
+  bool is8Bit=(depth==DIV_SAMPLE_DEPTH_8BIT);
+  if (samples==0 || (is8Bit?(data8==NULL):(data16==NULL))) {
+    mipmap.clear();
+    mipmapSamples=0;
+    invalidateMipmap();
+    return;
+  }
+  if (is8Bit!=mipmap8Bit || mipmap.empty()) {
+    invalidateMipmap();
+  }
+  if (mipmapSamples!=samples) {
+    // the last block before the size change has to be updated as well
+    unsigned int from=MIN(mipmapSamples,samples);
+    if (from>0) from--;
+    invalidateMipmap(from,samples);
+  }
+  if (mipmapDirtyEnd>samples) mipmapDirtyEnd=samples;
+  if (mipmapDirtyStart>=mipmapDirtyEnd) return;
+
+  // resize levels
+  unsigned int count=(samples+DIV_SAMPLE_MIPMAP_BLOCK-1)>>DIV_SAMPLE_MIPMAP_SHIFT;
+  size_t levels=1;
+  for (unsigned int i=count; i>1; i=(i+1)>>1) levels++;
+  mipmap.resize(levels);
+  for (size_t i=0; i<levels; i++) {
+    mipmap[i].resize(count*2);
+    count=(count+1)>>1;
+  }
+
+  // level 0
+  unsigned int first=mipmapDirtyStart>>DIV_SAMPLE_MIPMAP_SHIFT;
+  unsigned int last=(mipmapDirtyEnd-1)>>DIV_SAMPLE_MIPMAP_SHIFT;
+  short* out=mipmap[0].data();
+  for (unsigned int i=first; i<=last; i++) {
+    unsigned int pos=i<<DIV_SAMPLE_MIPMAP_SHIFT;
+    unsigned int end=MIN(pos+DIV_SAMPLE_MIPMAP_BLOCK,samples);
+    short lo, hi;
+    if (is8Bit) {
+      lo=hi=data8[pos];
+      for (unsigned int j=pos+1; j<end; j++) {
+        if (data8[j]<lo) lo=data8[j];
+        if (data8[j]>hi) hi=data8[j];
+      }
+    } else {
+      lo=hi=data16[pos];
+      for (unsigned int j=pos+1; j<end; j++) {
+        if (data16[j]<lo) lo=data16[j];
+        if (data16[j]>hi) hi=data16[j];
+      }
+    }
+    out[i<<1]=lo;
+    out[(i<<1)+1]=hi;
+  }
+
+  // other levels
+  for (size_t l=1; l<levels; l++) {
+    first>>=1;
+    last>>=1;
+    const short* in=mipmap[l-1].data();
+    unsigned int inCount=mipmap[l-1].size()>>1;
+    out=mipmap[l].data();
+    for (unsigned int i=first; i<=last; i++) {
+      short lo=in[i<<2];
+      short hi=in[(i<<2)+1];
+      if ((i<<1)+1<inCount) {
+        if (in[(i<<2)+2]<lo) lo=in[(i<<2)+2];
+        if (in[(i<<2)+3]>hi) hi=in[(i<<2)+3];
+      }
+      out[i<<1]=lo;
+      out[(i<<1)+1]=hi;
+    }
+  }
+
+  mipmapSamples=samples;
+  mipmap8Bit=is8Bit;
+  mipmapDirtyStart=0;
+  mipmapDirtyEnd=0;
+}
+
+bool DivSample::getMinMax(unsigned int begin, unsigned int end, int& minVal, int& maxVal) {
+  updateMipmap();
+  if (end>mipmapSamples) end=mipmapSamples;
+  if (begin>=end) return false;
+
+  int lo=INT_MAX;
+  int hi=INT_MIN;
+#define MIPMAP_TAKE(l,h) \
+  if ((l)<lo) lo=(l); \
+  if ((h)>hi) hi=(h);
+#define MIPMAP_TAKE_SAMPLE(x) \
+  if (mipmap8Bit) { \
+    MIPMAP_TAKE(data8[x],data8[x]); \
+  } else { \
+    MIPMAP_TAKE(data16[x],data16[x]); \
+  }
+
+  // read samples outside of whole blocks directly
+  while (begin<end && (begin&(DIV_SAMPLE_MIPMAP_BLOCK-1))) {
+    MIPMAP_TAKE_SAMPLE(begin);
+    begin++;
+  }
+  while (end>begin && (end&(DIV_SAMPLE_MIPMAP_BLOCK-1))) {
+    end--;
+    MIPMAP_TAKE_SAMPLE(end);
+  }
+
+  // then go up the levels, taking the blocks which only partially belong to the next level
+  unsigned int first=begin>>DIV_SAMPLE_MIPMAP_SHIFT;
+  unsigned int endBlock=end>>DIV_SAMPLE_MIPMAP_SHIFT;
+  for (size_t l=0; first<endBlock && l<mipmap.size(); l++) {
+    const short* m=mipmap[l].data();
+    if (first&1) {
+      MIPMAP_TAKE(m[first<<1],m[(first<<1)+1]);
+      first++;
+    }
+    if (endBlock&1) {
+      endBlock--;
+      MIPMAP_TAKE(m[endBlock<<1],m[(endBlock<<1)+1]);
+    }
+    first>>=1;
+    endBlock>>=1;
+  }
+#undef MIPMAP_TAKE_SAMPLE
+#undef MIPMAP_TAKE
+
+  minVal=lo;
+  maxVal=hi;
+  return true;
+}
+
 DivSampleHistory* DivSample::prepareUndo(bool data, bool doNotPush) {
   DivSampleHistory* h;
   if (data) {
@@ -1601,7 +1863,8 @@ DivSampleHistory* DivSample::prepareUndo(bool data, bool doNotPush) {
   loop=h->loop; \
   brrEmphasis=h->brrEmphasis; \
   dither=h->dither; \
-  loopMode=h->loopMode;
+  loopMode=h->loopMode; \
+  invalidateMipmap();
 
 
 int DivSample::undo() {
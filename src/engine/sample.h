@@ -25,6 +25,12 @@
 #include "safeWriter.h"
 #include "dataErrors.h"
 #include "../fixedQueue.h"
+#include <limits.h>
+#include <vector>
+
+// the first level of the sample mipmap has one entry every (1<<DIV_SAMPLE_MIPMAP_SHIFT) samples
+#define DIV_SAMPLE_MIPMAP_SHIFT 4
+#define DIV_SAMPLE_MIPMAP_BLOCK (1<<DIV_SAMPLE_MIPMAP_SHIFT)
 
 enum DivSampleLoopMode: unsigned char {
   DIV_SAMPLE_LOOP_FORWARD=0,
@@ -147,6 +153,17 @@ struct DivSample {
 
   unsigned int samples;
 
+  // render hash of the last render() call, or 0 if the sample hasn't been rendered.
+  unsigned long long renderHash;
+
+  // minimum/maximum summary of the sample data (data8 if 8-bit, data16 otherwise) for drawing.
+  // each level is made of (min,max) pairs. level 0 has one pair every DIV_SAMPLE_MIPMAP_BLOCK
+  // samples, level 1 every DIV_SAMPLE_MIPMAP_BLOCK*2 samples and so on.
+  // it is updated lazily by getMinMax(). the dirty range is the part which has to be updated.
+  std::vector<std::vector<short>> mipmap;
+  unsigned int mipmapSamples, mipmapDirtyStart, mipmapDirtyEnd;
+  bool mipmap8Bit;
+
   FixedQueue<DivSampleHistory*,128> undoHist;
   FixedQueue<DivSampleHistory*,128> redoHist;
 
@@ -295,6 +312,47 @@ struct DivSample {
    */
   void render(unsigned int formatMask=0xffffffff);
 
+  /**
+   * calculate a hash of everything render() depends on: the sample data,
+   * the depth, encoder options and the format mask.
+   * if it matches renderHash, the sample doesn't have to be rendered again.
+   * @param formatMask the format mask.
+   * @return the hash (never 0).
+   */
+  unsigned long long getRenderHash(unsigned int formatMask=0xffffffff);
+
+  /**
+   * mark part of the sample data as changed, so that the mipmap is updated on next use.
+   * call this after writing to the sample data directly.
+   * @param begin the first changed sample.
+   * @param end the end of the changed range (exclusive).
+   */
+  void invalidateMipmap(unsigned int begin=0, unsigned int end=UINT_MAX);
+
+  /**
+   * get the minimum and maximum value of part of the sample data (data8 if
+   * 8-bit, data16 otherwise), using the mipmap.
+   * @param begin the first sample.
+   * @param end the end of the range (exclusive).
+   * @param minVal where to store the minimum.
+   * @param maxVal where to store the maximum.
+   * @return false if the range is empty.
+   */
+  bool getMinMax(unsigned int begin, unsigned int end, int& minVal, int& maxVal);
+
+  /**
+   * bring the mipmap up to date.
+   */
+  void updateMipmap();
+
+  /**
+   * get the sample data for a depth.
+   * @param d the depth.
+   * @param allocLen if not NULL, the allocated size of the data (including padding) will be stored here.
+   * @return the sample data, or NULL if not created.
+   */
+  void* getBuf(DivSampleDepth d, unsigned int* allocLen=NULL);
+
   /**
    * get the sample data for the current depth.
    * @return the sample data, or NULL if not created.
@@ -367,7 +425,12 @@ struct DivSample {
     lengthMuLaw(0),
     lengthC219(0),
     lengthIMA(0),
-    samples(0) {
+    samples(0),
+    renderHash(0),
+    mipmapSamples(0),
+    mipmapDirtyStart(0),
+    mipmapDirtyEnd(UINT_MAX),
+    mipmap8Bit(false) {
     for (int i=0; i<DIV_MAX_CHIPS; i++) {
       for (int j=0; j<DIV_MAX_SAMPLE_TYPE; j++) {
         renderOn[j][i]=true;
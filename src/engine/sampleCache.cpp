@@ -0,0 +1,111 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "sampleCache.h"
+#include "../ta-log.h"
+#include <string.h>
+
+DivSampleCacheEntry::~DivSampleCacheEntry() {
+  for (int i=0; i<DIV_SAMPLE_DEPTH_MAX; i++) {
+    if (data[i]!=NULL) delete[] data[i];
+  }
+}
+
+bool DivSampleCache::fetch(DivSample* s, unsigned long long hash) {
+  auto i=index.find(hash);
+  if (i==index.end()) return false;
+  DivSampleCacheEntry* entry=*(i->second);
+
+  for (int j=0; j<DIV_SAMPLE_DEPTH_MAX; j++) {
+    if (entry->data[j]==NULL) continue;
+    DivSampleDepth d=(DivSampleDepth)j;
+    // same sample count as in DivSample::render()
+    int count=(d==DIV_SAMPLE_DEPTH_BRR && s->loop)?s->loopEnd:s->samples;
+    unsigned int allocLen=0;
+    if (!s->initInternal(d,count)) return false;
+    void* buf=s->getBuf(d,&allocLen);
+    if (buf==NULL || allocLen!=entry->allocLen[j]) {
+      logW("sample cache: size mismatch in format %d!",j);
+      return false;
+    }
+    memcpy(buf,entry->data[j],allocLen);
+  }
+
+  // move to front
+  entries.splice(entries.begin(),entries,i->second);
+  return true;
+}
+
+void DivSampleCache::store(DivSample* s, unsigned long long hash, unsigned int formatMask) {
+  if (maxSize==0) return;
+  if (index.find(hash)!=index.end()) return;
+
+  DivSampleCacheEntry* entry=new DivSampleCacheEntry(hash);
+  for (int j=0; j<DIV_SAMPLE_DEPTH_MAX; j++) {
+    // the current depth is the source, and therefore not part of the rendered data
+    if (j==s->depth) continue;
+    if (j!=DIV_SAMPLE_DEPTH_16BIT && !(formatMask&(1U<<j))) continue;
+    unsigned int allocLen=0;
+    void* buf=s->getBuf((DivSampleDepth)j,&allocLen);
+    if (buf==NULL) continue;
+    entry->data[j]=new unsigned char[allocLen];
+    entry->allocLen[j]=allocLen;
+    memcpy(entry->data[j],buf,allocLen);
+    entry->size+=allocLen;
+  }
+
+  // don't bother with entries that would evict everything else
+  if (entry->size>maxSize/2) {
+    delete entry;
+    return;
+  }
+
+  entries.push_front(entry);
+  index[hash]=entries.begin();
+  curSize+=entry->size;
+  evict();
+}
+
+void DivSampleCache::evict() {
+  while (curSize>maxSize && !entries.empty()) {
+    DivSampleCacheEntry* entry=entries.back();
+    index.erase(entry->hash);
+    curSize-=entry->size;
+    delete entry;
+    entries.pop_back();
+  }
+}
+
+void DivSampleCache::setMaxSize(size_t size) {
+  maxSize=size;
+  evict();
+}
+
+void DivSampleCache::clear() {
+  for (DivSampleCacheEntry* i: entries) {
+    delete i;
+  }
+  entries.clear();
+  index.clear();
+  curSize=0;
+}
+
+DivSampleCache::~DivSampleCache() {
+  clear();
+}
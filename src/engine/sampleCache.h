@@ -0,0 +1,94 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _SAMPLECACHE_H
+#define _SAMPLECACHE_H
+
+#include <list>
+#include <unordered_map>
+#include "sample.h"
+
+// default size limit of the sample render cache (in bytes)
+#define DIV_SAMPLE_CACHE_DEFAULT_SIZE (64*1024*1024)
+
+struct DivSampleCacheEntry {
+  unsigned long long hash;
+  // rendered buffers (including padding), or NULL if that format wasn't rendered
+  unsigned char* data[DIV_SAMPLE_DEPTH_MAX];
+  unsigned int allocLen[DIV_SAMPLE_DEPTH_MAX];
+  size_t size;
+
+  DivSampleCacheEntry(unsigned long long h):
+    hash(h),
+    size(0) {
+    for (int i=0; i<DIV_SAMPLE_DEPTH_MAX; i++) {
+      data[i]=NULL;
+      allocLen[i]=0;
+    }
+  }
+  ~DivSampleCacheEntry();
+};
+
+/**
+ * a cache of rendered (encoded) sample data, keyed by DivSample::getRenderHash().
+ * this allows skipping the encoders when a sample goes back to a previous state,
+ * or when the same song is loaded again.
+ * least recently used entries are evicted once the size limit is exceeded.
+ * this class is not thread-safe.
+ */
+class DivSampleCache {
+  std::list<DivSampleCacheEntry*> entries;
+  std::unordered_map<unsigned long long,std::list<DivSampleCacheEntry*>::iterator> index;
+  size_t curSize, maxSize;
+
+  void evict();
+  public:
+    /**
+     * copy rendered data from the cache into a sample, if present.
+     * @param s the sample.
+     * @param hash the render hash of the sample.
+     * @return whether the sample was found in the cache.
+     */
+    bool fetch(DivSample* s, unsigned long long hash);
+
+    /**
+     * store the rendered data of a sample in the cache.
+     * @param s the sample, which has been rendered already.
+     * @param hash the render hash of the sample.
+     * @param formatMask the format mask which was used for rendering.
+     */
+    void store(DivSample* s, unsigned long long hash, unsigned int formatMask);
+
+    /**
+     * set the size limit of the cache. 0 disables the cache.
+     */
+    void setMaxSize(size_t size);
+
+    /**
+     * empty the cache.
+     */
+    void clear();
+
+    DivSampleCache():
+      curSize(0),
+      maxSize(DIV_SAMPLE_CACHE_DEFAULT_SIZE) {}
+    ~DivSampleCache();
+};
+
+#endif
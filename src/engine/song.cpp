@@ -114,7 +114,7 @@ void DivSubSong::makePatUnique() {
           if (!used[k]) {
             // copy here
             DivPattern* dest=pat[i].getPattern(k,true);
-            DivPattern* src=pat[i].getPattern(orders.ord[i][j],false);
+            const DivPattern* src=pat[i].getPattern(orders.ord[i][j],false);
             src->copyOn(dest);
             used[k]=true;
             orders.ord[i][j]=k;
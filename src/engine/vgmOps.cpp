@@ -1104,6 +1104,239 @@ void DivEngine::performVGMWrite(SafeWriter* w, DivSystem sys, DivRegWrite& write
   chipVol.push_back((_id)|(0x80000000)|(((unsigned int)_vol)<<16)); \
 }
 
+// whether writing the value which a register already holds does nothing.
+// registers with side effects on write (key on, triggers, data ports, envelope restart...) are left out.
+static bool isVGMWritePure(unsigned char cmd, unsigned char reg) {
+  switch (cmd) {
+    case 0x52: case 0xa2: // YM2612
+    case 0x53: case 0xa3:
+    case 0x57: case 0xa7: // YM2608 (port 1)
+    case 0x59: case 0xa9: // YM2610 (port 1)
+      if (cmd==0x52 || cmd==0xa2) {
+        if (reg==0x22 || reg==0x2b) return true;
+      }
+      return (reg>=0x30 && reg<0xa0) || (reg>=0xb0 && reg<=0xb6);
+    case 0x55: case 0xa5: // YM2203
+    case 0x56: case 0xa6: // YM2608 (port 0)
+    case 0x58: case 0xa8: // YM2610 (port 0)
+      // SSG (without envelope shape), LFO and FM
+      return reg<0x0d || reg==0x22 || (reg>=0x30 && reg<0xa0) || (reg>=0xb0 && reg<=0xb6);
+    case 0x54: case 0xa4: // YM2151
+      return reg==0x0f || reg==0x18 || reg==0x19 || reg==0x1b || reg>=0x20;
+    case 0x51: case 0xa1: // YM2413
+      return reg<0x08 || reg==0x0e || (reg>=0x10 && reg<0x39);
+    case 0x5a: case 0xaa: // YM3812
+    case 0x5b: case 0xab: // YM3526
+    case 0x5c: case 0xac: // Y8950
+    case 0x5e: case 0xae: // YMF262
+    case 0x5f: case 0xaf:
+      return reg>=0x20;
+    case 0xa0: // AY-3-8910
+      return (reg&0x7f)<0x0d;
+    case 0xb3: // Game Boy
+      switch (reg&0x7f) {
+        case 0x03: case 0x08: case 0x0d: case 0x12: // frequency low/noise
+        case 0x14: case 0x15: // volume/panning
+          return true;
+      }
+      return false;
+    case 0xb4: // NES APU
+      switch (reg&0x7f) {
+        case 0x00: case 0x02: case 0x04: case 0x06:
+        case 0x08: case 0x0a: case 0x0c: case 0x0e:
+        case 0x10: case 0x12: case 0x13:
+          return true;
+      }
+      return false;
+  }
+  return false;
+}
+
+static int getVGMCommandLen(const unsigned char* data, size_t pos, size_t len) {
+  unsigned char cmd=data[pos];
+  if (cmd>=0x30 && cmd<=0x3f) return 2;
+  if (cmd>=0x40 && cmd<=0x4e) return 3;
+  if (cmd>=0x51 && cmd<=0x5f) return 3;
+  if (cmd>=0x70 && cmd<=0x8f) return 1;
+  if (cmd>=0xa0 && cmd<=0xbf) return 3;
+  if (cmd>=0xc0 && cmd<=0xdf) return 4;
+  if (cmd>=0xe0) return 5;
+  switch (cmd) {
+    case 0x4f: case 0x50:
+      return 2;
+    case 0x61:
+      return 3;
+    case 0x62: case 0x63: case 0x66:
+      return 1;
+    case 0x64:
+      return 4;
+    case 0x67:
+      if (pos+7>len) return 0;
+      return 7+((data[pos+3]|(data[pos+4]<<8)|(data[pos+5]<<16)|(data[pos+6]<<24))&0x7fffffff);
+    case 0x68:
+      return 12;
+    case 0x90: case 0x91: case 0x95:
+      return 5;
+    case 0x92:
+      return 6;
+    case 0x93:
+      return 11;
+    case 0x94:
+      return 2;
+  }
+  return 0;
+}
+
+static void writeVGMWait(SafeWriter* w, int wait) {
+  while (wait>0) {
+    // use the 1-byte forms when they take up to 2 bytes in total
+    if (wait==735 || wait==1470 || wait==1617 || (wait>735 && wait<=751)) {
+      w->writeC(0x62);
+      wait-=735;
+    } else if (wait==882 || wait==1764 || (wait>882 && wait<=898)) {
+      w->writeC(0x63);
+      wait-=882;
+    } else if (wait<=16) {
+      w->writeC(0x70+wait-1);
+      wait=0;
+    } else {
+      int part=MIN(wait,65535);
+      w->writeC(0x61);
+      w->writeS(part);
+      wait-=part;
+    }
+  }
+}
+
+// write a PCM data block using n-bit compression if the values fit in less than 8 bits.
+static void writeVGMDataBlock(SafeWriter* w, unsigned char type, const unsigned char* data, unsigned int len) {
+  unsigned char minVal=255;
+  unsigned char maxVal=0;
+  for (unsigned int i=0; i<len; i++) {
+    if (data[i]<minVal) minVal=data[i];
+    if (data[i]>maxVal) maxVal=data[i];
+  }
+  int bits=1;
+  while (bits<8 && (maxVal-minVal)>=(1<<bits)) bits++;
+  if (len==0 || bits>=8) {
+    w->writeC(0x67);
+    w->writeC(0x66);
+    w->writeC(type);
+    w->writeI(len);
+    w->write(data,len);
+    return;
+  }
+
+  w->writeC(0x67);
+  w->writeC(0x66);
+  w->writeC(0x40+type);
+  w->writeI(10+(len*bits+7)/8);
+  w->writeC(0); // n-bit compression
+  w->writeI(len);
+  w->writeC(8); // bits decompressed
+  w->writeC(bits); // bits compressed
+  w->writeC(0); // copy
+  w->writeS(minVal); // value to add
+  // values are packed MSB first
+  unsigned int acc=0;
+  int accBits=0;
+  for (unsigned int i=0; i<len; i++) {
+    acc=(acc<<bits)|(data[i]-minVal);
+    accBits+=bits;
+    if (accBits>=8) {
+      accBits-=8;
+      w->writeC((acc>>accBits)&0xff);
+    }
+  }
+  if (accBits>0) w->writeC((acc<<(8-accBits))&0xff);
+}
+
+// copy VGM command data, leaving out register writes which don't change anything and merging waits.
+// PCM data blocks are compressed if compress is true.
+// nothing is carried across loopPos (an offset into data), so that the loop plays back correctly.
+// returns the new offset of the loop (relative to the start of w), or -1.
+static int optimizeVGMData(SafeWriter* w, const unsigned char* data, size_t len, int loopPos, bool compress, size_t& dropped) {
+  std::vector<short> shadow(65536,-1);
+  int newLoopPos=-1;
+  int wait=0;
+  size_t pos=0;
+
+  dropped=0;
+  while (pos<len) {
+    if ((int)pos==loopPos) {
+      writeVGMWait(w,wait);
+      wait=0;
+      newLoopPos=w->tell();
+      for (short& i: shadow) i=-1;
+    }
+
+    unsigned char cmd=data[pos];
+    int cmdLen=getVGMCommandLen(data,pos,len);
+    if (cmdLen<=0 || pos+cmdLen>len) {
+      // unknown command. copy the rest as is
+      logW("VGM optimization: unknown command %.2x at %x",cmd,(int)pos);
+      writeVGMWait(w,wait);
+      wait=0;
+      if (loopPos>=(int)pos) newLoopPos=w->tell()+(loopPos-pos);
+      w->write(&data[pos],len-pos);
+      break;
+    }
+
+    // waits
+    if (cmd==0x61) {
+      wait+=data[pos+1]|(data[pos+2]<<8);
+      pos+=cmdLen;
+      continue;
+    } else if (cmd==0x62) {
+      wait+=735;
+      pos+=cmdLen;
+      continue;
+    } else if (cmd==0x63) {
+      wait+=882;
+      pos+=cmdLen;
+      continue;
+    } else if (cmd>=0x70 && cmd<=0x7f) {
+      wait+=(cmd&15)+1;
+      pos+=cmdLen;
+      continue;
+    }
+
+    // register writes
+    if ((cmd>=0x51 && cmd<=0x5f) || (cmd>=0xa0 && cmd<=0xbf)) {
+      unsigned char reg=data[pos+1];
+      unsigned char val=data[pos+2];
+      short& prev=shadow[(cmd<<8)|reg];
+      if (isVGMWritePure(cmd,reg)) {
+        if (prev==val) {
+          dropped++;
+          pos+=cmdLen;
+          continue;
+        }
+        prev=val;
+      }
+      if (cmd==0xa0 && (reg&0x7f)==0x0d) {
+        // AY8930 bank switch
+        for (int i=0; i<16; i++) {
+          shadow[(cmd<<8)|(reg&0x80)|i]=-1;
+        }
+      }
+    }
+
+    writeVGMWait(w,wait);
+    wait=0;
+
+    if (cmd==0x67 && compress && data[pos+2]<0x40) {
+      writeVGMDataBlock(w,data[pos+2],&data[pos+7],cmdLen-7);
+    } else {
+      w->write(&data[pos],cmdLen);
+    }
+    pos+=cmdLen;
+  }
+  writeVGMWait(w,wait);
+
+  return newLoopPos;
+}
+
 #define CHIP_VOL_SECOND(_id,_mult) { \
   double _vol=fabs((float)song.systemVol[i])*256.0*_mult; \
   if (_vol<0.0) _vol=0.0; \
@@ -2639,6 +2872,29 @@ SafeWriter* DivEngine::saveVGM(bool* sysToExport, bool loop, int version, bool p
   // end of song
   w->writeC(0x66);
 
+  // optimize command data
+  int loopDataPos=-1;
+  if (loop && loopPos!=-1 && loopTickSong>=0 && loopTickSong<(int)tickPos.size()) {
+    loopDataPos=tickPos[loopTickSong]-songOff;
+  }
+  SafeWriter* optW=new SafeWriter;
+  optW->init();
+  optW->write(w->getFinalBuf(),songOff);
+  size_t droppedWrites=0;
+  int newLoopPos=optimizeVGMData(optW,w->getFinalBuf()+songOff,w->size()-songOff,loopDataPos,version>=0x160,droppedWrites);
+  logI("VGM optimization: %d -> %d bytes, %d redundant writes removed",(int)w->size(),(int)optW->size(),(int)droppedWrites);
+  w->finish();
+  delete w;
+  w=optW;
+  if (loopDataPos>=0) {
+    if (newLoopPos<0) {
+      logW("loop point lost during VGM optimization!");
+      loopPos=-1;
+    } else {
+      tickPos[loopTickSong]=newLoopPos;
+    }
+  }
+
   got.rate=origRate;
 
   for (int i=0; i<song.systemLen; i++) {
@@ -34,6 +34,173 @@ bool DivEngine::isExporting() {
 }
 
 #ifdef HAVE_SNDFILE
+struct DivStemExport {
+  unsigned char* songData;
+  size_t songLen;
+  std::vector<int> stems;
+  std::atomic<size_t> nextStem;
+  std::atomic<size_t> frames;
+  // some cores initialize shared tables, so workers are set up one at a time
+  std::mutex initLock;
+};
+
+void _runStemWorker(DivEngine* caller, DivStemExport* job) {
+  caller->runStemWorker(job);
+}
+
+bool DivEngine::initStemWorker(DivEngine* parent, unsigned char* songData, size_t songLen) {
+  preInitWorker(parent);
+
+  unsigned char* file=new unsigned char[songLen];
+  memcpy(file,songData,songLen);
+  if (!load(file,songLen)) {
+    logE("stem worker: could not load song! (%s)",lastError);
+    return false;
+  }
+  changeSong(parent->curSubSongIndex);
+
+  // dummy audio and no MIDI (see preInitWorker())
+  init();
+  deinitAudioBackend();
+
+  // match the render state of the parent
+  got.rate=parent->got.rate;
+  quitDispatch();
+  initDispatch(true);
+  renderSamples();
+
+  metronome=parent->metronome;
+  repeatPattern=false;
+  exportPath=parent->exportPath;
+  exportFormat=parent->exportFormat;
+  exportFadeOut=parent->exportFadeOut;
+  exportOutputs=parent->exportOutputs;
+  exportLoopCount=parent->exportLoopCount;
+  return true;
+}
+
+void DivEngine::runStemWorker(DivStemExport* job) {
+  DivEngine* worker=new DivEngine;
+  job->initLock.lock();
+  bool workerOK=worker->initStemWorker(this,job->songData,job->songLen);
+  job->initLock.unlock();
+  if (workerOK) {
+    float* outBuf[DIV_MAX_OUTPUTS];
+    float* outBufFinal;
+    for (int i=0; i<exportOutputs; i++) {
+      outBuf[i]=new float[EXPORT_BUFSIZE];
+    }
+    outBufFinal=new float[EXPORT_BUFSIZE*exportOutputs];
+
+    while (!stopExport) {
+      size_t index=job->nextStem++;
+      if (index>=job->stems.size()) break;
+      if (!worker->exportChanStem(job->stems[index],outBuf,outBufFinal,&stopExport)) break;
+    }
+
+    delete[] outBufFinal;
+    for (int i=0; i<exportOutputs; i++) {
+      delete[] outBuf[i];
+    }
+  }
+  job->frames+=worker->exportFrames;
+  job->initLock.lock();
+  worker->quit(false);
+  job->initLock.unlock();
+  delete worker;
+}
+
+bool DivEngine::exportChanStem(int ch, float** outBuf, float* outBufFinal, std::atomic<bool>* abort) {
+  size_t fadeOutSamples=got.rate*exportFadeOut;
+  size_t curFadeOutSample=0;
+  bool isFadingOut=false;
+
+  SNDFILE* sf;
+  SF_INFO si;
+  SFWrapper sfWrap;
+  String fname=fmt::sprintf("%s_c%02d.wav",exportPath,ch+1);
+  logI("- %s",fname.c_str());
+  si.samplerate=got.rate;
+  si.channels=exportOutputs;
+  if (exportFormat==DIV_EXPORT_FORMAT_S16) {
+    si.format=SF_FORMAT_WAV|SF_FORMAT_PCM_16;
+  } else {
+    si.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
+  }
+
+  sf=sfWrap.doOpen(fname.c_str(),SFM_WRITE,&si);
+  if (sf==NULL) {
+    logE("could not open file for writing! (%s)",sf_strerror(NULL));
+    return false;
+  }
+
+  for (int j=0; j<chans; j++) {
+    bool mute=(j!=ch);
+    isMuted[j]=mute;
+  }
+  if (getChannelType(ch)==5) {
+    for (int j=ch; j<chans; j++) {
+      if (getChannelType(j)!=5) break;
+      isMuted[j]=false;
+    }
+  }
+  for (int j=0; j<chans; j++) {
+    if (disCont[dispatchOfChan[j]].dispatch!=NULL) {
+      disCont[dispatchOfChan[j]].dispatch->muteChannel(dispatchChanOfChan[j],isMuted[j]);
+    }
+  }
+
+  curOrder=0;
+  prevOrder=0;
+  lastLoopPos=-1;
+  totalLoops=0;
+  remainingLoops=-1;
+  playSub(false);
+
+  while (playing) {
+    if (*abort) break;
+    size_t total=0;
+    nextBuf(NULL,outBuf,0,exportOutputs,EXPORT_BUFSIZE);
+    if (totalProcessed>EXPORT_BUFSIZE) {
+      logE("error: total processed is bigger than export bufsize! %d>%d",totalProcessed,EXPORT_BUFSIZE);
+      totalProcessed=EXPORT_BUFSIZE;
+    }
+    int fi=0;
+    for (int j=0; j<(int)totalProcessed; j++) {
+      total++;
+      if (isFadingOut) {
+        double mul=(1.0-((double)curFadeOutSample/(double)fadeOutSamples));
+        for (int k=0; k<exportOutputs; k++) {
+          outBufFinal[fi++]=MAX(-1.0f,MIN(1.0f,outBuf[k][j]))*mul;
+        }
+        if (++curFadeOutSample>=fadeOutSamples) {
+          playing=false;
+          break;
+        }
+      } else {
+        for (int k=0; k<exportOutputs; k++) {
+          outBufFinal[fi++]=MAX(-1.0f,MIN(1.0f,outBuf[k][j]));
+        }
+        if (lastLoopPos>-1 && j>=lastLoopPos && totalLoops>=exportLoopCount) {
+          logD("start fading out...");
+          isFadingOut=true;
+          if (fadeOutSamples==0) break;
+        }
+      }
+    }
+    if (sf_writef_float(sf,outBufFinal,total)!=(int)total) {
+      logE("error: failed to write entire buffer!");
+      break;
+    }
+    exportFrames+=total;
+  }
+
+  if (sfWrap.doClose()!=0) {
+    logE("could not close audio file!");
+  }
+  return true;
+}
+
 void DivEngine::runExportThread() {
   size_t fadeOutSamples=got.rate*exportFadeOut;
   size_t curFadeOutSample=0;
@@ -107,6 +274,7 @@ void DivEngine::runExportThread() {
           logE("error: failed to write entire buffer!");
           break;
         }
+        exportFrames+=total;
       }
 
       delete[] outBufFinal;
@@ -121,7 +289,7 @@ void DivEngine::runExportThread() {
       if (initAudioBackend()) {
         for (int i=0; i<song.systemLen; i++) {
           disCont[i].setRates(got.rate);
-          disCont[i].setQuality(lowQuality,dcHiPass);
+          disCont[i].setQuality(lowQuality,dcHiPass,simdBlip);
         }
         if (!output->setRun(true)) {
           logE("error while activating audio!");
@@ -218,6 +386,7 @@ void DivEngine::runExportThread() {
             break;
           }
         }
+        exportFrames+=total;
       }
 
       delete[] outBuf[0];
@@ -233,7 +402,7 @@ void DivEngine::runExportThread() {
       if (initAudioBackend()) {
         for (int i=0; i<song.systemLen; i++) {
           disCont[i].setRates(got.rate);
-          disCont[i].setQuality(lowQuality,dcHiPass);
+          disCont[i].setQuality(lowQuality,dcHiPass,simdBlip);
         }
         if (!output->setRun(true)) {
           logE("error while activating audio!");
@@ -247,101 +416,11 @@ void DivEngine::runExportThread() {
       // take control of audio output
       deinitAudioBackend();
 
-      float* outBuf[DIV_MAX_OUTPUTS];
-      float* outBufFinal;
-      for (int i=0; i<exportOutputs; i++) {
-        outBuf[i]=new float[EXPORT_BUFSIZE];
-      }
-      outBufFinal=new float[EXPORT_BUFSIZE*exportOutputs];
-
-      logI("rendering to files...");
-      
+      // channels grouped with the one before them (type 5) go in the same file
+      std::vector<int> stems;
       for (int i=0; i<chans; i++) {
         if (!exportChannelMask[i]) continue;
-        SNDFILE* sf;
-        SF_INFO si;
-        SFWrapper sfWrap;
-        String fname=fmt::sprintf("%s_c%02d.wav",exportPath,i+1);
-        logI("- %s",fname.c_str());
-        si.samplerate=got.rate;
-        si.channels=exportOutputs;
-        if (exportFormat==DIV_EXPORT_FORMAT_S16) {
-          si.format=SF_FORMAT_WAV|SF_FORMAT_PCM_16;
-        } else {
-          si.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
-        }
-
-        sf=sfWrap.doOpen(fname.c_str(),SFM_WRITE,&si);
-        if (sf==NULL) {
-          logE("could not open file for writing! (%s)",sf_strerror(NULL));
-          break;
-        }
-
-        for (int j=0; j<chans; j++) {
-          bool mute=(j!=i);
-          isMuted[j]=mute;
-        }
-        if (getChannelType(i)==5) {
-          for (int j=i; j<chans; j++) {
-            if (getChannelType(j)!=5) break;
-            isMuted[j]=false;
-          }
-        }
-        for (int j=0; j<chans; j++) {
-          if (disCont[dispatchOfChan[j]].dispatch!=NULL) {
-            disCont[dispatchOfChan[j]].dispatch->muteChannel(dispatchChanOfChan[j],isMuted[j]);
-          }
-        }
-        
-        curOrder=0;
-        prevOrder=0;
-        curFadeOutSample=0;
-        lastLoopPos=-1;
-        totalLoops=0;
-        isFadingOut=false;
-        remainingLoops=-1;
-        playSub(false);
-
-        while (playing) {
-          size_t total=0;
-          nextBuf(NULL,outBuf,0,exportOutputs,EXPORT_BUFSIZE);
-          if (totalProcessed>EXPORT_BUFSIZE) {
-            logE("error: total processed is bigger than export bufsize! %d>%d",totalProcessed,EXPORT_BUFSIZE);
-            totalProcessed=EXPORT_BUFSIZE;
-          }
-          int fi=0;
-          for (int j=0; j<(int)totalProcessed; j++) {
-            total++;
-            if (isFadingOut) {
-              double mul=(1.0-((double)curFadeOutSample/(double)fadeOutSamples));
-              for (int k=0; k<exportOutputs; k++) {
-                outBufFinal[fi++]=MAX(-1.0f,MIN(1.0f,outBuf[k][j]))*mul;
-              }
-              if (++curFadeOutSample>=fadeOutSamples) {
-                playing=false;
-                break;
-              }
-            } else {
-              for (int k=0; k<exportOutputs; k++) {
-                outBufFinal[fi++]=MAX(-1.0f,MIN(1.0f,outBuf[k][j]));
-              }
-              if (lastLoopPos>-1 && j>=lastLoopPos && totalLoops>=exportLoopCount) {
-                logD("start fading out...");
-                isFadingOut=true;
-                if (fadeOutSamples==0) break;
-              }
-            }
-          }
-          if (sf_writef_float(sf,outBufFinal,total)!=(int)total) {
-            logE("error: failed to write entire buffer!");
-            break;
-          }
-        }
-
-        if (sfWrap.doClose()!=0) {
-          logE("could not close audio file!");
-        }
-
+        stems.push_back(i);
         if (getChannelType(i)==5) {
           i++;
           while (true) {
@@ -351,13 +430,59 @@ void DivEngine::runExportThread() {
           }
           i--;
         }
-
-        if (stopExport) break;
       }
 
-      delete[] outBufFinal;
-      for (int i=0; i<exportOutputs; i++) {
-        delete[] outBuf[i];
+      int threads=exportThreads;
+      if (threads<1) threads=std::thread::hardware_concurrency();
+      if (threads>(int)stems.size()) threads=stems.size();
+
+      logI("rendering to files...");
+
+      if (threads>1) {
+        // render stems on separate engines, each with its own copy of the song
+        logI("using %d threads.",threads);
+        DivStemExport job;
+        SafeWriter* w=saveFur(true);
+        if (w==NULL) {
+          logE("could not copy song for rendering!");
+        } else {
+          job.songData=w->getFinalBuf();
+          job.songLen=w->size();
+          job.stems=stems;
+          job.nextStem=0;
+          job.frames=0;
+
+          std::thread** workers=new std::thread*[threads];
+          for (int i=0; i<threads; i++) {
+            workers[i]=new std::thread(_runStemWorker,this,&job);
+          }
+          for (int i=0; i<threads; i++) {
+            workers[i]->join();
+            delete workers[i];
+          }
+          delete[] workers;
+          exportFrames=job.frames;
+
+          w->finish();
+          delete w;
+        }
+      } else {
+        float* outBuf[DIV_MAX_OUTPUTS];
+        float* outBufFinal;
+        for (int i=0; i<exportOutputs; i++) {
+          outBuf[i]=new float[EXPORT_BUFSIZE];
+        }
+        outBufFinal=new float[EXPORT_BUFSIZE*exportOutputs];
+
+        for (int i: stems) {
+          if (!exportChanStem(i,outBuf,outBufFinal,&stopExport)) break;
+          if (stopExport) break;
+        }
+
+        delete[] outBufFinal;
+        for (int i=0; i<exportOutputs; i++) {
+          delete[] outBuf[i];
+        }
       }
 
       for (int i=0; i<chans; i++) {
@@ -370,7 +495,7 @@ void DivEngine::runExportThread() {
       if (initAudioBackend()) {
         for (int i=0; i<song.systemLen; i++) {
           disCont[i].setRates(got.rate);
-          disCont[i].setQuality(lowQuality,dcHiPass);
+          disCont[i].setQuality(lowQuality,dcHiPass,simdBlip);
         }
         if (!output->setRun(true)) {
           logE("error while activating audio!");
@@ -416,6 +541,7 @@ bool DivEngine::saveAudio(const char* path, DivAudioExportOptions options) {
   }
   exporting=true;
   stopExport=false;
+  exportFrames=0;
   stop();
   repeatPattern=false;
   setOrder(0);
@@ -438,6 +564,7 @@ bool DivEngine::saveAudio(const char* path, DivAudioExportOptions options) {
   exportOutputs=options.chans;
   if (exportOutputs<1) exportOutputs=1;
   if (exportOutputs>DIV_MAX_OUTPUTS) exportOutputs=DIV_MAX_OUTPUTS;
+  exportThreads=options.threads;
 
   exportLoopCount=options.loops+1;
   exportThread=new std::thread(_runExportThread,this);
@@ -448,6 +575,8 @@ bool DivEngine::saveAudio(const char* path, DivAudioExportOptions options) {
 void DivEngine::waitAudioFile() {
   if (exportThread!=NULL) {
     exportThread->join();
+    delete exportThread;
+    exportThread=NULL;
   }
 }
 
@@ -459,6 +588,10 @@ bool DivEngine::haltAudioFile() {
   return true;
 }
 
+size_t DivEngine::getExportedFrames() {
+  return exportFrames;
+}
+
 void DivEngine::finishAudioFile() {
   if (shallSwitchCores()) {
     bool isMutedBefore[DIV_MAX_CHANS];
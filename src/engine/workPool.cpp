@@ -20,6 +20,9 @@
 #include "workPool.h"
 #include "../ta-log.h"
 #include <thread>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 void* _workThread(void* inst) {
   ((DivWorkThread*)inst)->run();
@@ -208,3 +211,235 @@ DivWorkPool::~DivWorkPool() {
     }
   }
 }
+
+// DivLockFreeWorkPool
+
+// how many times to poll before parking a thread
+// (spinning is disabled on single-core machines)
+#define DIV_LF_SPIN_COUNT 4096
+
+static inline void cpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  _mm_pause();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  __asm__ __volatile__("pause");
+#elif defined(__GNUC__) && defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+bool DivLockFreeTaskQueue::push(void (*what)(void*), void* arg) {
+  unsigned int t=tail.load(std::memory_order_relaxed);
+  unsigned int h=head.load(std::memory_order_acquire);
+  if (t-h>=DIV_LF_QUEUE_SIZE) return false;
+  func[t&(DIV_LF_QUEUE_SIZE-1)].store(what,std::memory_order_relaxed);
+  funcArg[t&(DIV_LF_QUEUE_SIZE-1)].store(arg,std::memory_order_relaxed);
+  tail.store(t+1,std::memory_order_release);
+  return true;
+}
+
+bool DivLockFreeTaskQueue::take(DivPendingTask& task) {
+  unsigned int h=head.load(std::memory_order_acquire);
+  while (true) {
+    unsigned int t=tail.load(std::memory_order_acquire);
+    if ((int)(t-h)<=0) return false;
+    // the slot may be overwritten after another thread takes it, in which case
+    // the exchange below fails and we try again.
+    task.func=func[h&(DIV_LF_QUEUE_SIZE-1)].load(std::memory_order_relaxed);
+    task.funcArg=funcArg[h&(DIV_LF_QUEUE_SIZE-1)].load(std::memory_order_relaxed);
+    if (head.compare_exchange_weak(h,h+1,std::memory_order_acq_rel,std::memory_order_acquire)) {
+      return true;
+    }
+  }
+}
+
+bool DivLockFreeTaskQueue::empty() {
+  return head.load(std::memory_order_acquire)==tail.load(std::memory_order_acquire);
+}
+
+void* _lfWorkThread(void* inst) {
+  ((DivLockFreeWorkThread*)inst)->run();
+  return NULL;
+}
+
+void DivLockFreeWorkThread::run() {
+  unsigned int seenEpoch=0;
+
+  logV("running lock-free work thread %d",index);
+
+  while (true) {
+    unsigned int spins=0;
+    while (parent->epoch.load(std::memory_order_acquire)==seenEpoch) {
+      if (spins<parent->spinCount) {
+        spins++;
+        cpuRelax();
+        continue;
+      }
+      // park
+      std::unique_lock<std::mutex> unique(parent->parkLock);
+      parent->sleeping++;
+      parent->parkCond.wait(unique,[this,seenEpoch]() {
+        return parent->epoch.load()!=seenEpoch;
+      });
+      parent->sleeping--;
+    }
+    seenEpoch=parent->epoch.load(std::memory_order_acquire);
+    if (parent->terminate) break;
+
+    parent->runTasks(index);
+  }
+}
+
+bool DivLockFreeWorkThread::init(DivLockFreeWorkPool* p, unsigned int i) {
+  parent=p;
+  index=i;
+  try {
+    thread=new std::thread(_lfWorkThread,this);
+  } catch (std::system_error& e) {
+    logE("could not start thread! %s",e.what());
+    thread=NULL;
+    return false;
+  }
+  return true;
+}
+
+void DivLockFreeWorkPool::runTasks(unsigned int first) {
+  DivPendingTask task;
+  while (true) {
+    // try our own queue first, then steal from the others
+    bool found=false;
+    for (unsigned int i=0; i<lfCount; i++) {
+      unsigned int q=first+i;
+      if (q>=lfCount) q-=lfCount;
+      if (queues[q].take(task)) {
+        found=true;
+        break;
+      }
+    }
+    if (!found) break;
+
+    task.func(task.funcArg);
+
+    int pendingCount=--pending;
+    if (pendingCount<0) {
+      logE("oh no PROBLEM...");
+    }
+    if (pendingCount==0 && joinWaiting.load()) {
+      std::lock_guard<std::mutex> guard(joinLock);
+      joinCond.notify_one();
+    }
+  }
+}
+
+void DivLockFreeWorkPool::push(void (*what)(void*), void* arg) {
+  // if no work threads, just execute
+  if (!lfThreaded) {
+    what(arg);
+    return;
+  }
+
+  pending++;
+  for (unsigned int tryCount=0; tryCount<lfCount; tryCount++) {
+    if (lfPos>=lfCount) lfPos=0;
+    if (queues[lfPos++].push(what,arg)) return;
+  }
+  pending--;
+
+  // all queues are full
+  logW("DivLockFreeWorkPool: all work queues full!");
+  what(arg);
+}
+
+bool DivLockFreeWorkPool::busy() {
+  if (!lfThreaded) return false;
+  return pending.load()>0;
+}
+
+void DivLockFreeWorkPool::wait() {
+  if (!lfThreaded) return;
+
+  if (pending.load()==0) {
+    lfPos=0;
+    return;
+  }
+
+  // release the workers
+  epoch++;
+  if (sleeping.load()>0) {
+    std::lock_guard<std::mutex> guard(parkLock);
+    parkCond.notify_all();
+  }
+
+  // help out
+  runTasks(0);
+
+  // wait for tasks which are still running
+  unsigned int spins=0;
+  while (pending.load(std::memory_order_acquire)>0) {
+    if (spins<spinCount) {
+      spins++;
+      cpuRelax();
+      continue;
+    }
+    std::unique_lock<std::mutex> unique(joinLock);
+    joinWaiting=true;
+    joinCond.wait(unique,[this]() {
+      return pending.load()<=0;
+    });
+    joinWaiting=false;
+  }
+
+  lfPos=0;
+}
+
+DivLockFreeWorkPool::DivLockFreeWorkPool(unsigned int threads):
+  DivWorkPool(0),
+  lfThreaded(threads>1),
+  terminate(false),
+  spinCount((std::thread::hardware_concurrency()>1)?DIV_LF_SPIN_COUNT:0),
+  lfCount(threads>1?(threads-1):0),
+  lfPos(0),
+  lfThreads(NULL),
+  queues(NULL),
+  epoch(0),
+  pending(0),
+  sleeping(0),
+  joinWaiting(false) {
+  if (lfThreaded) {
+    queues=new DivLockFreeTaskQueue[lfCount];
+    lfThreads=new DivLockFreeWorkThread[lfCount];
+    for (unsigned int i=0; i<lfCount; i++) {
+      if (!lfThreads[i].init(this,i)) {
+        lfCount=i;
+        break;
+      }
+    }
+    if (lfCount<=0) {
+      logE("DivLockFreeWorkPool: couldn't start any threads! falling back to non-threaded mode.");
+      delete[] lfThreads;
+      delete[] queues;
+      lfThreaded=false;
+      lfThreads=NULL;
+      queues=NULL;
+    }
+  }
+}
+
+DivLockFreeWorkPool::~DivLockFreeWorkPool() {
+  if (lfThreaded) {
+    terminate=true;
+    epoch++;
+    {
+      std::lock_guard<std::mutex> guard(parkLock);
+      parkCond.notify_all();
+    }
+    for (unsigned int i=0; i<lfCount; i++) {
+      if (lfThreads[i].thread!=NULL) {
+        lfThreads[i].thread->join();
+        delete lfThreads[i].thread;
+      }
+    }
+    delete[] lfThreads;
+    delete[] queues;
+  }
+}
@@ -24,6 +24,7 @@
 #include <atomic>
 #include <functional>
 #include <future>
+#include <condition_variable>
 
 #include "../fixedQueue.h"
 
@@ -81,20 +82,111 @@ class DivWorkPool {
      * push a new job to this work pool.
      * if all work threads are busy, this will block until one is free.
      */
-    void push(void (*what)(void*), void* arg);
+    virtual void push(void (*what)(void*), void* arg);
     
     /**
      * check whether this work pool is busy.
      */
-    bool busy();
+    virtual bool busy();
 
     /**
      * wait for all work threads to finish.
      */
-    void wait();
+    virtual void wait();
 
     DivWorkPool(unsigned int threads=0);
-    ~DivWorkPool();
+    virtual ~DivWorkPool();
+};
+
+// size of each worker queue in DivLockFreeWorkPool. must be a power of 2.
+#define DIV_LF_QUEUE_SIZE 32
+
+// padding used to keep frequently written atomics in separate cache lines.
+// (alignas can't be used here as we target C++14, which lacks aligned new)
+#define DIV_LF_PAD(x) char x[64-sizeof(std::atomic<unsigned int>)]
+
+class DivLockFreeWorkPool;
+
+/**
+ * single-producer, multi-consumer ring of tasks.
+ * only the thread which calls push() may write to it, but any worker may take from it.
+ */
+struct DivLockFreeTaskQueue {
+  std::atomic<void (*)(void*)> func[DIV_LF_QUEUE_SIZE];
+  std::atomic<void*> funcArg[DIV_LF_QUEUE_SIZE];
+  std::atomic<unsigned int> head;
+  DIV_LF_PAD(headPad);
+  std::atomic<unsigned int> tail;
+  DIV_LF_PAD(tailPad);
+
+  bool push(void (*what)(void*), void* arg);
+  bool take(DivPendingTask& task);
+  bool empty();
+
+  DivLockFreeTaskQueue():
+    head(0),
+    tail(0) {
+    for (int i=0; i<DIV_LF_QUEUE_SIZE; i++) {
+      func[i]=NULL;
+      funcArg[i]=NULL;
+    }
+  }
+};
+
+struct DivLockFreeWorkThread {
+  DivLockFreeWorkPool* parent;
+  std::thread* thread;
+  unsigned int index;
+
+  void run();
+  bool init(DivLockFreeWorkPool* p, unsigned int i);
+  DivLockFreeWorkThread():
+    parent(NULL),
+    thread(NULL),
+    index(0) {}
+};
+
+/**
+ * a low-latency alternative to DivWorkPool, meant for the audio render path.
+ * - tasks go to per-worker lock-free queues. idle workers steal from other queues.
+ * - wait() releases the workers, runs tasks on the calling thread as well, and
+ *   then spins for a short while before parking on a condition variable.
+ * - workers spin for a short while before parking as well, so back-to-back
+ *   push()/wait() cycles (one per tick) don't go through the OS scheduler.
+ * the calling thread counts as one of the threads, so `threads` workers means
+ * `threads-1` work threads are created.
+ */
+class DivLockFreeWorkPool: public DivWorkPool {
+  friend struct DivLockFreeWorkThread;
+  bool lfThreaded;
+  std::atomic<bool> terminate;
+  unsigned int spinCount;
+  unsigned int lfCount;
+  unsigned int lfPos;
+  DivLockFreeWorkThread* lfThreads;
+  DivLockFreeTaskQueue* queues;
+
+  std::atomic<unsigned int> epoch;
+  DIV_LF_PAD(epochPad);
+  std::atomic<int> pending;
+  DIV_LF_PAD(pendingPad);
+  std::atomic<int> sleeping;
+  std::atomic<bool> joinWaiting;
+
+  std::mutex parkLock;
+  std::condition_variable parkCond;
+  std::mutex joinLock;
+  std::condition_variable joinCond;
+
+  // run tasks until all queues are empty, starting from the given queue.
+  void runTasks(unsigned int first);
+  public:
+    void push(void (*what)(void*), void* arg);
+    bool busy();
+    void wait();
+
+    DivLockFreeWorkPool(unsigned int threads=0);
+    ~DivLockFreeWorkPool();
 };
 
 #endif
@@ -218,6 +218,7 @@ void FurnaceGUI::drawCompatFlags() {
         ImGui::Indent();
         if (ImGui::RadioButton(_("None"),e->song.linearPitch==0)) {
           e->song.linearPitch=0;
+          e->notifyPitchTable();
         }
         if (ImGui::IsItemHovered()) {
           ImGui::SetTooltip(_("like ProTracker/FamiTracker"));
@@ -226,6 +227,7 @@ void FurnaceGUI::drawCompatFlags() {
           pushWarningColor(true);
           if (ImGui::RadioButton(_("Partial (only 04xy/E5xx)"),e->song.linearPitch==1)) {
             e->song.linearPitch=1;
+            e->notifyPitchTable();
           }
           if (ImGui::IsItemHovered()) {
             ImGui::SetTooltip(_("like DefleMask\n\nthis pitch linearity mode is deprecated due to:\n- excessive complexity\n- lack of possible optimization\n\nit is recommended to change it now because I will remove this option in the future!"));
@@ -234,6 +236,7 @@ void FurnaceGUI::drawCompatFlags() {
         }
         if (ImGui::RadioButton(_("Full"),e->song.linearPitch==2)) {
           e->song.linearPitch=2;
+          e->notifyPitchTable();
         }
         if (ImGui::IsItemHovered()) {
           ImGui::SetTooltip(_("like Impulse Tracker"));
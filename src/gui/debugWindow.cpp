@@ -387,8 +387,8 @@ void FurnaceGUI::drawDebug() {
           int note=(12*ptcOctave)+i;
           int pitch=0;
 
-          int base=e->calcBaseFreq(ptcClock,ptcDivider,note,ptcMode==1);
-          int final=e->calcFreq(base,pitch,ptcMode==1,0,0,ptcClock,ptcDivider,(ptcMode==2)?ptcBlockBits:0);
+          int base=e->calcBaseFreq(ptcClock,ptcDivider,note,ptcMode==1,false);
+          int final=e->calcFreq(base,pitch,0,false,ptcMode==1,0,0,ptcClock,ptcDivider,(ptcMode==2)?ptcBlockBits:0,false);
 
           ImGui::TableNextRow();
           ImGui::TableNextColumn();
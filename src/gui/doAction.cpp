@@ -1161,6 +1161,7 @@ void FurnaceGUI::doAction(int what) {
             sample->data16[pos+i]=sampleClipboard[i];
           }
         }
+        sample->invalidateMipmap(pos,pos+sampleClipboardLen);
         e->renderSamples(curSample);
       });
       sampleSelStart=pos;
@@ -1198,6 +1199,7 @@ void FurnaceGUI::doAction(int what) {
             sample->data16[pos+i]=val;
           }
         }
+        sample->invalidateMipmap(pos,pos+sampleClipboardLen);
         e->renderSamples(curSample);
       });
       sampleSelStart=pos;
@@ -1268,6 +1270,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMipmap(start,end);
         updateSampleTex=true;
 
         e->renderSamples(curSample);
@@ -1299,6 +1302,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMipmap(start,end);
         updateSampleTex=true;
 
         e->renderSamples(curSample);
@@ -1330,6 +1334,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMipmap(start,end);
         updateSampleTex=true;
 
         e->renderSamples(curSample);
@@ -1359,6 +1364,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMipmap(start,end);
         updateSampleTex=true;
 
         e->renderSamples(curSample);
@@ -1428,6 +1434,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMipmap(start,end);
         updateSampleTex=true;
 
         e->renderSamples(curSample);
@@ -1455,6 +1462,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMipmap(start,end);
         updateSampleTex=true;
 
         e->renderSamples(curSample);
@@ -1480,6 +1488,7 @@ void FurnaceGUI::doAction(int what) {
           }
         }
 
+        sample->invalidateMipmap(start,end);
         updateSampleTex=true;
 
         e->renderSamples(curSample);
@@ -73,6 +73,14 @@ void FurnaceGUI::drawExportAudio(bool onWindow) {
 
   bool isOneOn=false;
   if (audioExportOptions.mode==DIV_EXPORT_MODE_MANY_CHAN) {
+    if (ImGui::InputInt(_("Threads"),&audioExportOptions.threads,1,1)) {
+      if (audioExportOptions.threads<0) audioExportOptions.threads=0;
+      if (audioExportOptions.threads>256) audioExportOptions.threads=256;
+    }
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip(_("number of channels to render at once.\n0 means one per CPU core."));
+    }
+
     ImGui::Text(_("Channels to export:"));
     ImGui::SameLine();
     if (ImGui::SmallButton(_("All"))) {
@@ -430,6 +438,7 @@ void FurnaceGUI::drawExport() {
       }
       if (ImGui::Button(_("Set pitch linearity to Partial"))) {
         e->song.linearPitch=1;
+        e->notifyPitchTable();
         ImGui::CloseCurrentPopup();
       }
       if (ImGui::Button(_("Enable multi-threading settings"))) {
@@ -37,6 +37,7 @@
 #include "intConst.h"
 #include "scaling.h"
 #include "introTune.h"
+#include "../engine/parallelDeflate.h"
 #include <stdint.h>
 #include <zlib.h>
 #include <fmt/printf.h>
@@ -2141,8 +2142,23 @@ void FurnaceGUI::openFileDialog(FurnaceGUIFileDialogs type) {
   //ImGui::GetIO().ConfigFlags|=ImGuiConfigFlags_NavEnableKeyboard;
 }
 
-int FurnaceGUI::save(String path, int dmfVersion) {
+int FurnaceGUI::finishSave() {
+  if (!saveTask.valid()) return 0;
+  int ret=saveTask.get();
+  if (ret>0) {
+    lastError=saveError;
+    logE("couldn't save! %s",lastError);
+    modified=true;
+    updateWindowTitle();
+  }
+  return ret;
+}
+
+int FurnaceGUI::save(String path, int dmfVersion, bool wait) {
   SafeWriter* w;
+  if (finishSave()>0) {
+    showError(fmt::sprintf(_("Error while saving file! (%s)"),lastError));
+  }
   logD("saving file...");
   if (dmfVersion) {
     if (dmfVersion<24) dmfVersion=24;
@@ -2163,76 +2179,49 @@ int FurnaceGUI::save(String path, int dmfVersion) {
     w->finish();
     return 1;
   }
-  if (settings.compress) {
-    unsigned char zbuf[131072];
-    int ret;
-    z_stream zl;
-    memset(&zl,0,sizeof(z_stream));
-    ret=deflateInit(&zl,Z_DEFAULT_COMPRESSION);
-    if (ret!=Z_OK) {
-      logE("zlib error!");
-      lastError=_("compression error");
-      fclose(outFile);
-      w->finish();
-      return 2;
-    }
-    zl.avail_in=w->size();
-    zl.next_in=w->getFinalBuf();
-    while (zl.avail_in>0) {
-      zl.avail_out=131072;
-      zl.next_out=zbuf;
-      if ((ret=deflate(&zl,Z_NO_FLUSH))==Z_STREAM_ERROR) {
-        logE("zlib stream error!");
-        lastError=_("zlib stream error");
-        deflateEnd(&zl);
-        fclose(outFile);
-        w->finish();
-        return 2;
-      }
-      size_t amount=131072-zl.avail_out;
-      if (amount>0) {
-        if (fwrite(zbuf,1,amount,outFile)!=amount) {
-          logE("did not write entirely: %s!",strerror(errno));
-          lastError=strerror(errno);
-          deflateEnd(&zl);
-          fclose(outFile);
-          w->finish();
-          return 1;
-        }
+  // the song has been serialized already, so it may be edited while this runs
+  bool compress=settings.compress;
+  saveProgress=0;
+  saveTotal=w->size();
+  saveTask=std::async(std::launch::async,[this,w,outFile,compress]() -> int {
+    int ret=0;
+    SafeWriter* zw=NULL;
+    unsigned char* buf=w->getFinalBuf();
+    size_t len=w->size();
+    if (compress) {
+      zw=parallelDeflate(buf,len,Z_DEFAULT_COMPRESSION,0,&saveProgress);
+      if (zw==NULL) {
+        saveError=_("compression error");
+        ret=2;
+      } else {
+        buf=zw->getFinalBuf();
+        len=zw->size();
       }
     }
-    zl.avail_out=131072;
-    zl.next_out=zbuf;
-    if ((ret=deflate(&zl,Z_FINISH))==Z_STREAM_ERROR) {
-      logE("zlib finish stream error!");
-      lastError=_("zlib finish stream error");
-      deflateEnd(&zl);
-      fclose(outFile);
-      w->finish();
-      return 2;
-    }
-    if (131072-zl.avail_out>0) {
-      if (fwrite(zbuf,1,131072-zl.avail_out,outFile)!=(131072-zl.avail_out)) {
+    if (ret==0) {
+      if (fwrite(buf,1,len,outFile)!=len) {
         logE("did not write entirely: %s!",strerror(errno));
-        lastError=strerror(errno);
-        deflateEnd(&zl);
-        fclose(outFile);
-        w->finish();
-        return 1;
+        saveError=strerror(errno);
+        ret=1;
       }
     }
-    deflateEnd(&zl);
-  } else {
-    if (fwrite(w->getFinalBuf(),1,w->size(),outFile)!=w->size()) {
-      logE("did not write entirely: %s!",strerror(errno));
-      lastError=strerror(errno);
-      fclose(outFile);
-      w->finish();
-      return 1;
+    if (fclose(outFile)!=0 && ret==0) {
+      saveError=strerror(errno);
+      ret=1;
+    }
+    if (zw!=NULL) {
+      zw->finish();
+      delete zw;
     }
+    w->finish();
+    delete w;
+    saveProgress=saveTotal.load();
+    return ret;
+  });
+  if (wait) {
+    int ret=finishSave();
+    if (ret>0) return ret;
   }
-  fclose(outFile);
-  w->finish();
   backupLock.lock();
   curFileName=path;
   backupLock.unlock();
@@ -2319,6 +2308,7 @@ int FurnaceGUI::load(String path) {
   lastError=_("everything OK");
   undoHist.clear();
   redoHist.clear();
+  clearPatTextCache();
   updateWindowTitle();
   updateScroll(0);
   if (!e->getWarnings().empty()) {
@@ -2647,6 +2637,9 @@ void FurnaceGUI::processDrags(int dragX, int dragY) {
           if (val>127) val=127;
           for (int i=x; i<=x1; i++) ((signed char*)sampleDragTarget)[i]=val;
         }
+        if (curSample>=0 && curSample<(int)e->song.sample.size()) {
+          e->song.sample[curSample]->invalidateMipmap(x,x1+1);
+        }
         updateSampleTex=true;
       }
     } else { // select
@@ -4659,7 +4652,9 @@ bool FurnaceGUI::loop() {
         }
       }
       ImGui::PopStyleColor();
-      if (modified) {
+      if (saveTask.valid()) {
+        ImGui::Text(_("| saving (%d%%)"),(saveTotal>0)?(int)((saveProgress*100)/saveTotal):0);
+      } else if (modified) {
         ImGui::Text(_("| modified"));
       }
       ImGui::EndMainMenuBar();
@@ -5024,7 +5019,7 @@ bool FurnaceGUI::loop() {
               break;
             case GUI_FILE_SAVE: {
               bool saveWasSuccessful=true;
-              if (save(copyOfName,0)>0) {
+              if (save(copyOfName,0,postWarnAction==GUI_WARN_QUIT)>0) {
                 showError(fmt::sprintf(_("Error while saving file! (%s)"),lastError));
                 saveWasSuccessful=false;
               }
@@ -5656,7 +5651,7 @@ bool FurnaceGUI::loop() {
               openFileDialog(GUI_FILE_SAVE);
               postWarnAction=GUI_WARN_QUIT;
             } else {
-              if (save(curFileName,e->song.isDMF?e->song.version:0)>0) {
+              if (save(curFileName,e->song.isDMF?e->song.version:0,true)>0) {
                 showError(fmt::sprintf(_("Error while saving file! (%s)"),lastError));
               } else {
                 quit=true;
@@ -5904,11 +5899,7 @@ bool FurnaceGUI::loop() {
               e->lockEngine([this]() {
                 for (int i=0; i<e->getTotalChannelCount(); i++) {
                   DivPattern* pat=e->curPat[i].getPattern(e->curOrders->ord[i][curOrder],true);
-                  memset(pat->data,-1,DIV_MAX_ROWS*DIV_MAX_COLS*sizeof(short));
-                  for (int j=0; j<DIV_MAX_ROWS; j++) {
-                    pat->data[j][0]=0;
-                    pat->data[j][1]=0;
-                  }
+                  pat->clear();
                 }
               });
               MARK_MODIFIED;
@@ -6420,6 +6411,15 @@ bool FurnaceGUI::loop() {
 
     layoutTimeEnd=SDL_GetPerformanceCounter();
 
+    // report errors from background save
+    if (saveTask.valid()) {
+      if (saveTask.wait_for(std::chrono::seconds(0))==std::future_status::ready) {
+        if (finishSave()>0) {
+          showError(fmt::sprintf(_("Error while saving file! (%s)"),lastError));
+        }
+      }
+    }
+
     // backup trigger
     if (modified && settings.backupEnable) {
       if (backupTimer>0) {
@@ -7605,6 +7605,10 @@ bool FurnaceGUI::finish(bool saveConfig) {
     oscValuesAverage=NULL;
   }
 
+  if (finishSave()>0) {
+    logE("the song could not be saved before quitting!");
+  }
+
   if (backupTask.valid()) {
     backupTask.get();
   }
@@ -7613,6 +7617,8 @@ bool FurnaceGUI::finish(bool saveConfig) {
     delete chanOscWorkPool;
   }
 
+  clearPatTextCache();
+
   return true;
 }
 
@@ -7745,6 +7751,8 @@ FurnaceGUI::FurnaceGUI():
   aboutSin(0),
   aboutHue(0.0f),
   backupTimer(0.0),
+  saveProgress(0),
+  saveTotal(0),
   totalBackupSize(0),
   refreshBackups(true),
   learning(-1),
@@ -8004,6 +8012,7 @@ FurnaceGUI::FurnaceGUI():
   opToMove(-1),
   assetToMove(-1),
   dirToMove(-1),
+  patTextOneDigit(false),
   transposeAmount(0),
   randomizeMin(0),
   randomizeMax(255),
@@ -8197,6 +8206,7 @@ FurnaceGUI::FurnaceGUI():
   memset(actionKeys,0,GUI_ACTION_MAX*sizeof(int));
 
   memset(patChanX,0,sizeof(float)*(DIV_MAX_CHANS+1));
+  memset(patChanOffX,0,sizeof(float)*(DIV_MAX_CHANS+1));
   memset(patChanSlideY,0,sizeof(float)*(DIV_MAX_CHANS+1));
   memset(lastIns,-1,sizeof(int)*DIV_MAX_CHANS);
   memset(oscValues,0,sizeof(void*)*DIV_MAX_OUTPUTS);
@@ -44,7 +44,7 @@
 #define handleUnimportant if (settings.insFocusesPattern && patternOpen) {nextWindow=GUI_WINDOW_PATTERN;}
 #define unimportant(x) if (x) {handleUnimportant}
 
-#define MARK_MODIFIED modified=true;
+#define MARK_MODIFIED modified=true; e->invalidateKeyframes();
 #define WAKE_UP drawHalt=5;
 
 #define RESET_WAVE_MACRO_ZOOM \
@@ -1445,6 +1445,25 @@ struct FurnaceGUIWaveSizeEntry {
     sys(NULL) {}
 };
 
+// formatted text of a pattern row (instrument, volume and effects).
+// the note column doesn't need this since noteName() returns a constant string.
+struct FurnaceGUIPatTextRow {
+  // raw data the text was formatted from. compared against the pattern on every draw,
+  // which invalidates the row as soon as it is edited.
+  short data[DIV_MAX_COLS];
+  // 0: instrument, 1: volume, 2+: effect/effect value
+  char text[DIV_MAX_COLS-2][4];
+  bool valid;
+
+  FurnaceGUIPatTextRow():
+    valid(false) {}
+};
+
+// formatted text of a pattern. only grows up to the last row which has been drawn.
+struct FurnaceGUIPatTextCache {
+  std::vector<FurnaceGUIPatTextRow> row;
+};
+
 enum FurnaceGUITextureFormat: unsigned int {
   GUI_TEXFORMAT_UNKNOWN=0,
   GUI_TEXFORMAT_ABGR32=1,
@@ -1671,6 +1690,11 @@ class FurnaceGUI {
   std::mutex backupLock;
   String backupPath;
 
+  // compression and writing of a saved file happen in the background
+  std::future<int> saveTask;
+  std::atomic<size_t> saveProgress, saveTotal;
+  String saveError;
+
   std::vector<FurnaceGUIBackupEntry> backupEntries;
   std::future<bool> backupEntryTask;
   std::mutex backupEntryLock;
@@ -1712,6 +1736,7 @@ class FurnaceGUI {
     int audioEngine;
     int audioQuality;
     int audioHiPass;
+    int audioSIMD;
     int audioChans;
     int arcadeCore;
     int ym2612Core;
@@ -1910,6 +1935,10 @@ class FurnaceGUI {
     int wasapiEx;
     int chanOscThreads;
     int renderPoolThreads;
+    int renderPoolLockFree;
+    int renderPerBuffer;
+    int seekKeyframeInterval;
+    int sampleCacheSize;
     int showPool;
     int writeInsNames;
     int readInsNames;
@@ -1971,6 +2000,7 @@ class FurnaceGUI {
       audioEngine(DIV_AUDIO_SDL),
       audioQuality(0),
       audioHiPass(1),
+      audioSIMD(1),
       audioChans(2),
       arcadeCore(0),
       ym2612Core(0),
@@ -2166,6 +2196,10 @@ class FurnaceGUI {
       wasapiEx(0),
       chanOscThreads(0),
       renderPoolThreads(0),
+      renderPoolLockFree(0),
+      renderPerBuffer(0),
+      seekKeyframeInterval(4),
+      sampleCacheSize(64),
       showPool(0),
       writeInsNames(0),
       readInsNames(1),
@@ -2284,6 +2318,8 @@ class FurnaceGUI {
   std::atomic<bool> failedNoteOn;
   float peak[DIV_MAX_OUTPUTS];
   float patChanX[DIV_MAX_CHANS+1];
+  // X offset of each channel within the pattern (prefix sum of cell widths)
+  float patChanOffX[DIV_MAX_CHANS+1];
   float patChanSlideY[DIV_MAX_CHANS+1];
   float lastPatternWidth, longThreshold;
   float buttonLongThreshold;
@@ -2457,6 +2493,8 @@ class FurnaceGUI {
   ImVec2 noteCellSize, insCellSize, volCellSize, effectCellSize, effectValCellSize;
   SelectionPoint sel1, sel2;
   int dummyRows;
+  std::unordered_map<const DivPattern*,FurnaceGUIPatTextCache*> patTextCache;
+  bool patTextOneDigit;
   int transposeAmount, randomizeMin, randomizeMax, fadeMin, fadeMax, collapseAmount;
   float scaleMax;
   bool fadeMode, randomMode, haveHitBounds;
@@ -2732,7 +2770,11 @@ class FurnaceGUI {
 
   float calcBPM(const DivGroovePattern& speeds, float hz, int vN, int vD);
 
-  void patternRow(int i, bool isPlaying, float lineHeight, int chans, int ord, const DivPattern** patCache, bool inhibitSel);
+  FurnaceGUIPatTextCache* getPatTextCache(const DivPattern* pat);
+  void prunePatTextCache();
+  void clearPatTextCache();
+  void formatPatTextRow(FurnaceGUIPatTextRow& row, const short* data);
+  void patternRow(int i, bool isPlaying, float lineHeight, int chans, int ord, const DivPattern** patCache, FurnaceGUIPatTextCache** textCache, bool inhibitSel);
 
   void drawMacroEdit(FurnaceGUIMacroDesc& i, int totalFit, float availableWidth, int index);
   void drawMacros(std::vector<FurnaceGUIMacroDesc>& macros, FurnaceGUIMacroEditState& state);
@@ -2909,7 +2951,9 @@ class FurnaceGUI {
   void pointMotion(int x, int y, int xrel, int yrel);
 
   void openFileDialog(FurnaceGUIFileDialogs type);
-  int save(String path, int dmfVersion);
+  // if wait is false, the file is compressed and written in the background.
+  int save(String path, int dmfVersion, bool wait=false);
+  int finishSave();
   int load(String path);
   int loadStream(String path);
   void openRecentFile(String path);
@@ -68,8 +68,65 @@ void FurnaceGUI::popPartBlend() {
   rend->setBlendMode(GUI_BLEND_MODE_BLEND);
 }
 
+// maximum number of patterns to keep formatted text of
+// (a frame may add up to 3*DIV_MAX_CHANS more)
+#define PAT_TEXT_CACHE_MAX (4*DIV_MAX_CHANS)
+
+// only call this before drawing, as it frees entries which may be in use afterwards.
+void FurnaceGUI::prunePatTextCache() {
+  // the effect format is part of the text
+  if (patTextOneDigit!=(settings.oneDigitEffects!=0)) {
+    clearPatTextCache();
+    patTextOneDigit=(settings.oneDigitEffects!=0);
+  }
+  // rows are checked against the pattern data when drawn, so entries of deleted patterns
+  // (or new patterns at the same address) are harmless. we only have to bound the size.
+  if (patTextCache.size()>=PAT_TEXT_CACHE_MAX) clearPatTextCache();
+}
+
+FurnaceGUIPatTextCache* FurnaceGUI::getPatTextCache(const DivPattern* pat) {
+  auto i=patTextCache.find(pat);
+  if (i!=patTextCache.end()) return i->second;
+
+  FurnaceGUIPatTextCache* ret=new FurnaceGUIPatTextCache;
+  patTextCache[pat]=ret;
+  return ret;
+}
+
+void FurnaceGUI::clearPatTextCache() {
+  for (auto& i: patTextCache) {
+    delete i.second;
+  }
+  patTextCache.clear();
+}
+
+void FurnaceGUI::formatPatTextRow(FurnaceGUIPatTextRow& row, const short* data) {
+  memcpy(row.data,data,DIV_MAX_COLS*sizeof(short));
+  for (int k=2; k<DIV_MAX_COLS; k++) {
+    char* text=row.text[k-2];
+    if (k>=4 && !(k&1)) {
+      // effect
+      if (data[k]>0xff) {
+        strcpy(text,"??");
+      } else if ((unsigned char)data[k]>=0x10 || settings.oneDigitEffects==0) {
+        snprintf(text,4,"%.2X",(unsigned char)data[k]);
+      } else {
+        snprintf(text,4," %.1X",(unsigned char)data[k]);
+      }
+    } else {
+      // instrument, volume or effect value
+      if (data[k]<0 || data[k]>0xfff) {
+        strcpy(text,"??");
+      } else {
+        snprintf(text,4,"%.2X",data[k]);
+      }
+    }
+  }
+  row.valid=true;
+}
+
 // draw a pattern row
-inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int chans, int ord, const DivPattern** patCache, bool inhibitSel) {
+inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int chans, int ord, const DivPattern** patCache, FurnaceGUIPatTextCache** textCache, bool inhibitSel) {
   static char id[64];
   bool selectedRow=(i>=sel1.y && i<=sel2.y && !inhibitSel);
   ImGui::TableNextRow(0,lineHeight);
@@ -162,11 +219,23 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
     int chanVolMax=e->getMaxVolumeChan(j);
     if (chanVolMax<1) chanVolMax=1;
     const DivPattern* pat=patCache[j];
-    ImGui::TableNextColumn();
+    bool chanVisible=ImGui::TableNextColumn();
     for (int k=mustSetXOf; k<=j; k++)  {
       patChanX[k]=ImGui::GetCursorScreenPos().x;
     }
     mustSetXOf=j+1;
+    // don't bother with channels which are scrolled out of view
+    if (!chanVisible) continue;
+
+    // formatted text, re-done only when the row has changed
+    std::vector<FurnaceGUIPatTextRow>& textRows=textCache[j]->row;
+    if ((int)textRows.size()<=i) textRows.resize(i+1);
+    FurnaceGUIPatTextRow& text=textRows[i];
+    if (!text.valid || memcmp(text.data,pat->data[i],DIV_MAX_COLS*sizeof(short))!=0) {
+      formatPatTextRow(text,pat->data[i]);
+    }
+    // unique ID of each cell (labels are no longer formatted with it)
+    int cellID=(i*DIV_MAX_CHANS+j)*DIV_MAX_COLS;
 
     // selection highlight flags
     int sel1XSum=sel1.xCoarse*32+sel1.xFine;
@@ -180,7 +249,8 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
     bool cursorVol=(cursor.y==i && cursor.xCoarse==j && cursor.xFine==2 && curWindowLast==GUI_WINDOW_PATTERN);
 
     // note
-    snprintf(id,63,"%.31s##PN_%d_%d",noteName(pat->data[i][0],pat->data[i][1]),i,j);
+    const char* noteText=noteName(pat->data[i][0],pat->data[i][1]);
+    ImGui::PushID(cellID);
     if (pat->data[i][0]==0 && pat->data[i][1]==0) {
       ImGui::PushStyleColor(ImGuiCol_Text,inactiveColor);
     } else {
@@ -190,11 +260,11 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
       ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_CURSOR]);
       ImGui::PushStyleColor(ImGuiCol_HeaderActive,uiColors[GUI_COLOR_PATTERN_CURSOR_ACTIVE]);
       ImGui::PushStyleColor(ImGuiCol_HeaderHovered,uiColors[GUI_COLOR_PATTERN_CURSOR_HOVER]);
-      ImGui::Selectable(id,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,noteCellSize);
+      ImGui::Selectable(noteText,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,noteCellSize);
       ImGui::PopStyleColor(3);
     } else {
       if (selectedNote) ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_SELECTION]);
-      ImGui::Selectable(id,isPushing || selectedNote,ImGuiSelectableFlags_NoPadWithHalfSpacing,noteCellSize);
+      ImGui::Selectable(noteText,isPushing || selectedNote,ImGuiSelectableFlags_NoPadWithHalfSpacing,noteCellSize);
       if (selectedNote) ImGui::PopStyleColor();
     }
     if (ImGui::IsItemClicked()) {
@@ -207,14 +277,16 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
       ImGui::InhibitInertialScroll();
       NOTIFY_LONG_HOLD;
     }
+    ImGui::PopID();
     ImGui::PopStyleColor();
 
     // the following is only visible when the channel is not collapsed
     if (e->curSubSong->chanCollapse[j]<3) {
       // instrument
+      const char* insText=text.text[0];
       if (pat->data[i][2]==-1) {
         ImGui::PushStyleColor(ImGuiCol_Text,inactiveColor);
-        snprintf(id,63,"%.31s##PI_%d_%d",emptyLabel2,i,j);
+        insText=emptyLabel2;
       } else {
         if (pat->data[i][2]<0 || pat->data[i][2]>=e->song.insLen) {
           ImGui::PushStyleColor(ImGuiCol_Text,uiColors[GUI_COLOR_PATTERN_INS_ERROR]);
@@ -226,18 +298,18 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
             ImGui::PushStyleColor(ImGuiCol_Text,uiColors[GUI_COLOR_PATTERN_INS]);
           }
         }
-        snprintf(id,63,"%.2X##PI_%d_%d",pat->data[i][2],i,j);
       }
       ImGui::SameLine(0.0f,0.0f);
+      ImGui::PushID(cellID+2);
       if (cursorIns) {
         ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_CURSOR]);
         ImGui::PushStyleColor(ImGuiCol_HeaderActive,uiColors[GUI_COLOR_PATTERN_CURSOR_ACTIVE]);
         ImGui::PushStyleColor(ImGuiCol_HeaderHovered,uiColors[GUI_COLOR_PATTERN_CURSOR_HOVER]);
-        ImGui::Selectable(id,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,insCellSize);
+        ImGui::Selectable(insText,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,insCellSize);
         ImGui::PopStyleColor(3);
       } else {
         if (selectedIns) ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_SELECTION]);
-        ImGui::Selectable(id,isPushing || selectedIns,ImGuiSelectableFlags_NoPadWithHalfSpacing,insCellSize);
+        ImGui::Selectable(insText,isPushing || selectedIns,ImGuiSelectableFlags_NoPadWithHalfSpacing,insCellSize);
         if (selectedIns) ImGui::PopStyleColor();
       }
       if (ImGui::IsItemClicked()) {
@@ -250,31 +322,33 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
         ImGui::InhibitInertialScroll();
         NOTIFY_LONG_HOLD;
       }
+      ImGui::PopID();
       ImGui::PopStyleColor();
     }
 
     if (e->curSubSong->chanCollapse[j]<2) {
       // volume
+      const char* volText=text.text[1];
       if (pat->data[i][3]==-1) {
-        snprintf(id,63,"%.31s##PV_%d_%d",emptyLabel2,i,j);
+        volText=emptyLabel2;
         ImGui::PushStyleColor(ImGuiCol_Text,inactiveColor);
       } else {
         int volColor=(pat->data[i][3]*127)/chanVolMax;
         if (volColor>127) volColor=127;
         if (volColor<0) volColor=0;
-        snprintf(id,63,"%.2X##PV_%d_%d",pat->data[i][3],i,j);
         ImGui::PushStyleColor(ImGuiCol_Text,volColors[volColor]);
       }
       ImGui::SameLine(0.0f,0.0f);
+      ImGui::PushID(cellID+3);
       if (cursorVol) {
         ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_CURSOR]);
         ImGui::PushStyleColor(ImGuiCol_HeaderActive,uiColors[GUI_COLOR_PATTERN_CURSOR_ACTIVE]);
         ImGui::PushStyleColor(ImGuiCol_HeaderHovered,uiColors[GUI_COLOR_PATTERN_CURSOR_HOVER]);
-        ImGui::Selectable(id,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,volCellSize);
+        ImGui::Selectable(volText,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,volCellSize);
         ImGui::PopStyleColor(3);
       } else {
         if (selectedVol) ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_SELECTION]);
-        ImGui::Selectable(id,isPushing || selectedVol,ImGuiSelectableFlags_NoPadWithHalfSpacing,volCellSize);
+        ImGui::Selectable(volText,isPushing || selectedVol,ImGuiSelectableFlags_NoPadWithHalfSpacing,volCellSize);
         if (selectedVol) ImGui::PopStyleColor();
       }
       if (ImGui::IsItemClicked()) {
@@ -287,6 +361,7 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
         ImGui::InhibitInertialScroll();
         NOTIFY_LONG_HOLD;
       }
+      ImGui::PopID();
       ImGui::PopStyleColor();
     }
 
@@ -300,33 +375,29 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
         bool cursorEffectVal=(cursor.y==i && cursor.xCoarse==j && cursor.xFine==index && curWindowLast==GUI_WINDOW_PATTERN);
         
         // effect
+        const char* effectText=text.text[index-2];
         if (pat->data[i][index]==-1) {
-          snprintf(id,63,"%.31s##PE%d_%d_%d",emptyLabel2,k,i,j);
+          effectText=emptyLabel2;
           ImGui::PushStyleColor(ImGuiCol_Text,inactiveColor);
         } else {
           if (pat->data[i][index]>0xff) {
-            snprintf(id,63,"??##PE%d_%d_%d",k,i,j);
             ImGui::PushStyleColor(ImGuiCol_Text,uiColors[GUI_COLOR_PATTERN_EFFECT_INVALID]);
-          } else if (pat->data[i][index]>=0x10 || settings.oneDigitEffects==0) {
-            const unsigned char data=pat->data[i][index];
-            snprintf(id,63,"%.2X##PE%d_%d_%d",data,k,i,j);
-            ImGui::PushStyleColor(ImGuiCol_Text,uiColors[fxColors[data]]);
           } else {
             const unsigned char data=pat->data[i][index];
-            snprintf(id,63," %.1X##PE%d_%d_%d",data,k,i,j);
             ImGui::PushStyleColor(ImGuiCol_Text,uiColors[fxColors[data]]);
           }
         }
         ImGui::SameLine(0.0f,0.0f);
+        ImGui::PushID(cellID+index);
         if (cursorEffect) {
           ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_CURSOR]);  
           ImGui::PushStyleColor(ImGuiCol_HeaderActive,uiColors[GUI_COLOR_PATTERN_CURSOR_ACTIVE]);
           ImGui::PushStyleColor(ImGuiCol_HeaderHovered,uiColors[GUI_COLOR_PATTERN_CURSOR_HOVER]);
-          ImGui::Selectable(id,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectCellSize);
+          ImGui::Selectable(effectText,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectCellSize);
           ImGui::PopStyleColor(3);
         } else {
           if (selectedEffect) ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_SELECTION]);
-          ImGui::Selectable(id,isPushing || selectedEffect,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectCellSize);
+          ImGui::Selectable(effectText,isPushing || selectedEffect,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectCellSize);
           if (selectedEffect) ImGui::PopStyleColor();
         }
         if (ImGui::IsItemClicked()) {
@@ -339,23 +410,21 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
           ImGui::InhibitInertialScroll();
           NOTIFY_LONG_HOLD;
         }
+        ImGui::PopID();
 
         // effect value
-        if (pat->data[i][index+1]==-1) {
-          snprintf(id,63,"%.31s##PF%d_%d_%d",emptyLabel2,k,i,j);
-        } else {
-          snprintf(id,63,"%.2X##PF%d_%d_%d",pat->data[i][index+1],k,i,j);
-        }
+        const char* effectValText=(pat->data[i][index+1]==-1)?emptyLabel2:text.text[index-1];
         ImGui::SameLine(0.0f,0.0f);
+        ImGui::PushID(cellID+index+1);
         if (cursorEffectVal) {
           ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_CURSOR]);  
           ImGui::PushStyleColor(ImGuiCol_HeaderActive,uiColors[GUI_COLOR_PATTERN_CURSOR_ACTIVE]);
           ImGui::PushStyleColor(ImGuiCol_HeaderHovered,uiColors[GUI_COLOR_PATTERN_CURSOR_HOVER]);
-          ImGui::Selectable(id,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectValCellSize);
+          ImGui::Selectable(effectValText,true,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectValCellSize);
           ImGui::PopStyleColor(3);
         } else {
           if (selectedEffectVal) ImGui::PushStyleColor(ImGuiCol_Header,uiColors[GUI_COLOR_PATTERN_SELECTION]);
-          ImGui::Selectable(id,isPushing || selectedEffectVal,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectValCellSize);
+          ImGui::Selectable(effectValText,isPushing || selectedEffectVal,ImGuiSelectableFlags_NoPadWithHalfSpacing,effectValCellSize);
           if (selectedEffectVal) ImGui::PopStyleColor();
         }
         if (ImGui::IsItemClicked()) {
@@ -368,6 +437,7 @@ inline void FurnaceGUI::patternRow(int i, bool isPlaying, float lineHeight, int
           ImGui::InhibitInertialScroll();
           NOTIFY_LONG_HOLD;
         }
+        ImGui::PopID();
         ImGui::PopStyleColor();
       }
     }
@@ -390,6 +460,8 @@ void FurnaceGUI::drawPattern() {
   }
   if (!patternOpen) return;
 
+  prunePatTextCache();
+
   bool inhibitMenu=false;
 
   if (e->isPlaying() && followPattern) {
@@ -1115,79 +1187,105 @@ void FurnaceGUI::drawPattern() {
       effectValCellSize=twoChars;
       effectValCellSize.x+=(float)settings.effectValCellSpacing*dpiScale;
 
+      // X offset of every channel (without column borders)
+      patChanOffX[0]=-fourChars.x;
+      for (int i=0; i<chans; i++) {
+        float chanWidth=0.0f;
+        if (e->curSubSong->chanShow[i]) {
+          chanWidth=noteCellSize.x;
+          if (e->curSubSong->chanCollapse[i]<3) chanWidth+=insCellSize.x;
+          if (e->curSubSong->chanCollapse[i]<2) chanWidth+=volCellSize.x;
+          if (e->curSubSong->chanCollapse[i]<1) chanWidth+=(effectCellSize.x+effectValCellSize.x)*e->curPat[i].effectCols;
+        }
+        patChanOffX[i+1]=patChanOffX[i]+chanWidth;
+      }
+
       dummyRows=(ImGui::GetWindowSize().y/lineHeight)/2;
 
       // オップナー2608 i owe you one more for this horrible code
-      // previous pattern
-      ImGui::BeginDisabled();
-      ImGui::PushStyleVar(ImGuiStyleVar_FrameShading,0.0f);
+      // the view is made of three parts: the end of the previous pattern, the current pattern and
+      // the beginning of the next one. only the rows within view are submitted.
+      const DivPattern* prevPatCache[DIV_MAX_CHANS];
+      const DivPattern* nextPatCache[DIV_MAX_CHANS];
+      FurnaceGUIPatTextCache* prevTextCache[DIV_MAX_CHANS];
+      FurnaceGUIPatTextCache* textCache[DIV_MAX_CHANS];
+      FurnaceGUIPatTextCache* nextTextCache[DIV_MAX_CHANS];
+      int prevRows=MAX(0,dummyRows-1);
+      int nextRows=MAX(0,dummyRows+1);
+      int patLen=e->curSubSong->patLen;
       if (settings.viewPrevPattern) {
         if ((ord-1)>=0) for (int i=0; i<chans; i++) {
-          patCache[i]=e->curPat[i].getPattern(e->curOrders->ord[i][ord-1],true);
+          prevPatCache[i]=e->curPat[i].getPattern(e->curOrders->ord[i][ord-1],true);
+          prevTextCache[i]=getPatTextCache(prevPatCache[i]);
         }
-        for (int i=0; i<dummyRows-1; i++) {
-          patternRow(e->curSubSong->patLen+i-dummyRows+1,e->isPlaying(),lineHeight,chans,ord-1,patCache,true);
-        }
-      } else {
-        for (int i=0; i<dummyRows-1; i++) {
-          ImGui::TableNextRow(0,lineHeight);
-          ImGui::TableNextColumn();
+        if ((ord+1)<e->curSubSong->ordersLen) for (int i=0; i<chans; i++) {
+          nextPatCache[i]=e->curPat[i].getPattern(e->curOrders->ord[i][ord+1],true);
+          nextTextCache[i]=getPatTextCache(nextPatCache[i]);
         }
       }
-      ImGui::EndDisabled();
-      // active area
       for (int i=0; i<chans; i++) {
         patCache[i]=e->curPat[i].getPattern(e->curOrders->ord[i][ord],true);
+        textCache[i]=getPatTextCache(patCache[i]);
       }
-      for (int i=0; i<e->curSubSong->patLen; i++) {
-        patternRow(i,e->isPlaying(),lineHeight,chans,ord,patCache,false);
-      }
-      // next pattern
-      ImGui::BeginDisabled();
-      if (settings.viewPrevPattern) {
-        if ((ord+1)<e->curSubSong->ordersLen) for (int i=0; i<chans; i++) {
-          patCache[i]=e->curPat[i].getPattern(e->curOrders->ord[i][ord+1],true);
+
+      ImGui::PushStyleVar(ImGuiStyleVar_FrameShading,0.0f);
+      ImGuiListClipper rowClipper;
+      rowClipper.Begin(prevRows+patLen+nextRows);
+      while (rowClipper.Step()) {
+        // previous pattern
+        int rowStart=rowClipper.DisplayStart;
+        int rowEnd=MIN(rowClipper.DisplayEnd,prevRows);
+        if (rowStart<rowEnd) {
+          ImGui::BeginDisabled();
+          for (int i=rowStart; i<rowEnd; i++) {
+            if (settings.viewPrevPattern) {
+              patternRow(patLen+i-prevRows,e->isPlaying(),lineHeight,chans,ord-1,prevPatCache,prevTextCache,true);
+            } else {
+              ImGui::TableNextRow(0,lineHeight);
+              ImGui::TableNextColumn();
+            }
+          }
+          ImGui::EndDisabled();
         }
-        for (int i=0; i<=dummyRows; i++) {
-          patternRow(i,e->isPlaying(),lineHeight,chans,ord+1,patCache,true);
+        // active area
+        rowStart=MAX(rowClipper.DisplayStart,prevRows);
+        rowEnd=MIN(rowClipper.DisplayEnd,prevRows+patLen);
+        for (int i=rowStart; i<rowEnd; i++) {
+          patternRow(i-prevRows,e->isPlaying(),lineHeight,chans,ord,patCache,textCache,false);
         }
-      } else {
-        for (int i=0; i<=dummyRows; i++) {
-          ImGui::TableNextRow(0,lineHeight);
-          ImGui::TableNextColumn();
+        // next pattern
+        rowStart=MAX(rowClipper.DisplayStart,prevRows+patLen);
+        rowEnd=rowClipper.DisplayEnd;
+        if (rowStart<rowEnd) {
+          ImGui::BeginDisabled();
+          for (int i=rowStart; i<rowEnd; i++) {
+            if (settings.viewPrevPattern) {
+              patternRow(i-prevRows-patLen,e->isPlaying(),lineHeight,chans,ord+1,nextPatCache,nextTextCache,true);
+            } else {
+              ImGui::TableNextRow(0,lineHeight);
+              ImGui::TableNextColumn();
+            }
+          }
+          ImGui::EndDisabled();
         }
       }
-
-      ImGui::EndDisabled();
       ImGui::PopStyleVar();
+
       if (demandScrollX) {
-        float finalX=-fourChars.x;
         // manually calculate X scroll
-        for (int i=0; i<=cursor.xCoarse; i++) {
-          int fine=(i==cursor.xCoarse)?cursor.xFine:9999;
-          if (!e->curSubSong->chanShow[i]) continue;
-
+        float finalX=patChanOffX[cursor.xCoarse];
+        int fine=cursor.xFine;
+        int collapse=e->curSubSong->chanCollapse[cursor.xCoarse];
+        if (e->curSubSong->chanShow[cursor.xCoarse]) {
           finalX+=noteCellSize.x;
           // ins
-          if (fine==0) break;
-          if (e->curSubSong->chanCollapse[i]<3) {
-            finalX+=insCellSize.x;
-          }
+          if (fine>0 && collapse<3) finalX+=insCellSize.x;
           // vol
-          if (fine==1) break;
-          if (e->curSubSong->chanCollapse[i]<2) {
-            finalX+=volCellSize.x;
-          }
+          if (fine>1 && collapse<2) finalX+=volCellSize.x;
           // effects
-          if (fine==2) break;
-          if (e->curSubSong->chanCollapse[i]<1) {
-            for (int j=0; j<MIN(fine-2,e->curPat[i].effectCols*2); j++) {
-              if (j&1) {
-                finalX+=effectValCellSize.x;
-              } else {
-                finalX+=effectCellSize.x;
-              }
-            }
+          if (fine>2 && collapse<1) {
+            int effectCells=MIN(fine-2,e->curPat[cursor.xCoarse].effectCols*2);
+            finalX+=effectCellSize.x*((effectCells+1)>>1)+effectValCellSize.x*(effectCells>>1);
           }
         }
         float totalDemand=finalX-ImGui::GetScrollX();
@@ -1029,6 +1029,7 @@ void FurnaceGUI::drawSampleEdit() {
               }
             }
 
+            sample->invalidateMipmap(start,end);
             updateSampleTex=true;
 
             e->renderSamples(curSample);
@@ -1244,6 +1245,7 @@ void FurnaceGUI::drawSampleEdit() {
               }
             }
 
+            sample->invalidateMipmap(start,end);
             updateSampleTex=true;
 
             e->renderSamples(curSample);
@@ -1314,6 +1316,7 @@ void FurnaceGUI::drawSampleEdit() {
                   crossFadeOutput++;
                 }
               }
+              sample->invalidateMipmap(sample->loopEnd-sampleCrossFadeLoopLength,sample->loopEnd);
               updateSampleTex=true;
 
               e->renderSamples(curSample);
@@ -1559,32 +1562,16 @@ void FurnaceGUI::drawSampleEdit() {
               int y1, y2;
               int candMin=INT_MAX;
               int candMax=INT_MIN;
-              int totalAdvance=0;
-              if (sample->depth==DIV_SAMPLE_DEPTH_8BIT) {
-                if (candMin>sample->data8[xCoarse]) candMin=sample->data8[xCoarse];
-                if (candMax<sample->data8[xCoarse]) candMax=sample->data8[xCoarse];
-              } else {
-                if (candMin>sample->data16[xCoarse]) candMin=sample->data16[xCoarse];
-                if (candMax<sample->data16[xCoarse]) candMax=sample->data16[xCoarse];
-              }
+              unsigned int totalAdvance=0;
               xFine+=xAdvanceFine;
               if (xFine>=16777216) {
                 xFine-=16777216;
                 totalAdvance++;
               }
               totalAdvance+=xAdvanceCoarse;
-              if (xCoarse>=sample->samples) break;
-              do {
-                if (xCoarse>=sample->samples) break;
-                if (sample->depth==DIV_SAMPLE_DEPTH_8BIT) {
-                  if (candMin>sample->data8[xCoarse]) candMin=sample->data8[xCoarse];
-                  if (candMax<sample->data8[xCoarse]) candMax=sample->data8[xCoarse];
-                } else {
-                  if (candMin>sample->data16[xCoarse]) candMin=sample->data16[xCoarse];
-                  if (candMax<sample->data16[xCoarse]) candMax=sample->data16[xCoarse];
-                }
-                if (totalAdvance>0) xCoarse++;
-              } while ((totalAdvance--)>0);
+              // each column covers xCoarse to xCoarse+totalAdvance (inclusive)
+              if (!sample->getMinMax(xCoarse,xCoarse+totalAdvance+1,candMin,candMax)) break;
+              xCoarse+=totalAdvance;
               if (sample->depth==DIV_SAMPLE_DEPTH_8BIT) {
                 y1=(((unsigned char)candMin^0x80)*availY)>>8;
                 y2=(((unsigned char)candMax^0x80)*availY)>>8;
@@ -162,7 +162,9 @@ const char* nesCores[]={
 const char* c64Cores[]={
   "reSID",
   "reSIDfp",
-  "dSID"
+  "dSID",
+  _N("reSID (block clocked)"),
+  _N("reSIDfp (block clocked)")
 };
 
 const char* pokeyCores[]={
@@ -1430,9 +1432,27 @@ void FurnaceGUI::drawSettings() {
               }
             }
             popWarningColor();
+
+            bool renderPoolLockFreeB=settings.renderPoolLockFree;
+            if (ImGui::Checkbox(_("Lock-free work pool"),&renderPoolLockFreeB)) {
+              settings.renderPoolLockFree=renderPoolLockFreeB;
+              settingsChanged=true;
+            }
+            if (ImGui::IsItemHovered()) {
+              ImGui::SetTooltip(_("uses a work pool which busy-waits for a short while instead of sleeping between ticks.\nlowers the cost of waiting for chips to finish, at the expense of some CPU usage."));
+            }
           }
         }
 
+        bool renderPerBufferB=settings.renderPerBuffer;
+        if (ImGui::Checkbox(_("Render chips once per buffer"),&renderPerBufferB)) {
+          settings.renderPerBuffer=renderPerBufferB;
+          settingsChanged=true;
+        }
+        if (ImGui::IsItemHovered()) {
+          ImGui::SetTooltip(_("renders supported chips (currently only C64) in one go after all ticks in a buffer, rather than between ticks.\nregister writes keep their timing, so the output is the same."));
+        }
+
         bool lowLatencyB=settings.lowLatency;
         if (ImGui::Checkbox(_("Low-latency mode"),&lowLatencyB)) {
           settings.lowLatency=lowLatencyB;
@@ -1442,6 +1462,24 @@ void FurnaceGUI::drawSettings() {
           ImGui::SetTooltip(_("reduces latency by running the engine faster than the tick rate.\nuseful for live playback/jam mode.\n\nwarning: only enable if your buffer size is small (10ms or less)."));
         }
 
+        if (ImGui::InputInt(_("Seek keyframe interval"),&settings.seekKeyframeInterval)) {
+          if (settings.seekKeyframeInterval<0) settings.seekKeyframeInterval=0;
+          if (settings.seekKeyframeInterval>256) settings.seekKeyframeInterval=256;
+          settingsChanged=true;
+        }
+        if (ImGui::IsItemHovered()) {
+          ImGui::SetTooltip(_("saves playback state every this many orders, so that playing from the middle of a song does not have to go through the entire song again.\nset to 0 to disable."));
+        }
+
+        if (ImGui::InputInt(_("Sample render cache size (MB)"),&settings.sampleCacheSize)) {
+          if (settings.sampleCacheSize<0) settings.sampleCacheSize=0;
+          if (settings.sampleCacheSize>4096) settings.sampleCacheSize=4096;
+          settingsChanged=true;
+        }
+        if (ImGui::IsItemHovered()) {
+          ImGui::SetTooltip(_("keeps encoded sample data (BRR, ADPCM and so on) in memory, so that loading a song again or undoing a sample edit does not have to encode samples again.\nset to 0 to disable."));
+        }
+
         bool forceMonoB=settings.forceMono;
         if (ImGui::Checkbox(_("Force mono audio"),&forceMonoB)) {
           settings.forceMono=forceMonoB;
@@ -1475,6 +1513,17 @@ void FurnaceGUI::drawSettings() {
         ImGui::Text(_("Quality"));
         ImGui::SameLine();
         if (ImGui::Combo("##Quality",&settings.audioQuality,LocalizedComboGetter,audioQualities,2)) settingsChanged=true;
+
+        ImGui::BeginDisabled(settings.audioQuality!=0);
+        bool audioSIMDB=settings.audioSIMD;
+        if (ImGui::Checkbox(_("Vectorized band-limited synthesis"),&audioSIMDB)) {
+          settings.audioSIMD=audioSIMDB;
+          settingsChanged=true;
+        }
+        ImGui::EndDisabled();
+        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+          ImGui::SetTooltip(_("uses SIMD instructions to speed up mixing in high quality mode.\nthe output is the same.\nSIMD support: %s"),blip_simd_name());
+        }
         
         bool clampSamplesB=settings.clampSamples;
         if (ImGui::Checkbox(_("Software clipping"),&clampSamplesB)) {
@@ -1973,10 +2022,10 @@ void FurnaceGUI::drawSettings() {
           ImGui::Text("SID");
           ImGui::TableNextColumn();
           ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-          if (ImGui::Combo("##C64Core",&settings.c64Core,c64Cores,3)) settingsChanged=true;
+          if (ImGui::Combo("##C64Core",&settings.c64Core,LocalizedComboGetter,c64Cores,5)) settingsChanged=true;
           ImGui::TableNextColumn();
           ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-          if (ImGui::Combo("##C64CoreRender",&settings.c64CoreRender,c64Cores,3)) settingsChanged=true;
+          if (ImGui::Combo("##C64CoreRender",&settings.c64CoreRender,LocalizedComboGetter,c64Cores,5)) settingsChanged=true;
 
           ImGui::TableNextRow();
           ImGui::TableNextColumn();
@@ -4684,6 +4733,10 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
 
     settings.chanOscThreads=conf.getInt("chanOscThreads",0);
     settings.renderPoolThreads=conf.getInt("renderPoolThreads",0);
+    settings.renderPoolLockFree=conf.getInt("renderPoolLockFree",0);
+    settings.renderPerBuffer=conf.getInt("renderPerBuffer",0);
+    settings.seekKeyframeInterval=conf.getInt("seekKeyframeInterval",4);
+    settings.sampleCacheSize=conf.getInt("sampleCacheSize",64);
     settings.shaderOsc=conf.getInt("shaderOsc",0);
     settings.showPool=conf.getInt("showPool",0);
     settings.writeInsNames=conf.getInt("writeInsNames",0);
@@ -4743,6 +4796,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     settings.sdlAudioDriver=conf.getString("sdlAudioDriver","");
     settings.audioQuality=conf.getInt("audioQuality",0);
     settings.audioHiPass=conf.getInt("audioHiPass",1);
+    settings.audioSIMD=conf.getInt("audioSIMD",1);
     settings.audioBufSize=conf.getInt("audioBufSize",1024);
     settings.audioRate=conf.getInt("audioRate",44100);
     settings.audioChans=conf.getInt("audioChans",2);
@@ -5015,6 +5069,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.audioEngine,0,2);
   clampSetting(settings.audioQuality,0,1);
   clampSetting(settings.audioHiPass,0,1);
+  clampSetting(settings.audioSIMD,0,1);
   clampSetting(settings.audioBufSize,32,4096);
   clampSetting(settings.audioRate,8000,384000);
   clampSetting(settings.audioChans,1,16);
@@ -5023,7 +5078,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.snCore,0,1);
   clampSetting(settings.nesCore,0,1);
   clampSetting(settings.fdsCore,0,1);
-  clampSetting(settings.c64Core,0,2);
+  clampSetting(settings.c64Core,0,4);
   clampSetting(settings.pokeyCore,0,1);
   clampSetting(settings.opn1Core,0,2);
   clampSetting(settings.opnaCore,0,2);
@@ -5049,7 +5104,7 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.snCoreRender,0,1);
   clampSetting(settings.nesCoreRender,0,1);
   clampSetting(settings.fdsCoreRender,0,1);
-  clampSetting(settings.c64CoreRender,0,2);
+  clampSetting(settings.c64CoreRender,0,4);
   clampSetting(settings.pokeyCoreRender,0,1);
   clampSetting(settings.opn1CoreRender,0,2);
   clampSetting(settings.opnaCoreRender,0,2);
@@ -5199,6 +5254,10 @@ void FurnaceGUI::readConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
   clampSetting(settings.wasapiEx,0,1);
   clampSetting(settings.chanOscThreads,0,256);
   clampSetting(settings.renderPoolThreads,0,DIV_MAX_CHIPS);
+  clampSetting(settings.renderPoolLockFree,0,1);
+  clampSetting(settings.renderPerBuffer,0,1);
+  clampSetting(settings.seekKeyframeInterval,0,256);
+  clampSetting(settings.sampleCacheSize,0,4096);
   clampSetting(settings.showPool,0,1);
   clampSetting(settings.writeInsNames,0,1);
   clampSetting(settings.readInsNames,0,1);
@@ -5268,6 +5327,10 @@ void FurnaceGUI::writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
 
     conf.set("chanOscThreads",settings.chanOscThreads);
     conf.set("renderPoolThreads",settings.renderPoolThreads);
+    conf.set("renderPoolLockFree",settings.renderPoolLockFree);
+    conf.set("renderPerBuffer",settings.renderPerBuffer);
+    conf.set("seekKeyframeInterval",settings.seekKeyframeInterval);
+    conf.set("sampleCacheSize",settings.sampleCacheSize);
     conf.set("shaderOsc",settings.shaderOsc);
     conf.set("showPool",settings.showPool);
     conf.set("writeInsNames",settings.writeInsNames);
@@ -5321,6 +5384,7 @@ void FurnaceGUI::writeConfig(DivConfig& conf, FurnaceGUISettingGroups groups) {
     conf.set("sdlAudioDriver",settings.sdlAudioDriver);
     conf.set("audioQuality",settings.audioQuality);
     conf.set("audioHiPass",settings.audioHiPass);
+    conf.set("audioSIMD",settings.audioSIMD);
     conf.set("audioBufSize",settings.audioBufSize);
     conf.set("audioRate",settings.audioRate);
     conf.set("audioChans",settings.audioChans);
@@ -5649,7 +5713,8 @@ void FurnaceGUI::commitSettings() {
     settings.swanQuality!=e->getConfInt("swanQuality",3) ||
     settings.vbQuality!=e->getConfInt("vbQuality",3) ||
     settings.audioQuality!=e->getConfInt("audioQuality",0) ||
-    settings.audioHiPass!=e->getConfInt("audioHiPass",1)
+    settings.audioHiPass!=e->getConfInt("audioHiPass",1) ||
+    settings.audioSIMD!=e->getConfInt("audioSIMD",1)
   );
 
   writeConfig(e->getConfObject());
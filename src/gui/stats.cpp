@@ -27,6 +27,8 @@ void FurnaceGUI::drawStats() {
     ImGui::SetNextWindowFocus();
     nextWindow=GUI_WINDOW_NOTHING;
   }
+  // the profiler only runs while this window is open
+  e->profiler.enable(statsOpen);
   if (!statsOpen) return;
   if (ImGui::Begin("Statistics",&statsOpen,globalWinFlags,_("Statistics"))) {
     size_t lastProcTime=e->processTime;
@@ -36,6 +38,57 @@ void FurnaceGUI::drawStats() {
     ImGui::Text(_("Audio load"));
     ImGui::SameLine();
     ImGui::ProgressBar((double)lastProcTime/maxGot,ImVec2(-FLT_MIN,0),procStr.c_str());
+
+    DivProfileSummary prof=e->profiler.summarize();
+    if (prof.frames>0 && ImGui::BeginTable("ProfileTable",7,ImGuiTableFlags_Borders|ImGuiTableFlags_SizingStretchSame)) {
+      double budget=1000000000.0*prof.size/(double)e->getAudioDescGot().rate;
+      ImGui::TableSetupColumn("c0",ImGuiTableColumnFlags_WidthStretch,2.5f);
+
+      ImGui::TableNextRow(ImGuiTableRowFlags_Headers);
+      ImGui::TableNextColumn();
+      ImGui::Text(_("Stage (µs)"));
+      ImGui::TableNextColumn();
+      ImGui::Text(_("min"));
+      ImGui::TableNextColumn();
+      ImGui::Text(_("avg"));
+      ImGui::TableNextColumn();
+      ImGui::Text(_("max"));
+      ImGui::TableNextColumn();
+      ImGui::Text("95%%");
+      ImGui::TableNextColumn();
+      ImGui::Text("99%%");
+      ImGui::TableNextColumn();
+      ImGui::Text(_("load"));
+
+      auto drawRow=[budget](const char* name, const DivProfileStats& st) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f",st.min/1000.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f",st.avg/1000.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f",st.max/1000.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f",st.p95/1000.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f",st.p99/1000.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f%%",(budget>0)?(100.0*st.avg/budget):0.0);
+      };
+
+      for (int i=0; i<DIV_PROFILE_STAGE_MAX; i++) {
+        drawRow(_(DivProfiler::stageName(i)),prof.stage[i]);
+      }
+      for (int i=0; i<prof.chips && i<e->song.systemLen; i++) {
+        String chipName=fmt::sprintf(_("%d. %s (emulation)"),i+1,e->getSystemName(e->song.system[i]));
+        drawRow(chipName.c_str(),prof.chipAcquire[i]);
+        chipName=fmt::sprintf(_("%d. %s (buffer fill)"),i+1,e->getSystemName(e->song.system[i]));
+        drawRow(chipName.c_str(),prof.chipFillBuf[i]);
+      }
+      ImGui::EndTable();
+    }
   }
   if (ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows)) curWindow=GUI_WINDOW_STATS;
   ImGui::End();
@@ -70,6 +70,7 @@ struct sigaction termsa;
 #endif
 
 #include "cli/cli.h"
+#include "cli/batch.h"
 
 #ifdef HAVE_GUI
 #include "gui/gui.h"
@@ -87,6 +88,8 @@ String outName;
 String vgmOutName;
 String zsmOutName;
 String cmdOutName;
+String batchName;
+int batchJobs=0;
 int benchMode=0;
 int subsong=-1;
 DivAudioExportOptions exportOptions;
@@ -108,6 +111,7 @@ bool safeMode=false;
 bool safeModeWithAudio=false;
 
 bool infoMode=false;
+bool profileMode=false;
 
 std::vector<TAParam> params;
 
@@ -407,6 +411,34 @@ TAParamResult pBenchmark(String val) {
   return TA_PARAM_SUCCESS;
 }
 
+TAParamResult pProfile(String val) {
+  profileMode=true;
+  return TA_PARAM_SUCCESS;
+}
+
+TAParamResult pBatch(String val) {
+  batchName=val;
+  // stdout is used for the report
+  changeLogOutput(stderr);
+  e.setAudio(DIV_AUDIO_DUMMY);
+  return TA_PARAM_SUCCESS;
+}
+
+TAParamResult pBatchJobs(String val) {
+  try {
+    int v=std::stoi(val);
+    if (v<0) {
+      logE("job count shall be 0 or higher.");
+      return TA_PARAM_ERROR;
+    }
+    batchJobs=v;
+  } catch (std::exception& e) {
+    logE("job count shall be a number.");
+    return TA_PARAM_ERROR;
+  }
+  return TA_PARAM_SUCCESS;
+}
+
 TAParamResult pOutput(String val) {
   outName=val;
   e.setAudio(DIV_AUDIO_DUMMY);
@@ -449,6 +481,8 @@ void initParams() {
   params.push_back(TAParam("D","direct",false,pDirect,"","set VGM export direct stream mode"));
   params.push_back(TAParam("Z","zsmout",true,pZSMOut,"<filename>","output .zsm data for Commander X16 Zsound"));
   params.push_back(TAParam("C","cmdout",true,pCmdOut,"<filename>","output command stream"));
+  params.push_back(TAParam("b","batch",true,pBatch,"<filename>","render the songs in a manifest to audio files (one JSON result per line)"));
+  params.push_back(TAParam("j","batchjobs",true,pBatchJobs,"<count>","set number of songs to render at once in batch mode (0 for one per CPU core)"));
   params.push_back(TAParam("L","loglevel",true,pLogLevel,"debug|info|warning|error","set the log level (info by default)"));
   params.push_back(TAParam("v","view",true,pView,"pattern|commands|nothing","set visualization (nothing by default)"));
   params.push_back(TAParam("i","info",false,pInfo,"","get info about a song"));
@@ -463,11 +497,34 @@ void initParams() {
   params.push_back(TAParam("A","safeaudio",false,pSafeModeAudio,"","enable safe mode (with audio"));
 
   params.push_back(TAParam("B","benchmark",true,pBenchmark,"render|seek","run performance test"));
+  params.push_back(TAParam("P","profile",false,pProfile,"","print audio processing time of every stage and chip on exit"));
 
   params.push_back(TAParam("V","version",false,pVersion,"","view information about Furnace."));
   params.push_back(TAParam("W","warranty",false,pWarranty,"","view warranty disclaimer."));
 }
 
+void printProfile() {
+  if (!profileMode) return;
+  DivProfileSummary prof=e.profiler.summarize();
+  if (prof.frames==0) {
+    printf("no profile data.\n");
+    return;
+  }
+  printf("profile of the last %d buffers (average size: %.0f samples, times in µs):\n",(int)prof.frames,prof.size);
+  printf("%-40s %9s %9s %9s %9s %9s\n","stage","min","avg","max","95%","99%");
+  auto printRow=[](const char* name, const DivProfileStats& st) {
+    printf("%-40s %9.1f %9.1f %9.1f %9.1f %9.1f\n",name,st.min/1000.0,st.avg/1000.0,st.max/1000.0,st.p95/1000.0,st.p99/1000.0);
+  };
+  for (int i=0; i<DIV_PROFILE_STAGE_MAX; i++) {
+    printRow(DivProfiler::stageName(i),prof.stage[i]);
+  }
+  for (int i=0; i<prof.chips && i<e.song.systemLen; i++) {
+    String chipName=fmt::sprintf("%d. %s",i+1,e.getSystemName(e.song.system[i]));
+    printRow((chipName+" (emulation)").c_str(),prof.chipAcquire[i]);
+    printRow((chipName+" (buffer fill)").c_str(),prof.chipFillBuf[i]);
+  }
+}
+
 #ifdef _WIN32
 void reportError(String what) {
   logE("%s",what);
@@ -544,6 +601,7 @@ int main(int argc, char** argv) {
   vgmOutName="";
   zsmOutName="";
   cmdOutName="";
+  batchName="";
 
   // load config for locale
   e.prePreInit();
@@ -698,7 +756,7 @@ int main(int argc, char** argv) {
   }
 #endif
 
-  if (fileName.empty() && consoleMode) {
+  if (fileName.empty() && consoleMode && batchName=="") {
     logI("usage: %s file",argv[0]);
     return 1;
   }
@@ -709,8 +767,8 @@ int main(int argc, char** argv) {
   }
 
 #ifdef HAVE_GUI
-  if (e.preInit(consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="")) {
-    if (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="") {
+  if (e.preInit(consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="" || batchName!="")) {
+    if (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="" || batchName!="") {
       logW("engine wants safe mode, but Furnace GUI is not going to start.");
     } else {
       safeMode=true;
@@ -722,11 +780,23 @@ int main(int argc, char** argv) {
   }
 #endif
 
-  if (safeMode && (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="")) {
+  if (safeMode && (consoleMode || benchMode || infoMode || outName!="" || vgmOutName!="" || cmdOutName!="" || batchName!="")) {
     logE("you can't use safe mode and console/export mode together.");
     return 1;
   }
 
+  if (batchName!="") {
+    FurnaceBatch batch;
+    batch.bindEngine(&e);
+    if (!batch.loadManifest(batchName.c_str())) {
+      finishLogFile();
+      return 1;
+    }
+    bool batchOK=batch.run(batchJobs,exportOptions,subsong);
+    finishLogFile();
+    return batchOK?0:1;
+  }
+
   if (safeMode && !safeModeWithAudio) {
     e.setAudio(DIV_AUDIO_DUMMY);
   }
@@ -812,6 +882,10 @@ int main(int argc, char** argv) {
     e.changeSongP(subsong);
   }
 
+  if (profileMode) {
+    e.profiler.enable(true);
+  }
+
   if (benchMode) {
     logI("starting benchmark!");
     if (benchMode==2) {
@@ -819,6 +893,7 @@ int main(int argc, char** argv) {
     } else {
       e.benchmarkPlayback();
     }
+    printProfile();
     finishLogFile();
     return 0;
   }
@@ -861,6 +936,7 @@ int main(int argc, char** argv) {
       e.saveAudio(outName.c_str(),exportOptions);
       e.waitAudioFile();
     }
+    printProfile();
     finishLogFile();
     return 0;
   }
@@ -885,6 +961,7 @@ int main(int argc, char** argv) {
       cli.loop();
       cli.finish();
       e.quit();
+      printProfile();
       finishLogFile();
       return 0;
     } else {
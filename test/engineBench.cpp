@@ -0,0 +1,553 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// benchmark suite for the engine.
+// measures:
+// - band-limited synthesis (blip_add_samples() against blip_add_delta()), which
+//   must produce identical output
+// - every chip core variant and core quality level (a note is played on each channel),
+//   with and without writing to the oscilloscope buffers
+// - for every song given: playback render, sample rendering, .fur load/save,
+//   VGM/ZSM/command stream export
+//   (sample rendering is measured from scratch, from the render cache and with no
+//   changes. rendered data must be identical to a serial render in all cases)
+// the results are written to stdout as JSON. realtime factor is seconds of
+// audio (or song length for exports) divided by the time it took.
+// usage: furnace-bench [-seconds <n>] [-iterations <n>] [-filter <text>] [-nochips] [songs...]
+// note that your Furnace configuration is loaded (other than the settings being tested).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "../src/engine/engine.h"
+#include "../src/engine/blip_buf.h"
+#include "../src/ta-log.h"
+
+#define BENCH_BUFSIZE 1024
+
+typedef std::chrono::steady_clock benchClock;
+
+// a config setting which selects the core (or its quality) of one or more systems
+struct BenchSetting {
+  const char* key;
+  int count;
+  // setting which must be set for this one to have an effect
+  const char* baseKey;
+  int baseValue;
+  DivSystem systems[8];
+};
+
+// see DivDispatchContainer::init()
+static const BenchSetting benchSettings[]={
+  {"ym2612Core",3,NULL,0,{DIV_SYSTEM_YM2612,DIV_SYSTEM_YM2612_EXT,DIV_SYSTEM_YM2612_CSM,DIV_SYSTEM_YM2612_DUALPCM,DIV_SYSTEM_YM2612_DUALPCM_EXT,DIV_SYSTEM_NULL}},
+  {"snCore",2,NULL,0,{DIV_SYSTEM_SMS,DIV_SYSTEM_NULL}},
+  {"nesCore",2,NULL,0,{DIV_SYSTEM_NES,DIV_SYSTEM_5E01,DIV_SYSTEM_NULL}},
+  {"fdsCore",2,NULL,0,{DIV_SYSTEM_FDS,DIV_SYSTEM_NULL}},
+  {"c64Core",5,NULL,0,{DIV_SYSTEM_C64_6581,DIV_SYSTEM_C64_8580,DIV_SYSTEM_NULL}},
+  {"arcadeCore",2,NULL,0,{DIV_SYSTEM_YM2151,DIV_SYSTEM_NULL}},
+  {"opn1Core",3,NULL,0,{DIV_SYSTEM_YM2203,DIV_SYSTEM_YM2203_EXT,DIV_SYSTEM_NULL}},
+  {"opnaCore",3,NULL,0,{DIV_SYSTEM_YM2608,DIV_SYSTEM_YM2608_EXT,DIV_SYSTEM_NULL}},
+  {"opnbCore",3,NULL,0,{DIV_SYSTEM_YM2610,DIV_SYSTEM_YM2610_FULL,DIV_SYSTEM_YM2610_EXT,DIV_SYSTEM_YM2610_FULL_EXT,DIV_SYSTEM_YM2610B,DIV_SYSTEM_YM2610B_EXT,DIV_SYSTEM_NULL}},
+  {"ayCore",2,NULL,0,{DIV_SYSTEM_AY8910,DIV_SYSTEM_NULL}},
+  {"opllCore",2,NULL,0,{DIV_SYSTEM_OPLL,DIV_SYSTEM_OPLL_DRUMS,DIV_SYSTEM_VRC7,DIV_SYSTEM_NULL}},
+  {"opl2Core",3,NULL,0,{DIV_SYSTEM_OPL,DIV_SYSTEM_OPL_DRUMS,DIV_SYSTEM_OPL2,DIV_SYSTEM_OPL2_DRUMS,DIV_SYSTEM_Y8950,DIV_SYSTEM_Y8950_DRUMS,DIV_SYSTEM_NULL}},
+  {"opl3Core",3,NULL,0,{DIV_SYSTEM_OPL3,DIV_SYSTEM_OPL3_DRUMS,DIV_SYSTEM_NULL}},
+  {"esfmCore",2,NULL,0,{DIV_SYSTEM_ESFM,DIV_SYSTEM_NULL}},
+  {"pokeyCore",2,NULL,0,{DIV_SYSTEM_POKEY,DIV_SYSTEM_NULL}},
+  {"gbQuality",6,NULL,0,{DIV_SYSTEM_GB,DIV_SYSTEM_NULL}},
+  {"pceQuality",6,NULL,0,{DIV_SYSTEM_PCE,DIV_SYSTEM_NULL}},
+  {"dsidQuality",6,"c64Core",2,{DIV_SYSTEM_C64_6581,DIV_SYSTEM_C64_8580,DIV_SYSTEM_NULL}},
+  {"saaQuality",6,NULL,0,{DIV_SYSTEM_SAA1099,DIV_SYSTEM_NULL}},
+  {"swanQuality",6,NULL,0,{DIV_SYSTEM_SWAN,DIV_SYSTEM_NULL}},
+  {"vbQuality",6,NULL,0,{DIV_SYSTEM_VBOY,DIV_SYSTEM_NULL}},
+  {"bubsysQuality",6,NULL,0,{DIV_SYSTEM_BUBSYS_WSG,DIV_SYSTEM_NULL}},
+  {"sccQuality",6,NULL,0,{DIV_SYSTEM_SCC,DIV_SYSTEM_SCC_PLUS,DIV_SYSTEM_NULL}},
+  {"smQuality",6,NULL,0,{DIV_SYSTEM_SM8521,DIV_SYSTEM_NULL}},
+  {"pnQuality",6,NULL,0,{DIV_SYSTEM_POWERNOISE,DIV_SYSTEM_NULL}},
+  {"ndsQuality",6,NULL,0,{DIV_SYSTEM_NDS,DIV_SYSTEM_NULL}},
+  {NULL,0,NULL,0,{DIV_SYSTEM_NULL}}
+};
+
+static DivEngine e;
+static float benchSeconds=1.0f;
+static int benchIterations=3;
+static String benchFilter;
+static bool benchChipsEnabled=true;
+static bool firstResult=true;
+static bool blipMismatch=false;
+static bool sampleMismatch=false;
+
+void reportError(String what) {
+  logE("%s",what);
+}
+
+static double elapsed(benchClock::time_point start) {
+  return std::chrono::duration<double>(benchClock::now()-start).count();
+}
+
+static String jsonString(const String& s) {
+  String ret="\"";
+  for (char i: s) {
+    if (i=='"' || i=='\\') {
+      ret+='\\';
+      ret+=i;
+    } else if ((unsigned char)i<0x20) {
+      ret+=fmt::sprintf("\\u%.4x",(int)i);
+    } else {
+      ret+=i;
+    }
+  }
+  ret+="\"";
+  return ret;
+}
+
+static void beginResult() {
+  if (!firstResult) printf(",\n");
+  firstResult=false;
+  printf("    ");
+}
+
+static void renderFor(double seconds, double rate) {
+  float bufL[BENCH_BUFSIZE];
+  float bufR[BENCH_BUFSIZE];
+  float* outBuf[2]={bufL,bufR};
+  size_t total=seconds*rate;
+  for (size_t i=0; i<total; i+=BENCH_BUFSIZE) {
+    e.nextBuf(NULL,outBuf,0,2,BENCH_BUFSIZE);
+  }
+}
+
+// input patterns for the band-limited synthesis benchmark
+enum BenchBlipPattern {
+  BENCH_BLIP_NOISE=0,
+  BENCH_BLIP_SQUARE,
+  BENCH_BLIP_SPARSE,
+
+  BENCH_BLIP_MAX
+};
+
+static const char* benchBlipPatternNames[BENCH_BLIP_MAX]={
+  "noise", "square", "sparse"
+};
+
+// run the given input through blip_buf with blip_add_delta() (one call per change)
+// or blip_add_samples(). returns the time taken and stores the output in out.
+static double runBlip(const std::vector<short>& in, double rate, int frames, bool bulk, std::vector<short>& out) {
+  blip_buffer_t* bb=blip_new(65536);
+  blip_set_rates(bb,rate,44100);
+  out.clear();
+  short outBuf[65536];
+  size_t len=in.size()/frames;
+  int temp=0;
+  int prevSample=0;
+
+  benchClock::time_point start=benchClock::now();
+  for (int i=0; i<frames; i++) {
+    const short* frame=in.data()+i*len;
+    if (bulk) {
+      blip_add_samples(bb,frame,len,&temp,&prevSample);
+    } else {
+      for (size_t j=0; j<len; j++) {
+        if (frame[j]==temp) continue;
+        temp=frame[j];
+        blip_add_delta(bb,j,temp-prevSample);
+        prevSample=temp;
+      }
+    }
+    blip_end_frame(bb,len);
+    int got=blip_read_samples(bb,outBuf,65536,0);
+    out.insert(out.end(),outBuf,outBuf+got);
+  }
+  double ret=elapsed(start);
+
+  blip_delete(bb);
+  return ret;
+}
+
+static void benchBlip() {
+  const double rates[]={44100.0, 1789773.0, 3579545.0};
+  std::vector<short> in;
+  std::vector<short> outDelta, outSamples;
+
+  for (double rate: rates) {
+    // 1024 output samples per frame
+    size_t len=(size_t)(rate*1024.0/44100.0);
+    int frames=MAX(1,(int)(benchSeconds*44100.0/1024.0));
+    for (int p=0; p<BENCH_BLIP_MAX; p++) {
+      in.resize(len*frames);
+      srand(p);
+      short val=0;
+      for (size_t i=0; i<in.size(); i++) {
+        switch (p) {
+          case BENCH_BLIP_NOISE:
+            val=(rand()&0xffff)-0x8000;
+            break;
+          case BENCH_BLIP_SQUARE:
+            val=((i/37)&1)?8191:-8192;
+            break;
+          case BENCH_BLIP_SPARSE:
+            if ((rand()%200)==0) val=(rand()&0x3fff)-0x2000;
+            break;
+        }
+        in[i]=val;
+      }
+
+      double deltaTime=1e9;
+      double samplesTime=1e9;
+      for (int i=0; i<benchIterations; i++) {
+        deltaTime=MIN(deltaTime,runBlip(in,rate,frames,false,outDelta));
+        samplesTime=MIN(samplesTime,runBlip(in,rate,frames,true,outSamples));
+      }
+      bool match=(outDelta==outSamples);
+      if (!match) {
+        logE("blip_add_samples() output differs from blip_add_delta()! (%s, %.0fHz)",benchBlipPatternNames[p],rate);
+        blipMismatch=true;
+      }
+
+      beginResult();
+      printf("{\"pattern\": \"%s\", \"rate\": %.0f, \"simd\": \"%s\", \"match\": %s, \"deltaNsPerInput\": %.3f, \"samplesNsPerInput\": %.3f}",
+        benchBlipPatternNames[p],
+        rate,
+        blip_simd_name(),
+        match?"true":"false",
+        deltaTime*1000000000.0/in.size(),
+        samplesTime*1000000000.0/in.size()
+      );
+      fflush(stdout);
+    }
+  }
+}
+
+// play one note per channel on a new song with only this chip and time it.
+// returns the time taken and stores the output rate in rate.
+static double runChip(DivSystem sys, bool osc, double& rate) {
+  DivConfig desc;
+  desc.set("id0",(int)DivEngine::systemToFileFur(sys));
+  e.createNew(desc.toString().c_str(),"",false);
+  e.setOscBuffersEnabled(osc);
+  rate=e.getAudioDescGot().rate;
+
+  for (int i=0; i<e.getTotalChannelCount(); i++) {
+    int ins=e.addInstrument(i);
+    e.noteOn(i,ins,48+((i*5)%12));
+  }
+  renderFor(0.1,rate);
+
+  benchClock::time_point start=benchClock::now();
+  renderFor(benchSeconds,rate);
+  double t=elapsed(start);
+  e.stop();
+  e.setOscBuffersEnabled(true);
+  return t;
+}
+
+static void benchChip(DivSystem sys, const char* key, int value) {
+  const DivSysDef* def=e.getSystemDef(sys);
+  double rate=0;
+  double t=runChip(sys,true,rate);
+  // again, the way it runs while rendering to a file
+  double tNoOsc=runChip(sys,false,rate);
+
+  double samples=ceil(benchSeconds*rate/BENCH_BUFSIZE)*BENCH_BUFSIZE;
+  beginResult();
+  printf("{\"system\": %s, \"id\": %d, \"setting\": %s, \"value\": %d, \"nsPerSample\": %.3f, \"realtime\": %.3f, \"noOscNsPerSample\": %.3f, \"noOscSpeedup\": %.3f}",
+    jsonString(def->name).c_str(),
+    (int)DivEngine::systemToFileFur(sys),
+    (key==NULL)?"null":jsonString(key).c_str(),
+    value,
+    t*1000000000.0/samples,
+    (samples/rate)/t,
+    tNoOsc*1000000000.0/samples,
+    t/tNoOsc
+  );
+  fflush(stdout);
+}
+
+static void benchChips() {
+  for (int i=1; i<DIV_MAX_CHIP_DEFS; i++) {
+    DivSystem sys=(DivSystem)i;
+    const DivSysDef* def=e.getSystemDef(sys);
+    if (def==NULL) continue;
+    if (def->isCompound) continue;
+    if (!benchFilter.empty() && strstr(def->name,benchFilter.c_str())==NULL) continue;
+    logI("%s...",def->name);
+
+    bool hasSettings=false;
+    for (const BenchSetting* s=benchSettings; s->key!=NULL; s++) {
+      bool applies=false;
+      for (int j=0; s->systems[j]!=DIV_SYSTEM_NULL; j++) {
+        if (s->systems[j]==sys) {
+          applies=true;
+          break;
+        }
+      }
+      if (!applies) continue;
+      hasSettings=true;
+
+      String key=s->key;
+      int prevValue=e.getConfInt(key,0);
+      int prevBaseValue=0;
+      if (s->baseKey!=NULL) {
+        prevBaseValue=e.getConfInt(s->baseKey,0);
+        e.setConf(s->baseKey,s->baseValue);
+      }
+      for (int j=0; j<s->count; j++) {
+        e.setConf(key,j);
+        benchChip(sys,s->key,j);
+      }
+      e.setConf(key,prevValue);
+      if (s->baseKey!=NULL) {
+        e.setConf(s->baseKey,prevBaseValue);
+      }
+    }
+
+    if (!hasSettings) {
+      benchChip(sys,NULL,0);
+    }
+  }
+}
+
+// copy the rendered data of every sample
+static void snapshotSamples(std::vector<std::vector<unsigned char>>& out) {
+  out.clear();
+  for (DivSample* i: e.song.sample) {
+    for (int j=0; j<DIV_SAMPLE_DEPTH_MAX; j++) {
+      unsigned int len=0;
+      unsigned char* buf=(unsigned char*)i->getBuf((DivSampleDepth)j,&len);
+      out.push_back(std::vector<unsigned char>(buf,buf+len));
+    }
+  }
+}
+
+static double benchRenderSamples(bool clearCache, bool invalidate) {
+  double ret=-1;
+  for (int i=0; i<benchIterations; i++) {
+    if (clearCache) e.clearSampleCache();
+    if (invalidate) {
+      for (DivSample* j: e.song.sample) {
+        j->renderHash=0;
+      }
+    }
+    benchClock::time_point start=benchClock::now();
+    e.renderSamplesP();
+    double t=elapsed(start);
+    if (ret<0 || t<ret) ret=t;
+  }
+  return ret;
+}
+
+static bool loadSong(unsigned char* data, size_t len, const char* path) {
+  unsigned char* file=new unsigned char[len];
+  memcpy(file,data,len);
+  return e.load(file,len,path);
+}
+
+static double benchExport(SafeWriter* (*func)(), bool& success) {
+  double best=-1;
+  success=true;
+  for (int i=0; i<benchIterations; i++) {
+    benchClock::time_point start=benchClock::now();
+    SafeWriter* w=func();
+    double t=elapsed(start);
+    if (w==NULL) {
+      success=false;
+      return 0;
+    }
+    w->finish();
+    delete w;
+    if (best<0 || t<best) best=t;
+  }
+  return best;
+}
+
+static SafeWriter* exportVGM() {
+  return e.saveVGM();
+}
+
+static SafeWriter* exportZSM() {
+  return e.saveZSM();
+}
+
+static SafeWriter* exportCommand() {
+  return e.saveCommand();
+}
+
+static SafeWriter* exportFur() {
+  return e.saveFur(true);
+}
+
+static void benchSong(const char* path) {
+  logI("%s...",path);
+  FILE* f=fopen(path,"rb");
+  if (f==NULL) {
+    logE("could not open %s!",path);
+    return;
+  }
+  fseek(f,0,SEEK_END);
+  size_t len=ftell(f);
+  fseek(f,0,SEEK_SET);
+  unsigned char* data=new unsigned char[len];
+  if (fread(data,1,len,f)!=len) {
+    logE("could not read %s!",path);
+    fclose(f);
+    delete[] data;
+    return;
+  }
+  fclose(f);
+
+  // load
+  double loadTime=-1;
+  for (int i=0; i<benchIterations; i++) {
+    benchClock::time_point start=benchClock::now();
+    bool ok=loadSong(data,len,path);
+    double t=elapsed(start);
+    if (!ok) {
+      logE("could not load %s! (%s)",path,e.getLastError());
+      delete[] data;
+      return;
+    }
+    if (loadTime<0 || t<loadTime) loadTime=t;
+  }
+  delete[] data;
+  double rate=e.getAudioDescGot().rate;
+
+  // playback (one loop)
+  float bufL[BENCH_BUFSIZE];
+  float bufR[BENCH_BUFSIZE];
+  float* outBuf[2]={bufL,bufR};
+  e.setOrder(0);
+  e.play();
+  e.setLoops(1);
+  benchClock::time_point start=benchClock::now();
+  while (e.isPlaying()) {
+    e.nextBuf(NULL,outBuf,0,2,BENCH_BUFSIZE);
+  }
+  double renderTime=elapsed(start);
+  double songLen=(double)e.getTotalSeconds()+(double)e.getTotalTicks()/1000000.0;
+  double renderSamples=songLen*rate;
+
+  // sample rendering
+  size_t sampleFrames=0;
+  for (DivSample* i: e.song.sample) {
+    sampleFrames+=i->samples;
+  }
+  unsigned int formatMask=e.getSampleFormatMask();
+  std::vector<std::vector<unsigned char>> serialData, checkData;
+  for (DivSample* i: e.song.sample) {
+    i->render(formatMask);
+  }
+  snapshotSamples(serialData);
+
+  double sampleTime=benchRenderSamples(true,true);
+  snapshotSamples(checkData);
+  bool sampleMatch=(checkData==serialData);
+  double sampleCachedTime=benchRenderSamples(false,true);
+  snapshotSamples(checkData);
+  if (checkData!=serialData) sampleMatch=false;
+  double sampleUnchangedTime=benchRenderSamples(false,false);
+  if (!sampleMatch) {
+    logE("%s: rendered sample data doesn't match!",path);
+    sampleMismatch=true;
+  }
+
+  bool saveOK, vgmOK, zsmOK, cmdOK;
+  double saveTime=benchExport(exportFur,saveOK);
+  double vgmTime=benchExport(exportVGM,vgmOK);
+  double zsmTime=benchExport(exportZSM,zsmOK);
+  double cmdTime=benchExport(exportCommand,cmdOK);
+
+  beginResult();
+  printf("{\"song\": %s, \"length\": %.3f, ",jsonString(path).c_str(),songLen);
+  printf("\"render\": {\"nsPerSample\": %.3f, \"realtime\": %.3f}, ",(renderSamples>0)?(renderTime*1000000000.0/renderSamples):0.0,(renderTime>0)?(songLen/renderTime):0.0);
+  printf("\"samples\": {\"count\": %d, \"frames\": %llu, \"ms\": %.3f, \"nsPerSample\": %.3f, \"cachedMs\": %.3f, \"unchangedMs\": %.3f, \"match\": %s}, ",(int)e.song.sample.size(),(unsigned long long)sampleFrames,sampleTime*1000.0,(sampleFrames>0)?(sampleTime*1000000000.0/sampleFrames):0.0,sampleCachedTime*1000.0,sampleUnchangedTime*1000.0,sampleMatch?"true":"false");
+  printf("\"load\": {\"ms\": %.3f}, ",loadTime*1000.0);
+  printf("\"save\": {\"ms\": %.3f}",saveOK?(saveTime*1000.0):-1.0);
+
+  const char* exportNames[3]={"vgm","zsm","cmdStream"};
+  bool exportOK[3]={vgmOK,zsmOK,cmdOK};
+  double exportTime[3]={vgmTime,zsmTime,cmdTime};
+  for (int i=0; i<3; i++) {
+    if (exportOK[i]) {
+      printf(", \"%s\": {\"ms\": %.3f, \"realtime\": %.3f}",exportNames[i],exportTime[i]*1000.0,(exportTime[i]>0)?(songLen/exportTime[i]):0.0);
+    } else {
+      printf(", \"%s\": null",exportNames[i]);
+    }
+  }
+  printf("}");
+  fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  std::vector<const char*> songs;
+
+  initLog(stderr);
+  logLevel=LOGLEVEL_WARN;
+
+  for (int i=1; i<argc; i++) {
+    if (strcmp(argv[i],"-seconds")==0 && (i+1)<argc) {
+      benchSeconds=atof(argv[++i]);
+      if (benchSeconds<0.01f) benchSeconds=0.01f;
+    } else if (strcmp(argv[i],"-iterations")==0 && (i+1)<argc) {
+      benchIterations=atoi(argv[++i]);
+      if (benchIterations<1) benchIterations=1;
+    } else if (strcmp(argv[i],"-filter")==0 && (i+1)<argc) {
+      benchFilter=argv[++i];
+    } else if (strcmp(argv[i],"-nochips")==0) {
+      benchChipsEnabled=false;
+    } else if (argv[i][0]=='-') {
+      fprintf(stderr,"usage: %s [-seconds <n>] [-iterations <n>] [-filter <text>] [-nochips] [songs...]\n",argv[0]);
+      return 1;
+    } else {
+      songs.push_back(argv[i]);
+    }
+  }
+
+  e.setAudio(DIV_AUDIO_DUMMY);
+  e.preInit();
+  if (!e.init()) {
+    logE("could not initialize engine!");
+    finishLogFile();
+    return 1;
+  }
+
+  printf("{\n  \"version\": %s,\n  \"rate\": %d,\n",jsonString(DIV_VERSION).c_str(),(int)e.getAudioDescGot().rate);
+
+  printf("  \"blip\": [\n");
+  firstResult=true;
+  benchBlip();
+  printf("\n  ],\n");
+
+  printf("  \"chips\": [\n");
+  firstResult=true;
+  if (benchChipsEnabled) benchChips();
+  printf("\n  ],\n");
+
+  printf("  \"songs\": [\n");
+  firstResult=true;
+  for (const char* i: songs) {
+    benchSong(i);
+  }
+  printf("\n  ]\n}\n");
+
+  e.quit(false);
+  finishLogFile();
+  return (blipMismatch || sampleMismatch)?1:0;
+}
@@ -23,7 +23,12 @@ fi
 echo "furnace test suite begin..."
 echo "--- STEP 1: render test files"
 mkdir -p "test/result/$testDir" || exit 1
-ls "test/songs/" | parallel --verbose -j8 ./build/furnace -output "test/result/$testDir/{0}.wav" "test/songs/{0}"
+manifest=$(mktemp) || exit 1
+ls "test/songs/" | while read -r i; do
+  printf '%s\t%s\n' "test/songs/$i" "test/result/$testDir/$i.wav"
+done > "$manifest"
+./build/furnace -batch "$manifest" -batchjobs 8
+rm "$manifest"
 echo "--- STEP 2: calculate deltas"
 if [ -z $lastTest ]; then
   echo "skipping since this apparently is your first run."
@@ -0,0 +1,146 @@
+/**
+ * Furnace Tracker - multi-system chiptune tracker
+ * Copyright (C) 2021-2024 tildearrow and contributors
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// microbenchmark for DivWorkPool and DivLockFreeWorkPool.
+// measures the cost of a fork/join cycle like the one in DivEngine::nextBuf:
+// - dispatch: time between calling wait() and the last task starting
+// - join: time between the last task finishing and wait() returning
+// - total: time of a whole push()/wait() cycle
+// usage: furnace-bench-workpool [iterations] [work]
+// (work is a number of busy loop iterations per task, to simulate a chip)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "../src/engine/workPool.h"
+#include "../src/ta-log.h"
+#include "../src/ta-utils.h"
+
+typedef std::chrono::steady_clock benchClock;
+
+struct BenchTask {
+  benchClock::time_point start, end;
+  unsigned int work;
+  volatile unsigned int sink;
+};
+
+struct BenchResult {
+  double dispatchAvg, dispatchP99;
+  double joinAvg, joinP99;
+  double totalAvg, totalP99;
+};
+
+static void benchTaskFunc(void* d) {
+  BenchTask* t=(BenchTask*)d;
+  t->start=benchClock::now();
+  unsigned int acc=0;
+  for (unsigned int i=0; i<t->work; i++) {
+    acc=acc*1103515245+12345;
+  }
+  t->sink=acc;
+  t->end=benchClock::now();
+}
+
+static double toMicro(benchClock::duration d) {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()/1000.0;
+}
+
+static void stats(std::vector<double>& v, double& avg, double& p99) {
+  avg=0;
+  for (double i: v) avg+=i;
+  avg/=v.size();
+  std::sort(v.begin(),v.end());
+  p99=v[(v.size()*99)/100];
+}
+
+static BenchResult runBench(DivWorkPool* pool, int tasks, int iterations, unsigned int work) {
+  std::vector<BenchTask> t(tasks);
+  std::vector<double> dispatch, join, total;
+  BenchResult ret;
+  dispatch.reserve(iterations);
+  join.reserve(iterations);
+  total.reserve(iterations);
+
+  for (BenchTask& i: t) {
+    i.work=work;
+  }
+
+  for (int i=0; i<iterations+16; i++) {
+    benchClock::time_point cycleBegin=benchClock::now();
+    for (int j=0; j<tasks; j++) {
+      pool->push(benchTaskFunc,&t[j]);
+    }
+    benchClock::time_point waitBegin=benchClock::now();
+    pool->wait();
+    benchClock::time_point cycleEnd=benchClock::now();
+
+    // warm-up
+    if (i<16) continue;
+
+    benchClock::time_point lastStart=t[0].start;
+    benchClock::time_point lastEnd=t[0].end;
+    for (int j=1; j<tasks; j++) {
+      if (t[j].start>lastStart) lastStart=t[j].start;
+      if (t[j].end>lastEnd) lastEnd=t[j].end;
+    }
+    dispatch.push_back(MAX(0.0,toMicro(lastStart-waitBegin)));
+    join.push_back(MAX(0.0,toMicro(cycleEnd-lastEnd)));
+    total.push_back(toMicro(cycleEnd-cycleBegin));
+  }
+
+  stats(dispatch,ret.dispatchAvg,ret.dispatchP99);
+  stats(join,ret.joinAvg,ret.joinP99);
+  stats(total,ret.totalAvg,ret.totalP99);
+  return ret;
+}
+
+int main(int argc, char** argv) {
+  int iterations=10000;
+  unsigned int work=0;
+  const int taskCounts[]={2,4,8,16};
+  const int threadCounts[]={2,4,8};
+
+  initLog(stderr);
+  logLevel=LOGLEVEL_ERROR;
+
+  if (argc>1) iterations=MAX(1,atoi(argv[1]));
+  if (argc>2) work=MAX(0,atoi(argv[2]));
+
+  printf("%d iterations, %u work per task. times in microseconds (average/99th percentile).\n\n",iterations,work);
+  printf("%-10s %7s %5s %21s %21s %21s\n","pool","threads","tasks","dispatch","join","total");
+
+  for (int threads: threadCounts) {
+    for (int tasks: taskCounts) {
+      for (int type=0; type<2; type++) {
+        DivWorkPool* pool;
+        if (type) {
+          pool=new DivLockFreeWorkPool(threads);
+        } else {
+          pool=new DivWorkPool(threads);
+        }
+        BenchResult r=runBench(pool,tasks,iterations,work);
+        delete pool;
+        printf("%-10s %7d %5d %10.2f/%10.2f %10.2f/%10.2f %10.2f/%10.2f\n",type?"lock-free":"standard",threads,tasks,r.dispatchAvg,r.dispatchP99,r.joinAvg,r.joinP99,r.totalAvg,r.totalP99);
+      }
+    }
+  }
+  return 0;
+}